@@ -7,11 +7,17 @@
 
 #include "libopenrazer/capability.h"
 #include "libopenrazer/dbusexception.h"
+#include "libopenrazer/deadline.h"
 #include "libopenrazer/device.h"
+#include "libopenrazer/devicecatalog.h"
 #include "libopenrazer/led.h"
 #include "libopenrazer/manager.h"
 #include "libopenrazer/misc.h"
 #include "libopenrazer/openrazer.h"
+#include "libopenrazer/powermonitor.h"
+#include "libopenrazer/result.h"
+#include "libopenrazer/scene.h"
+#include "libopenrazer/watcher.h"
 
 #include <QTranslator>
 #include <QtGlobal>
@@ -22,6 +28,9 @@
  * \namespace libopenrazer
  *
  * \brief C++/Qt bindings for the OpenRazer D-Bus interface.
+ *
+ * Warnings are logged through the \c libopenrazer.manager, \c libopenrazer.device, \c libopenrazer.led and \c libopenrazer.transport logging categories and can be filtered with QLoggingCategory::setFilterRules() or \c QT_LOGGING_RULES.
+ * Repeats of the same error from the same place are collapsed into a single "suppressed N identical errors" line.
  */
 namespace libopenrazer {
 
@@ -44,6 +44,39 @@ private:
     QString m_message;
 };
 
+/*!
+ * \brief Exception thrown when the daemon is known to be unavailable
+ *
+ * After the daemon has disappeared from the bus or stopped answering calls, libopenrazer fails further calls immediately with this exception instead of waiting for the D-Bus timeout.
+ * Calls are sent again automatically once the daemon is back.
+ */
+class ServiceUnavailableException : public DBusException
+{
+public:
+    /// @cond
+    using DBusException::DBusException;
+
+    void raise() const override;
+    ServiceUnavailableException *clone() const override;
+    /// @endcond
+};
+
+/*!
+ * \brief Exception thrown when a call didn't finish in time
+ *
+ * This is thrown when the daemon didn't answer within the timeout (see Manager::setDefaultTimeout()) or when the active Deadline expired before or during the call.
+ */
+class TimeoutException : public DBusException
+{
+public:
+    /// @cond
+    using DBusException::DBusException;
+
+    void raise() const override;
+    TimeoutException *clone() const override;
+    /// @endcond
+};
+
 }
 
 #endif // DBUSEXCEPTION_H
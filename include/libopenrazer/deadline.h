@@ -0,0 +1,59 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+#include <QDeadlineTimer>
+
+namespace libopenrazer {
+
+/*!
+ * \brief Limits how long the libopenrazer calls in a scope may take
+ *
+ * While a Deadline object exists, every D-Bus call libopenrazer makes from the same thread waits at most until the deadline, even if the default timeout (see Manager::setDefaultTimeout()) is longer.
+ * This also covers calls that consist of several D-Bus calls, e.g. constructing a Device, so they share a single budget.
+ * Calls that don't finish in time, or are started after the deadline has passed, throw a TimeoutException.
+ *
+ * Deadlines can be nested, an inner deadline can only shorten the time that's available.
+ *
+ * \code
+ * libopenrazer::Deadline deadline(100);
+ * for (libopenrazer::Led *led : device->getLeds())
+ *     led->setStatic({ 255, 0, 0 });
+ * \endcode
+ */
+class Deadline
+{
+public:
+    /*!
+     * Starts a deadline that expires in \a msecs milliseconds.
+     */
+    explicit Deadline(int msecs);
+
+    /*!
+     * Starts a deadline that expires together with \a timer.
+     *
+     * Can be used to carry the current() deadline over to another thread.
+     */
+    explicit Deadline(QDeadlineTimer timer);
+
+    ~Deadline();
+
+    Deadline(const Deadline &) = delete;
+    Deadline &operator=(const Deadline &) = delete;
+
+    /*!
+     * Returns the deadline that is active in the calling thread, or a timer that never expires if there is none.
+     */
+    static QDeadlineTimer current();
+
+private:
+    QDeadlineTimer m_timer;
+    Deadline *m_outer;
+};
+
+}
+
+#endif // DEADLINE_H
@@ -6,35 +6,114 @@
 #define DEVICE_H
 
 #include "libopenrazer/openrazer.h"
+#include "libopenrazer/result.h"
 
 #include <QDBusInterface>
+#include <QFlags>
 #include <QObject>
 
 namespace libopenrazer {
 
+struct DBusCommand;
 class Led;
+class WriteCache;
+
+/*!
+ * Optional features of a Device.
+ *
+ * \sa Device::features()
+ */
+enum class Feature {
+    KeyboardLayout = 0x0001,
+    DPI = 0x0002,
+    RestrictedDPI = 0x0004,
+    DPIStages = 0x0008,
+    PollRate = 0x0010,
+    CustomFrame = 0x0020,
+    Battery = 0x0040,
+    LowBatteryThreshold = 0x0080,
+    IdleTime = 0x0100,
+};
+Q_DECLARE_FLAGS(Features, Feature)
 
 /*!
  * \brief Abstraction for accessing Device objects via D-Bus.
+ *
+ * Methods that talk to the daemon throw a DBusException on errors. Each of them has a \c try variant (e.g. \c tryGetSerial() for \c getSerial()) which returns a Result instead, without throwing or logging anything. Prefer those in code that runs often and has to cope with failing calls, e.g. while a device gets unplugged.
  */
 class Device : public QObject
 {
     Q_OBJECT
 public:
+    /// @cond
+    ~Device() override;
+    /// @endcond
+
     /*!
      * Returns the DBus object path.
      */
     virtual QDBusObjectPath objectPath() = 0;
 
     /*!
-     * Returns if the device has the specified \a featureStr
+     * Enables or disables the write cache of the device and its Leds, as specified by \a enabled. It is disabled by default.
+     *
+     * With the write cache enabled, the device remembers the value last set successfully for the poll rate, idle time and low battery threshold, and its Leds for the effect and the brightness.
+     * Setting the same value again then returns right away without calling the daemon.
+     *
+     * The cache is cleared when the daemon restarts and, for devices from Manager::getTrackedDevices(), when another device or daemon takes over their object path.
+     * A single value is dropped when a getter returns something different, or when it has been changed with Manager::applyToAll() or a Scene.
+     *
+     * \sa getElidedWrites()
      */
-    virtual bool hasFeature(const QString &featureStr) = 0;
+    void setWriteCacheEnabled(bool enabled);
+
+    /*!
+     * Returns if the write cache is enabled.
+     *
+     * \sa setWriteCacheEnabled()
+     */
+    bool isWriteCacheEnabled() const;
+
+    /*!
+     * Clears the write cache of the device and its Leds, e.g. after the device settings have been changed by something else.
+     */
+    void clearWriteCache();
+
+    /*!
+     * Returns the number of setter calls on the device and its Leds that were skipped by the write cache.
+     *
+     * \sa setWriteCacheEnabled()
+     */
+    quint64 getElidedWrites();
+
+    /*!
+     * Returns the features supported by the device.
+     *
+     * \sa hasFeature()
+     */
+    virtual Features features() = 0;
+
+    /*!
+     * Returns if the device has the specified \a feature
+     */
+    bool hasFeature(Feature feature);
+
+    /*!
+     * Returns if the device has the specified \a featureStr, like `dpi`, `battery` or `custom_frame`.
+     *
+     * \deprecated Use hasFeature(Feature) or features() instead.
+     */
+    bool hasFeature(const QString &featureStr);
 
     /*!
      * Returns the URL of an image that shows this device. Could return an empty string if no image was found.
      */
-    virtual QString getDeviceImageUrl() = 0;
+    virtual QString getDeviceImageUrl();
+
+    /*!
+     * Non-throwing variant of getDeviceImageUrl().
+     */
+    virtual Result<QString> tryGetDeviceImageUrl() = 0;
 
     /*!
      * Returns a list of Leds supported on the device.
@@ -44,67 +123,122 @@ public:
     /*!
      * Returns the device mode of the device, like `0:0` or `3:0` for normal mode and driver mode respetively.
      */
-    virtual QString getDeviceMode() = 0;
+    virtual QString getDeviceMode();
+
+    /*!
+     * Non-throwing variant of getDeviceMode().
+     */
+    virtual Result<QString> tryGetDeviceMode() = 0;
 
     /*!
      * Returns the serial number of the device which can be used to identify the device.
      */
-    virtual QString getSerial() = 0;
+    virtual QString getSerial();
+
+    /*!
+     * Non-throwing variant of getSerial().
+     */
+    virtual Result<QString> tryGetSerial() = 0;
 
     /*!
      * Returns a human readable device name like `Razer DeathAdder Chroma` or `Razer Kraken 7.1`.
      */
-    virtual QString getDeviceName() = 0;
+    virtual QString getDeviceName();
+
+    /*!
+     * Non-throwing variant of getDeviceName().
+     */
+    virtual Result<QString> tryGetDeviceName() = 0;
 
     /*!
      * Returns the type of the device. Could be one of `accessory`, `headset`, `keyboard`, `keypad`, `mouse`, `mousepad` or another type, if added to the daemon.
      */
-    virtual QString getDeviceType() = 0;
+    virtual QString getDeviceType();
+
+    /*!
+     * Non-throwing variant of getDeviceType().
+     */
+    virtual Result<QString> tryGetDeviceType() = 0;
 
     /*!
      * Returns the firmware version of the device (e.g. `v1.0`).
      */
-    virtual QString getFirmwareVersion() = 0;
+    virtual QString getFirmwareVersion();
+
+    /*!
+     * Non-throwing variant of getFirmwareVersion().
+     */
+    virtual Result<QString> tryGetFirmwareVersion() = 0;
 
     /*!
      * Returns the physical layout of the keyboard (e.g. `de_DE`, `en_US`, `en_GB` or `unknown`)
      */
-    virtual QString getKeyboardLayout() = 0;
+    virtual QString getKeyboardLayout();
+
+    /*!
+     * Non-throwing variant of getKeyboardLayout().
+     */
+    virtual Result<QString> tryGetKeyboardLayout() = 0;
 
     /*!
      * Returns the current poll rate, e.g. `125`, `500` or `1000`.
      *
      * \sa setPollRate(), getSupportedPollRates()
      */
-    virtual ushort getPollRate() = 0;
+    virtual ushort getPollRate();
+
+    /*!
+     * Non-throwing variant of getPollRate().
+     */
+    virtual Result<ushort> tryGetPollRate() = 0;
 
     /*!
      * Sets the poll rate of the mouse to the specified \a pollrate, e.g. `125`, `500` or `1000`.
      *
      * \sa getPollRate()
      */
-    virtual void setPollRate(ushort pollrate) = 0;
+    virtual void setPollRate(ushort pollrate);
+
+    /*!
+     * Non-throwing variant of setPollRate().
+     */
+    virtual Result<void> trySetPollRate(ushort pollrate) = 0;
 
     /*!
      * Returns the poll rates that are supported by the device.
      *
      * \sa setPollRate()
      */
-    virtual QVector<ushort> getSupportedPollRates() = 0;
+    virtual QVector<ushort> getSupportedPollRates();
+
+    /*!
+     * Non-throwing variant of getSupportedPollRates().
+     */
+    virtual Result<QVector<ushort>> tryGetSupportedPollRates() = 0;
 
     /*!
      * Sets the DPI of the mouse to the specified \a dpi_x for the x-Axis and \a dpi_y for the y-Axis. Maximum value is what is returned by maxDPI().
      *
      * \sa getDPI(), maxDPI(), getAllowedDPIValues()
      */
-    virtual void setDPI(::openrazer::DPI dpi) = 0;
+    virtual void setDPI(::openrazer::DPI dpi);
+
+    /*!
+     * Non-throwing variant of setDPI().
+     */
+    virtual Result<void> trySetDPI(::openrazer::DPI dpi) = 0;
 
     /*!
      * Returns the DPI of the mouse (e.g. `[800, 800]`).
      *
      * \sa setDPI()
      */
-    virtual ::openrazer::DPI getDPI() = 0;
+    virtual ::openrazer::DPI getDPI();
+
+    /*!
+     * Non-throwing variant of getDPI().
+     */
+    virtual Result<::openrazer::DPI> tryGetDPI() = 0;
 
     /*!
      * Sets the DPI stages of the mouse to the specified \a dpiStages and sets stage nr. \a activeStage active.
@@ -114,7 +248,12 @@ public:
      *
      * \sa getDPIStages(), maxDPI()
      */
-    virtual void setDPIStages(uchar activeStage, QVector<::openrazer::DPI> dpiStages) = 0;
+    virtual void setDPIStages(uchar activeStage, QVector<::openrazer::DPI> dpiStages);
+
+    /*!
+     * Non-throwing variant of setDPIStages().
+     */
+    virtual Result<void> trySetDPIStages(uchar activeStage, QVector<::openrazer::DPI> dpiStages) = 0;
 
     /*!
      * Returns a pair of the active DPI stage and the configured DPI stages of the mouse.
@@ -124,31 +263,56 @@ public:
      *
      * \sa setDPIStages(), maxDPI()
      */
-    virtual QPair<uchar, QVector<::openrazer::DPI>> getDPIStages() = 0;
+    virtual QPair<uchar, QVector<::openrazer::DPI>> getDPIStages();
+
+    /*!
+     * Non-throwing variant of getDPIStages().
+     */
+    virtual Result<QPair<uchar, QVector<::openrazer::DPI>>> tryGetDPIStages() = 0;
 
     /*!
      * Returns the maximum DPI possible for the device.
      *
      * \sa getDPI(), setDPI()
      */
-    virtual ushort maxDPI() = 0;
+    virtual ushort maxDPI();
+
+    /*!
+     * Non-throwing variant of maxDPI().
+     */
+    virtual Result<ushort> tryMaxDPI() = 0;
 
     /*!
      * Some devices only support a small number of DPI values instead of arbitrary values.
      *
      * Returns the allowed values you can pass to setDPI
      */
-    virtual QVector<ushort> getAllowedDPI() = 0;
+    virtual QVector<ushort> getAllowedDPI();
+
+    /*!
+     * Non-throwing variant of getAllowedDPI().
+     */
+    virtual Result<QVector<ushort>> tryGetAllowedDPI() = 0;
 
     /*!
      * Returns the percentage the battery of the device is charged.
      */
-    virtual double getBatteryPercent() = 0;
+    virtual double getBatteryPercent();
+
+    /*!
+     * Non-throwing variant of getBatteryPercent().
+     */
+    virtual Result<double> tryGetBatteryPercent() = 0;
 
     /*!
      * Returns whether the device is currently charging.
      */
-    virtual bool isCharging() = 0;
+    virtual bool isCharging();
+
+    /*!
+     * Non-throwing variant of isCharging().
+     */
+    virtual Result<bool> tryIsCharging() = 0;
 
     /*!
      * Returns the time (in seconds) after which the device will enter sleep mode.
@@ -157,7 +321,12 @@ public:
      *
      * \sa setIdleTime()
      */
-    virtual ushort getIdleTime() = 0;
+    virtual ushort getIdleTime();
+
+    /*!
+     * Non-throwing variant of getIdleTime().
+     */
+    virtual Result<ushort> tryGetIdleTime() = 0;
 
     /*!
      * Sets the time (in seconds) after which the device will enter sleep mode.
@@ -166,28 +335,48 @@ public:
      *
      * \sa getIdleTime()
      */
-    virtual void setIdleTime(ushort idleTime) = 0;
+    virtual void setIdleTime(ushort idleTime);
+
+    /*!
+     * Non-throwing variant of setIdleTime().
+     */
+    virtual Result<void> trySetIdleTime(ushort idleTime) = 0;
 
     /*!
      * Returns the battery percentage before the device will enter low power mode.
      *
      * \sa setLowBatteryThreshold()
      */
-    virtual double getLowBatteryThreshold() = 0;
+    virtual double getLowBatteryThreshold();
+
+    /*!
+     * Non-throwing variant of getLowBatteryThreshold().
+     */
+    virtual Result<double> tryGetLowBatteryThreshold() = 0;
 
     /*!
      * Sets the battery percentage before the device will enter low power mode.
      *
      * \sa getLowBatteryThreshold()
      */
-    virtual void setLowBatteryThreshold(double threshold) = 0;
+    virtual void setLowBatteryThreshold(double threshold);
+
+    /*!
+     * Non-throwing variant of setLowBatteryThreshold().
+     */
+    virtual Result<void> trySetLowBatteryThreshold(double threshold) = 0;
 
     /*!
      * Sets the lighting to custom mode (applies effects set from defineCustomFrame()).
      *
      * \sa defineCustomFrame()
      */
-    virtual void displayCustomFrame() = 0;
+    virtual void displayCustomFrame();
+
+    /*!
+     * Non-throwing variant of displayCustomFrame().
+     */
+    virtual Result<void> tryDisplayCustomFrame() = 0;
 
     /*!
      * Sets the lighting of a key row to the specified \a colorData.
@@ -195,16 +384,53 @@ public:
      * Note, that you have to call displayCustomFrame() after setting otherwise the effect won't be displayed (even if you have already called displayCustomFrame() before).
      * Currently the driver only accepts whole rows that are sent.
      *
+     * If the daemon advertises a peer-to-peer address in the \c PeerAddress property of its manager object, custom frames are sent to the daemon directly instead of through the message bus. Other calls always go through the bus.
+     *
      * \sa displayCustomFrame()
      */
-    virtual void defineCustomFrame(uchar row, uchar startColumn, uchar endColumn, QVector<::openrazer::RGB> colorData) = 0;
+    virtual void defineCustomFrame(uchar row, uchar startColumn, uchar endColumn, QVector<::openrazer::RGB> colorData);
+
+    /*!
+     * Non-throwing variant of defineCustomFrame().
+     */
+    virtual Result<void> tryDefineCustomFrame(uchar row, uchar startColumn, uchar endColumn, QVector<::openrazer::RGB> colorData) = 0;
 
     /*!
      * Returns the dimension of the matrix supported on the device.
      *
      * \sa defineCustomFrame()
      */
-    virtual ::openrazer::MatrixDimensions getMatrixDimensions() = 0;
+    virtual ::openrazer::MatrixDimensions getMatrixDimensions();
+
+    /*!
+     * Non-throwing variant of getMatrixDimensions().
+     */
+    virtual Result<::openrazer::MatrixDimensions> tryGetMatrixDimensions() = 0;
+
+protected:
+    /// @cond
+    // For the backends, nullptr if the write cache has never been enabled
+    WriteCache *writeCache() const { return m_writeCache; }
+    /// @endcond
+
+private:
+    // Prepare the calls of the setters without sending them, for Scene.
+    // The default implementations fail with org.freedesktop.DBus.Error.NotSupported, callers fall
+    // back to the try* methods then.
+    virtual Result<DBusCommand> prepareSetPollRate(ushort pollrate);
+    virtual Result<DBusCommand> prepareSetDPI(::openrazer::DPI dpi);
+    virtual Result<DBusCommand> prepareSetDPIStages(uchar activeStage, QVector<::openrazer::DPI> dpiStages);
+    // Prepare reading the serial, for matching the devices of a Scene
+    virtual Result<DBusCommand> prepareGetSerial();
+    // Prepare the calls of the power getters, for PowerMonitor
+    virtual Result<DBusCommand> prepareGetBatteryPercent();
+    virtual Result<DBusCommand> prepareIsCharging();
+    virtual Result<DBusCommand> prepareGetLowBatteryThreshold();
+
+    WriteCache *m_writeCache = nullptr;
+
+    friend class PowerMonitor;
+    friend class ScenePrivate;
 };
 
 namespace openrazer {
@@ -216,43 +442,56 @@ class LedPrivate;
 class Device : public ::libopenrazer::Device
 {
 public:
-    Device(QDBusObjectPath objectPath);
+    Device(QDBusObjectPath objectPath, int timeout = -1);
+    Device(QDBusObjectPath objectPath, const QDBusConnection &connection, int timeout = -1);
     ~Device() override;
 
     QDBusObjectPath objectPath() override;
-    bool hasFeature(const QString &featureStr) override;
-    QString getDeviceImageUrl() override;
+    Features features() override;
+    Result<QString> tryGetDeviceImageUrl() override;
     QList<::libopenrazer::Led *> getLeds() override;
-    QString getDeviceMode() override;
-    QString getSerial() override;
-    QString getDeviceName() override;
-    QString getDeviceType() override;
-    QString getFirmwareVersion() override;
-    QString getKeyboardLayout() override;
-    ushort getPollRate() override;
-    void setPollRate(ushort pollrate) override;
-    QVector<ushort> getSupportedPollRates() override;
-    void setDPI(::openrazer::DPI dpi) override;
-    ::openrazer::DPI getDPI() override;
-    void setDPIStages(uchar activeStage, QVector<::openrazer::DPI> dpiStages) override;
-    QPair<uchar, QVector<::openrazer::DPI>> getDPIStages() override;
-    ushort maxDPI() override;
-    QVector<ushort> getAllowedDPI() override;
-    double getBatteryPercent() override;
-    bool isCharging() override;
-    ushort getIdleTime() override;
-    void setIdleTime(ushort idleTime) override;
-    double getLowBatteryThreshold() override;
-    void setLowBatteryThreshold(double threshold) override;
-    void displayCustomFrame() override;
-    void defineCustomFrame(uchar row, uchar startColumn, uchar endColumn, QVector<::openrazer::RGB> colorData) override;
-    ::openrazer::MatrixDimensions getMatrixDimensions() override;
+    Result<QString> tryGetDeviceMode() override;
+    Result<QString> tryGetSerial() override;
+    Result<QString> tryGetDeviceName() override;
+    Result<QString> tryGetDeviceType() override;
+    Result<QString> tryGetFirmwareVersion() override;
+    Result<QString> tryGetKeyboardLayout() override;
+    Result<ushort> tryGetPollRate() override;
+    Result<void> trySetPollRate(ushort pollrate) override;
+    Result<QVector<ushort>> tryGetSupportedPollRates() override;
+    Result<void> trySetDPI(::openrazer::DPI dpi) override;
+    Result<::openrazer::DPI> tryGetDPI() override;
+    Result<void> trySetDPIStages(uchar activeStage, QVector<::openrazer::DPI> dpiStages) override;
+    Result<QPair<uchar, QVector<::openrazer::DPI>>> tryGetDPIStages() override;
+    Result<ushort> tryMaxDPI() override;
+    Result<QVector<ushort>> tryGetAllowedDPI() override;
+    Result<double> tryGetBatteryPercent() override;
+    Result<bool> tryIsCharging() override;
+    Result<ushort> tryGetIdleTime() override;
+    Result<void> trySetIdleTime(ushort idleTime) override;
+    Result<double> tryGetLowBatteryThreshold() override;
+    Result<void> trySetLowBatteryThreshold(double threshold) override;
+    Result<void> tryDisplayCustomFrame() override;
+    Result<void> tryDefineCustomFrame(uchar row, uchar startColumn, uchar endColumn, QVector<::openrazer::RGB> colorData) override;
+    Result<::openrazer::MatrixDimensions> tryGetMatrixDimensions() override;
 
 private:
+    Result<DBusCommand> prepareSetPollRate(ushort pollrate) override;
+    Result<DBusCommand> prepareSetDPI(::openrazer::DPI dpi) override;
+    Result<DBusCommand> prepareSetDPIStages(uchar activeStage, QVector<::openrazer::DPI> dpiStages) override;
+    Result<DBusCommand> prepareGetSerial() override;
+    Result<DBusCommand> prepareGetBatteryPercent() override;
+    Result<DBusCommand> prepareIsCharging() override;
+    Result<DBusCommand> prepareGetLowBatteryThreshold() override;
+
+    explicit Device(DevicePrivate *d);
+
     DevicePrivate *d;
 
     friend class Led;
     friend class LedPrivate;
+    friend class Manager;
+    friend class Watcher;
 };
 
 }
@@ -266,37 +505,123 @@ class LedPrivate;
 class Device : public ::libopenrazer::Device
 {
 public:
-    Device(QDBusObjectPath objectPath);
+    Device(QDBusObjectPath objectPath, int timeout = -1);
+    Device(QDBusObjectPath objectPath, const QDBusConnection &connection, int timeout = -1);
+    ~Device() override;
+
+    QDBusObjectPath objectPath() override;
+    Features features() override;
+    Result<QString> tryGetDeviceImageUrl() override;
+    QList<::libopenrazer::Led *> getLeds() override;
+    Result<QString> tryGetDeviceMode() override;
+    Result<QString> tryGetSerial() override;
+    Result<QString> tryGetDeviceName() override;
+    Result<QString> tryGetDeviceType() override;
+    Result<QString> tryGetFirmwareVersion() override;
+    Result<QString> tryGetKeyboardLayout() override;
+    Result<ushort> tryGetPollRate() override;
+    Result<void> trySetPollRate(ushort pollrate) override;
+    Result<QVector<ushort>> tryGetSupportedPollRates() override;
+    Result<void> trySetDPI(::openrazer::DPI dpi) override;
+    Result<::openrazer::DPI> tryGetDPI() override;
+    Result<void> trySetDPIStages(uchar activeStage, QVector<::openrazer::DPI> dpiStages) override;
+    Result<QPair<uchar, QVector<::openrazer::DPI>>> tryGetDPIStages() override;
+    Result<ushort> tryMaxDPI() override;
+    Result<QVector<ushort>> tryGetAllowedDPI() override;
+    Result<double> tryGetBatteryPercent() override;
+    Result<bool> tryIsCharging() override;
+    Result<ushort> tryGetIdleTime() override;
+    Result<void> trySetIdleTime(ushort idleTime) override;
+    Result<double> tryGetLowBatteryThreshold() override;
+    Result<void> trySetLowBatteryThreshold(double threshold) override;
+    Result<void> tryDisplayCustomFrame() override;
+    Result<void> tryDefineCustomFrame(uchar row, uchar startColumn, uchar endColumn, QVector<::openrazer::RGB> colorData) override;
+    Result<::openrazer::MatrixDimensions> tryGetMatrixDimensions() override;
+
+private:
+    Result<DBusCommand> prepareSetPollRate(ushort pollrate) override;
+    Result<DBusCommand> prepareSetDPI(::openrazer::DPI dpi) override;
+    Result<DBusCommand> prepareSetDPIStages(uchar activeStage, QVector<::openrazer::DPI> dpiStages) override;
+    Result<DBusCommand> prepareGetSerial() override;
+    Result<DBusCommand> prepareGetBatteryPercent() override;
+    Result<DBusCommand> prepareIsCharging() override;
+    Result<DBusCommand> prepareGetLowBatteryThreshold() override;
+
+    DevicePrivate *d;
+
+    friend class Led;
+    friend class LedPrivate;
+};
+
+}
+
+#ifdef Q_OS_LINUX
+namespace sysfs {
+
+class DevicePrivate;
+class Led;
+class LedPrivate;
+
+/*!
+ * \brief Device that talks to the OpenRazer kernel driver through its sysfs attributes, without the daemon.
+ *
+ * Linux only. Every call reads or writes an attribute file of the driver, e.g. \c poll_rate or \c matrix_effect_static, so no D-Bus call and no daemon are involved.
+ * The attribute files are opened on first use and kept open. The rows given to defineCustomFrame() are collected and written with a single write by displayCustomFrame().
+ *
+ * The driver doesn't report everything the daemon does: the current effect of a Led is only known after it has been set through the Led, and the matrix dimensions, the maximum DPI and the keyboard layout aren't available.
+ * The write cache has no effect, and Manager::applyToAll(), Scene and PowerMonitor don't handle these devices as they only batch D-Bus calls.
+ *
+ * The attribute files are usually only writable by root and the \c plugdev group.
+ */
+class Device : public ::libopenrazer::Device
+{
+public:
+    /*!
+     * Opens the device in the sysfs directory \a path, e.g. \c /sys/bus/hid/drivers/razerkbd/0003:1532:0203.0001.
+     */
+    explicit Device(const QString &path);
     ~Device() override;
 
+    /*!
+     * Returns the devices bound to the OpenRazer kernel drivers in \a root, the directory containing the HID drivers. The caller owns the returned devices.
+     *
+     * Pointing \a root to a fake tree, e.g. in a temporary directory, allows using the backend without hardware.
+     */
+    static QList<Device *> openAll(const QString &root = QStringLiteral("/sys/bus/hid/drivers"));
+
+    /*!
+     * Returns the sysfs directory of the device.
+     */
+    QString path() const;
+
     QDBusObjectPath objectPath() override;
-    bool hasFeature(const QString &featureStr) override;
-    QString getDeviceImageUrl() override;
+    Features features() override;
+    Result<QString> tryGetDeviceImageUrl() override;
     QList<::libopenrazer::Led *> getLeds() override;
-    QString getDeviceMode() override;
-    QString getSerial() override;
-    QString getDeviceName() override;
-    QString getDeviceType() override;
-    QString getFirmwareVersion() override;
-    QString getKeyboardLayout() override;
-    ushort getPollRate() override;
-    void setPollRate(ushort pollrate) override;
-    QVector<ushort> getSupportedPollRates() override;
-    void setDPI(::openrazer::DPI dpi) override;
-    ::openrazer::DPI getDPI() override;
-    void setDPIStages(uchar activeStage, QVector<::openrazer::DPI> dpiStages) override;
-    QPair<uchar, QVector<::openrazer::DPI>> getDPIStages() override;
-    ushort maxDPI() override;
-    QVector<ushort> getAllowedDPI() override;
-    double getBatteryPercent() override;
-    bool isCharging() override;
-    ushort getIdleTime() override;
-    void setIdleTime(ushort idleTime) override;
-    double getLowBatteryThreshold() override;
-    void setLowBatteryThreshold(double threshold) override;
-    void displayCustomFrame() override;
-    void defineCustomFrame(uchar row, uchar startColumn, uchar endColumn, QVector<::openrazer::RGB> colorData) override;
-    ::openrazer::MatrixDimensions getMatrixDimensions() override;
+    Result<QString> tryGetDeviceMode() override;
+    Result<QString> tryGetSerial() override;
+    Result<QString> tryGetDeviceName() override;
+    Result<QString> tryGetDeviceType() override;
+    Result<QString> tryGetFirmwareVersion() override;
+    Result<QString> tryGetKeyboardLayout() override;
+    Result<ushort> tryGetPollRate() override;
+    Result<void> trySetPollRate(ushort pollrate) override;
+    Result<QVector<ushort>> tryGetSupportedPollRates() override;
+    Result<void> trySetDPI(::openrazer::DPI dpi) override;
+    Result<::openrazer::DPI> tryGetDPI() override;
+    Result<void> trySetDPIStages(uchar activeStage, QVector<::openrazer::DPI> dpiStages) override;
+    Result<QPair<uchar, QVector<::openrazer::DPI>>> tryGetDPIStages() override;
+    Result<ushort> tryMaxDPI() override;
+    Result<QVector<ushort>> tryGetAllowedDPI() override;
+    Result<double> tryGetBatteryPercent() override;
+    Result<bool> tryIsCharging() override;
+    Result<ushort> tryGetIdleTime() override;
+    Result<void> trySetIdleTime(ushort idleTime) override;
+    Result<double> tryGetLowBatteryThreshold() override;
+    Result<void> trySetLowBatteryThreshold(double threshold) override;
+    Result<void> tryDisplayCustomFrame() override;
+    Result<void> tryDefineCustomFrame(uchar row, uchar startColumn, uchar endColumn, QVector<::openrazer::RGB> colorData) override;
+    Result<::openrazer::MatrixDimensions> tryGetMatrixDimensions() override;
 
 private:
     DevicePrivate *d;
@@ -306,7 +631,10 @@ private:
 };
 
 }
+#endif
 
 }
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(libopenrazer::Features)
+
 #endif // DEVICE_H
@@ -0,0 +1,107 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DEVICECATALOG_H
+#define DEVICECATALOG_H
+
+#include <QHash>
+#include <QString>
+#include <QVariantHash>
+#include <QVector>
+
+namespace libopenrazer {
+
+/*!
+ * A device model supported by the daemon, see DeviceCatalog.
+ */
+struct SupportedDevice {
+    QString name;
+    ushort vid = 0;
+    ushort pid = 0;
+};
+
+/*!
+ * \brief The device models supported by a daemon, indexed by VID/PID and by name.
+ *
+ * Returned by Manager::getDeviceCatalog(). Lookups with find() take constant time.
+ *
+ * \code
+ * libopenrazer::DeviceCatalog catalog = manager->getDeviceCatalog();
+ * if (const libopenrazer::SupportedDevice *device = catalog.find(0x1532, 0x0084))
+ *     qDebug() << device->name;
+ * \endcode
+ */
+class DeviceCatalog
+{
+public:
+    /*!
+     * Creates an empty catalog for the daemon with the given \a daemonVersion.
+     */
+    explicit DeviceCatalog(const QString &daemonVersion = QString());
+
+    /*!
+     * Returns the version of the daemon the catalog belongs to.
+     */
+    QString daemonVersion() const;
+
+    /*!
+     * Adds the device model \a name with the given \a vid and \a pid. An existing model with the same name is replaced.
+     */
+    void insert(const QString &name, ushort vid, ushort pid);
+
+    /*!
+     * Returns all device models in the order they were added.
+     */
+    const QVector<SupportedDevice> &devices() const;
+
+    /*!
+     * Returns the number of device models.
+     */
+    int size() const;
+
+    /*!
+     * Returns if the catalog contains no device models.
+     */
+    bool isEmpty() const;
+
+    /*!
+     * Returns the device model with the given \a vid and \a pid, or \c nullptr if it isn't supported.
+     *
+     * If more than one model has the same VID/PID, the first one added is returned. The pointer stays valid until the catalog is changed or destroyed.
+     */
+    const SupportedDevice *find(ushort vid, ushort pid) const;
+
+    /*!
+     * Returns the device model with the given \a name, or \c nullptr if it isn't supported.
+     */
+    const SupportedDevice *find(const QString &name) const;
+
+    /*!
+     * Returns the catalog in the format of Manager::getSupportedDevices().
+     */
+    QVariantHash toVariantHash() const;
+
+    /*!
+     * Writes the catalog into \a fileName in a compact binary format. Returns if it was successful.
+     */
+    bool save(const QString &fileName) const;
+
+    /*!
+     * Replaces the catalog with the one in \a fileName, see save(). Returns if it was successful, the catalog is unchanged otherwise.
+     */
+    bool load(const QString &fileName);
+
+private:
+    static quint32 idKey(ushort vid, ushort pid) { return quint32(vid) << 16 | pid; }
+
+    QString m_daemonVersion;
+    QVector<SupportedDevice> m_devices;
+    // Indices into m_devices
+    QHash<quint32, int> m_byId;
+    QHash<QString, int> m_byName;
+};
+
+}
+
+#endif // DEVICECATALOG_H
@@ -6,18 +6,61 @@
 #define LED_H
 
 #include "libopenrazer/openrazer.h"
+#include "libopenrazer/result.h"
 
 #include <QDBusInterface>
 
 namespace libopenrazer {
 
+struct DBusCommand;
+class WriteCache;
+
+/*!
+ * Arguments of an effect, see Manager::applyToAll().
+ *
+ * Only the members the effect takes are used, e.g. \c color and \c color2 for ::openrazer::Effect::BreathingDual.
+ */
+struct EffectParams {
+    ::openrazer::RGB color = { 0, 0, 0 };
+    ::openrazer::RGB color2 = { 0, 0, 0 };
+    ::openrazer::WaveDirection waveDirection = ::openrazer::WaveDirection::LEFT_TO_RIGHT;
+    ::openrazer::WheelDirection wheelDirection = ::openrazer::WheelDirection::CLOCKWISE;
+    ::openrazer::ReactiveSpeed reactiveSpeed = ::openrazer::ReactiveSpeed::_500MS;
+};
+
 /*!
  * \brief Abstraction for accessing Led objects via D-Bus.
+ *
+ * Like for Device, every method that talks to the daemon has a \c try variant returning a Result, e.g. trySetStatic() for setStatic(). These are meant for frame loops and similar hot paths.
  */
 class Led : public QObject
 {
     Q_OBJECT
 public:
+    /// @cond
+    ~Led() override;
+    /// @endcond
+
+    /*!
+     * Enables or disables the write cache of the Led, as specified by \a enabled. See Device::setWriteCacheEnabled().
+     */
+    void setWriteCacheEnabled(bool enabled);
+
+    /*!
+     * Returns if the write cache is enabled.
+     */
+    bool isWriteCacheEnabled() const;
+
+    /*!
+     * Clears the write cache of the Led.
+     */
+    void clearWriteCache();
+
+    /*!
+     * Returns the number of setter calls that were skipped by the write cache.
+     */
+    quint64 getElidedWrites() const;
+
     /*!
      * Returns the D-Bus object path of the Led
      */
@@ -36,102 +79,219 @@ public:
     /*!
      * Returns the currently active effect
      */
-    virtual ::openrazer::Effect getCurrentEffect() = 0;
+    virtual ::openrazer::Effect getCurrentEffect();
+
+    /*!
+     * Non-throwing variant of getCurrentEffect().
+     */
+    virtual Result<::openrazer::Effect> tryGetCurrentEffect() = 0;
 
     /*!
      * Returns the currently active colors (the list will have at least 3 elements)
      */
-    virtual QVector<::openrazer::RGB> getCurrentColors() = 0;
+    virtual QVector<::openrazer::RGB> getCurrentColors();
+
+    /*!
+     * Non-throwing variant of getCurrentColors().
+     */
+    virtual Result<QVector<::openrazer::RGB>> tryGetCurrentColors() = 0;
 
     /*!
      * Returns the wave direction of this Led
      */
-    virtual ::openrazer::WaveDirection getWaveDirection() = 0;
+    virtual ::openrazer::WaveDirection getWaveDirection();
+
+    /*!
+     * Non-throwing variant of getWaveDirection().
+     */
+    virtual Result<::openrazer::WaveDirection> tryGetWaveDirection() = 0;
 
     /*!
      * Returns the Led ID of this Led
      */
-    virtual ::openrazer::LedId getLedId() = 0;
+    virtual ::openrazer::LedId getLedId();
+
+    /*!
+     * Non-throwing variant of getLedId().
+     */
+    virtual Result<::openrazer::LedId> tryGetLedId() = 0;
 
     /*!
      * Sets the LED to none / off.
      */
-    virtual void setOff() = 0;
+    virtual void setOff();
+
+    /*!
+     * Non-throwing variant of setOff().
+     */
+    virtual Result<void> trySetOff() = 0;
 
     /*!
      * Sets the LED to on.
      */
-    virtual void setOn() = 0;
+    virtual void setOn();
+
+    /*!
+     * Non-throwing variant of setOn().
+     */
+    virtual Result<void> trySetOn() = 0;
 
     /*!
      * Sets the lighting to static lighting in the specified \a color.
      */
-    virtual void setStatic(::openrazer::RGB color) = 0;
+    virtual void setStatic(::openrazer::RGB color);
+
+    /*!
+     * Non-throwing variant of setStatic().
+     */
+    virtual Result<void> trySetStatic(::openrazer::RGB color) = 0;
 
     /*!
      * Sets the lighting to the single breath effect with the specified \a color.
      */
-    virtual void setBreathing(::openrazer::RGB color) = 0;
+    virtual void setBreathing(::openrazer::RGB color);
+
+    /*!
+     * Non-throwing variant of setBreathing().
+     */
+    virtual Result<void> trySetBreathing(::openrazer::RGB color) = 0;
 
     /*!
      * Sets the lighting to the dual breath effect with the specified \a color and \a color2.
      */
-    virtual void setBreathingDual(::openrazer::RGB color, ::openrazer::RGB color2) = 0;
+    virtual void setBreathingDual(::openrazer::RGB color, ::openrazer::RGB color2);
+
+    /*!
+     * Non-throwing variant of setBreathingDual().
+     */
+    virtual Result<void> trySetBreathingDual(::openrazer::RGB color, ::openrazer::RGB color2) = 0;
 
     /*!
      * Sets the lighting to the random breath effect.
      */
-    virtual void setBreathingRandom() = 0;
+    virtual void setBreathingRandom();
+
+    /*!
+     * Non-throwing variant of setBreathingRandom().
+     */
+    virtual Result<void> trySetBreathingRandom() = 0;
 
     /*!
      * Sets the lighting to the mono-color breath effect.
      */
-    virtual void setBreathingMono() = 0;
+    virtual void setBreathingMono();
+
+    /*!
+     * Non-throwing variant of setBreathingMono().
+     */
+    virtual Result<void> trySetBreathingMono() = 0;
 
     /*!
      * Sets the lighting wheel to the random breath effect.
      */
-    virtual void setBlinking(::openrazer::RGB color) = 0;
+    virtual void setBlinking(::openrazer::RGB color);
+
+    /*!
+     * Non-throwing variant of setBlinking().
+     */
+    virtual Result<void> trySetBlinking(::openrazer::RGB color) = 0;
 
     /*!
      * Sets the lighting to spectrum mode.
      */
-    virtual void setSpectrum() = 0;
+    virtual void setSpectrum();
+
+    /*!
+     * Non-throwing variant of setSpectrum().
+     */
+    virtual Result<void> trySetSpectrum() = 0;
 
     /*!
      * Sets the lighting effect to wave, in the direction \a direction.
      */
-    virtual void setWave(::openrazer::WaveDirection direction) = 0;
+    virtual void setWave(::openrazer::WaveDirection direction);
+
+    /*!
+     * Non-throwing variant of setWave().
+     */
+    virtual Result<void> trySetWave(::openrazer::WaveDirection direction) = 0;
 
     /*!
      * Sets the lighting effect to wheel, in the direction \a direction.
      */
-    virtual void setWheel(::openrazer::WheelDirection direction) = 0;
+    virtual void setWheel(::openrazer::WheelDirection direction);
+
+    /*!
+     * Non-throwing variant of setWheel().
+     */
+    virtual Result<void> trySetWheel(::openrazer::WheelDirection direction) = 0;
 
     /*!
      * Sets the lighting to reactive mode with the specified \a color and \a speed.
      */
-    virtual void setReactive(::openrazer::RGB color, ::openrazer::ReactiveSpeed speed) = 0;
+    virtual void setReactive(::openrazer::RGB color, ::openrazer::ReactiveSpeed speed);
+
+    /*!
+     * Non-throwing variant of setReactive().
+     */
+    virtual Result<void> trySetReactive(::openrazer::RGB color, ::openrazer::ReactiveSpeed speed) = 0;
 
     /*!
      * Sets the lighting effect to ripple with the specified \a color.
      */
-    virtual void setRipple(::openrazer::RGB color) = 0;
+    virtual void setRipple(::openrazer::RGB color);
+
+    /*!
+     * Non-throwing variant of setRipple().
+     */
+    virtual Result<void> trySetRipple(::openrazer::RGB color) = 0;
 
     /*!
      * Sets the lighting effect to ripple with random colors.
      */
-    virtual void setRippleRandom() = 0;
+    virtual void setRippleRandom();
+
+    /*!
+     * Non-throwing variant of setRippleRandom().
+     */
+    virtual Result<void> trySetRippleRandom() = 0;
 
     /*!
      * Sets the \a brightness (`0` - `255`).
      */
-    virtual void setBrightness(uchar brightness) = 0;
+    virtual void setBrightness(uchar brightness);
+
+    /*!
+     * Non-throwing variant of setBrightness().
+     */
+    virtual Result<void> trySetBrightness(uchar brightness) = 0;
 
     /*!
      * Returns the current brightness (`0` - `255`).
      */
-    virtual uchar getBrightness() = 0;
+    virtual uchar getBrightness();
+
+    /*!
+     * Non-throwing variant of getBrightness().
+     */
+    virtual Result<uchar> tryGetBrightness() = 0;
+
+protected:
+    /// @cond
+    // For the backends, nullptr if the write cache has never been enabled
+    WriteCache *writeCache() const { return m_writeCache; }
+    /// @endcond
+
+private:
+    // Prepare the calls of the setters without sending them, for Manager::applyToAll() and Scene.
+    // The default implementations fail with org.freedesktop.DBus.Error.NotSupported.
+    virtual Result<DBusCommand> prepareEffect(::openrazer::Effect effect, const EffectParams &params);
+    virtual Result<DBusCommand> prepareSetBrightness(uchar brightness);
+
+    WriteCache *m_writeCache = nullptr;
+
+    friend class Manager;
+    friend class ScenePrivate;
 };
 
 namespace openrazer {
@@ -147,29 +307,34 @@ public:
     QDBusObjectPath getObjectPath() override;
     bool hasBrightness() override;
     bool hasFx(::openrazer::Effect fx) override;
-    ::openrazer::Effect getCurrentEffect() override;
-    QVector<::openrazer::RGB> getCurrentColors() override;
-    ::openrazer::WaveDirection getWaveDirection() override;
-    ::openrazer::LedId getLedId() override;
-    void setOff() override;
-    void setOn() override;
-    void setStatic(::openrazer::RGB color) override;
-    void setBreathing(::openrazer::RGB color) override;
-    void setBreathingDual(::openrazer::RGB color, ::openrazer::RGB color2) override;
-    void setBreathingRandom() override;
-    void setBreathingMono() override;
-    void setBlinking(::openrazer::RGB color) override;
-    void setSpectrum() override;
-    void setWave(::openrazer::WaveDirection direction) override;
-    void setWheel(::openrazer::WheelDirection direction) override;
-    void setReactive(::openrazer::RGB color, ::openrazer::ReactiveSpeed speed) override;
-    void setRipple(::openrazer::RGB color) override;
-    void setRippleRandom() override;
-    void setBrightness(uchar brightness) override;
-    uchar getBrightness() override;
+    Result<::openrazer::Effect> tryGetCurrentEffect() override;
+    Result<QVector<::openrazer::RGB>> tryGetCurrentColors() override;
+    Result<::openrazer::WaveDirection> tryGetWaveDirection() override;
+    Result<::openrazer::LedId> tryGetLedId() override;
+    Result<void> trySetOff() override;
+    Result<void> trySetOn() override;
+    Result<void> trySetStatic(::openrazer::RGB color) override;
+    Result<void> trySetBreathing(::openrazer::RGB color) override;
+    Result<void> trySetBreathingDual(::openrazer::RGB color, ::openrazer::RGB color2) override;
+    Result<void> trySetBreathingRandom() override;
+    Result<void> trySetBreathingMono() override;
+    Result<void> trySetBlinking(::openrazer::RGB color) override;
+    Result<void> trySetSpectrum() override;
+    Result<void> trySetWave(::openrazer::WaveDirection direction) override;
+    Result<void> trySetWheel(::openrazer::WheelDirection direction) override;
+    Result<void> trySetReactive(::openrazer::RGB color, ::openrazer::ReactiveSpeed speed) override;
+    Result<void> trySetRipple(::openrazer::RGB color) override;
+    Result<void> trySetRippleRandom() override;
+    Result<void> trySetBrightness(uchar brightness) override;
+    Result<uchar> tryGetBrightness() override;
 
 private:
+    Result<DBusCommand> prepareEffect(::openrazer::Effect effect, const EffectParams &params) override;
+    Result<DBusCommand> prepareSetBrightness(uchar brightness) override;
+
     LedPrivate *d;
+
+    friend class Watcher;
 };
 
 }
@@ -187,32 +352,82 @@ public:
     QDBusObjectPath getObjectPath() override;
     bool hasBrightness() override;
     bool hasFx(::openrazer::Effect fx) override;
-    ::openrazer::Effect getCurrentEffect() override;
-    QVector<::openrazer::RGB> getCurrentColors() override;
-    ::openrazer::WaveDirection getWaveDirection() override;
-    ::openrazer::LedId getLedId() override;
-    void setOff() override;
-    void setOn() override;
-    void setStatic(::openrazer::RGB color) override;
-    void setBreathing(::openrazer::RGB color) override;
-    void setBreathingDual(::openrazer::RGB color, ::openrazer::RGB color2) override;
-    void setBreathingRandom() override;
-    void setBreathingMono() override;
-    void setBlinking(::openrazer::RGB color) override;
-    void setSpectrum() override;
-    void setWave(::openrazer::WaveDirection direction) override;
-    void setWheel(::openrazer::WheelDirection direction) override;
-    void setReactive(::openrazer::RGB color, ::openrazer::ReactiveSpeed speed) override;
-    void setRipple(::openrazer::RGB color) override;
-    void setRippleRandom() override;
-    void setBrightness(uchar brightness) override;
-    uchar getBrightness() override;
+    Result<::openrazer::Effect> tryGetCurrentEffect() override;
+    Result<QVector<::openrazer::RGB>> tryGetCurrentColors() override;
+    Result<::openrazer::WaveDirection> tryGetWaveDirection() override;
+    Result<::openrazer::LedId> tryGetLedId() override;
+    Result<void> trySetOff() override;
+    Result<void> trySetOn() override;
+    Result<void> trySetStatic(::openrazer::RGB color) override;
+    Result<void> trySetBreathing(::openrazer::RGB color) override;
+    Result<void> trySetBreathingDual(::openrazer::RGB color, ::openrazer::RGB color2) override;
+    Result<void> trySetBreathingRandom() override;
+    Result<void> trySetBreathingMono() override;
+    Result<void> trySetBlinking(::openrazer::RGB color) override;
+    Result<void> trySetSpectrum() override;
+    Result<void> trySetWave(::openrazer::WaveDirection direction) override;
+    Result<void> trySetWheel(::openrazer::WheelDirection direction) override;
+    Result<void> trySetReactive(::openrazer::RGB color, ::openrazer::ReactiveSpeed speed) override;
+    Result<void> trySetRipple(::openrazer::RGB color) override;
+    Result<void> trySetRippleRandom() override;
+    Result<void> trySetBrightness(uchar brightness) override;
+    Result<uchar> tryGetBrightness() override;
+
+private:
+    Result<DBusCommand> prepareEffect(::openrazer::Effect effect, const EffectParams &params) override;
+    Result<DBusCommand> prepareSetBrightness(uchar brightness) override;
+
+    LedPrivate *d;
+};
+
+}
+
+#ifdef Q_OS_LINUX
+namespace sysfs {
+
+class Device;
+class LedPrivate;
+/*!
+ * \brief Led of a sysfs::Device, set through the sysfs attributes of the kernel driver.
+ *
+ * The driver doesn't report the current effect, colors and wave direction, they are only known after they have been set through this Led.
+ */
+class Led : public ::libopenrazer::Led
+{
+public:
+    Led(Device *device, ::openrazer::LedId ledId, const QString &effectPrefix, const QString &brightnessAttribute, const QDBusObjectPath &objectPath);
+    ~Led() override;
+
+    QDBusObjectPath getObjectPath() override;
+    bool hasBrightness() override;
+    bool hasFx(::openrazer::Effect fx) override;
+    Result<::openrazer::Effect> tryGetCurrentEffect() override;
+    Result<QVector<::openrazer::RGB>> tryGetCurrentColors() override;
+    Result<::openrazer::WaveDirection> tryGetWaveDirection() override;
+    Result<::openrazer::LedId> tryGetLedId() override;
+    Result<void> trySetOff() override;
+    Result<void> trySetOn() override;
+    Result<void> trySetStatic(::openrazer::RGB color) override;
+    Result<void> trySetBreathing(::openrazer::RGB color) override;
+    Result<void> trySetBreathingDual(::openrazer::RGB color, ::openrazer::RGB color2) override;
+    Result<void> trySetBreathingRandom() override;
+    Result<void> trySetBreathingMono() override;
+    Result<void> trySetBlinking(::openrazer::RGB color) override;
+    Result<void> trySetSpectrum() override;
+    Result<void> trySetWave(::openrazer::WaveDirection direction) override;
+    Result<void> trySetWheel(::openrazer::WheelDirection direction) override;
+    Result<void> trySetReactive(::openrazer::RGB color, ::openrazer::ReactiveSpeed speed) override;
+    Result<void> trySetRipple(::openrazer::RGB color) override;
+    Result<void> trySetRippleRandom() override;
+    Result<void> trySetBrightness(uchar brightness) override;
+    Result<uchar> tryGetBrightness() override;
 
 private:
     LedPrivate *d;
 };
 
 }
+#endif
 
 }
 
@@ -5,38 +5,126 @@
 #ifndef MANAGER_H
 #define MANAGER_H
 
+#include "libopenrazer/device.h"
+#include "libopenrazer/devicecatalog.h"
+#include "libopenrazer/led.h"
 #include "libopenrazer/misc.h"
+#include "libopenrazer/result.h"
 
+#include <QDBusConnection>
 #include <QDBusInterface>
 #include <QDBusServiceWatcher>
+#include <QHash>
+#include <QMap>
+
+#include <functional>
 
 namespace libopenrazer {
 
-class Device;
+/*!
+ * Result of applying an effect to a single Led, see Manager::applyToAll().
+ */
+struct LedResult {
+    Device *device;
+    Led *led;
+    Result<void> result;
+};
+
+/*!
+ * The daemons libopenrazer can talk to, see Manager::detectBackend().
+ */
+enum class Backend {
+    /** No daemon is running. */
+    None,
+    /** The OpenRazer daemon, see openrazer::Manager. */
+    OpenRazer,
+    /** The razer_test daemon, see razer_test::Manager. */
+    RazerTest,
+};
 
 /*!
  * \brief Abstraction for accessing Manager objects via D-Bus.
+ *
+ * The \c try variants of the methods, e.g. tryGetDevices(), return a Result instead of throwing a DBusException.
  */
 class Manager : public QObject
 {
     Q_OBJECT
 public:
+    /*!
+     * Returns which daemon is running, preferring the OpenRazer daemon if both are.
+     *
+     * Only asks the message buses if the service names of the daemons have an owner, both buses are asked concurrently so this takes a single round trip. Buses that don't answer within \a msecs milliseconds count as having no daemon.
+     *
+     * \sa createForRunningDaemon()
+     */
+    static Backend detectBackend(int msecs = 500);
+
+    /*!
+     * Returns a new Manager for \a backend, or \c nullptr for Backend::None. The caller owns the Manager.
+     */
+    static Manager *create(Backend backend);
+
+    /*!
+     * Returns a new Manager for the running daemon, see detectBackend(). If no daemon is running an openrazer::Manager is returned, so its daemon status can still be shown. The caller owns the Manager.
+     */
+    static Manager *createForRunningDaemon(int msecs = 500);
+
     /*!
      * Returns a list of connected devices in form of their DBus object paths.
      *
      * Can be used to call getDevice and get further information about the device.
      */
-    virtual QList<QDBusObjectPath> getDevices() = 0;
+    virtual QList<QDBusObjectPath> getDevices();
+
+    /*!
+     * Non-throwing variant of getDevices().
+     */
+    virtual Result<QList<QDBusObjectPath>> tryGetDevices() = 0;
 
     /*!
      * Returns a Device object with the given DBus object path.
      */
     virtual Device *getDevice(QDBusObjectPath objectPath) = 0;
 
+    /*!
+     * Returns Device objects for all connected devices.
+     *
+     * Same as calling getDevice() for every path returned by getDevices(), but the devices are set up concurrently where the backend supports it, so this takes about as long as setting up the slowest device.
+     * Devices that fail to set up are logged and left out. The caller owns the returned devices.
+     */
+    virtual QList<Device *> openAllDevices();
+
+    /*!
+     * Starts keeping track of the connected devices and returns them.
+     *
+     * The manager keeps a Device object for every connected device and updates this set when the daemon reports that devices were plugged in or removed, emitting deviceAdded() and deviceRemoved() for the changes.
+     * Only the devices that changed are created or deleted, all others keep their Device object.
+     *
+     * The returned devices are owned by the manager. Calling this method again returns the current set of devices.
+     */
+    QList<Device *> getTrackedDevices();
+
+    /*!
+     * Sets \a effect with the arguments in \a params on the Leds of all tracked devices, see getTrackedDevices().
+     *
+     * Leds that don't support \a effect are skipped, as are the ones \a filter returns \c false for, if given.
+     * The calls for all Leds are sent before waiting for the first reply, so this takes about as long as a single call.
+     *
+     * Returns the result for every Led the effect was applied to.
+     */
+    QList<LedResult> applyToAll(::openrazer::Effect effect, const EffectParams &params = EffectParams(),
+                                const std::function<bool(Device *device, Led *led)> &filter = nullptr);
+
     /*!
      * Returns the daemon version currently running (e.g. `2.3.0`).
      */
-    virtual QString getDaemonVersion() = 0;
+    virtual QString getDaemonVersion();
+
+    /*!
+     * Non-throwing variant of getDaemonVersion().
+     */
+    virtual Result<QString> tryGetDaemonVersion() = 0;
 
     /*!
      * Returns if the daemon is running (and responding to the version call).
@@ -46,9 +134,42 @@ public:
     /*!
      * Returns a list of supported devices in the format of `QHash<QString(DeviceName), QList<double(VID), double(PID)>>`.
      *
+     * Prefer getDeviceCatalog(), which can be queried by VID/PID.
+     *
      * \sa Device::getVid(), Device::getPid()
      */
-    virtual QVariantHash getSupportedDevices() = 0;
+    virtual QVariantHash getSupportedDevices();
+
+    /*!
+     * Non-throwing variant of getSupportedDevices().
+     */
+    virtual Result<QVariantHash> tryGetSupportedDevices();
+
+    /*!
+     * Returns the device models supported by the daemon.
+     *
+     * The catalog is fetched once per daemon version and cached, later calls don't call the daemon again until it has been restarted.
+     *
+     * \sa setDeviceCatalogCacheFile()
+     */
+    DeviceCatalog getDeviceCatalog();
+
+    /*!
+     * Non-throwing variant of getDeviceCatalog().
+     */
+    virtual Result<DeviceCatalog> tryGetDeviceCatalog() = 0;
+
+    /*!
+     * Sets the file the device catalog is persisted in to \a fileName, so it doesn't have to be fetched again after the application is restarted.
+     *
+     * An empty \a fileName (the default) keeps the catalog in memory only.
+     */
+    void setDeviceCatalogCacheFile(const QString &fileName);
+
+    /*!
+     * Returns the file the device catalog is persisted in, see setDeviceCatalogCacheFile().
+     */
+    QString deviceCatalogCacheFile() const;
 
     /*!
      * If devices should sync effects, as specified by \a yes.
@@ -57,36 +178,65 @@ public:
      *
      * \sa getSyncEffects()
      */
-    virtual void syncEffects(bool yes) = 0;
+    virtual void syncEffects(bool yes);
+
+    /*!
+     * Non-throwing variant of syncEffects().
+     */
+    virtual Result<void> trySyncEffects(bool yes) = 0;
 
     /*!
      * Returns if devices should sync effect.
      *
      * \sa syncEffects()
      */
-    virtual bool getSyncEffects() = 0;
+    virtual bool getSyncEffects();
+
+    /*!
+     * Non-throwing variant of getSyncEffects().
+     */
+    virtual Result<bool> tryGetSyncEffects() = 0;
 
     /*!
      * Sets if the LEDs should turn off if the screensaver is turned on, as specified by \a turnOffOnScreensaver.
      *
      * \sa getTurnOffOnScreensaver()
      */
-    virtual void setTurnOffOnScreensaver(bool turnOffOnScreensaver) = 0;
+    virtual void setTurnOffOnScreensaver(bool turnOffOnScreensaver);
+
+    /*!
+     * Non-throwing variant of setTurnOffOnScreensaver().
+     */
+    virtual Result<void> trySetTurnOffOnScreensaver(bool turnOffOnScreensaver) = 0;
 
     /*!
      * Returns if the LEDs should turn off if the screensaver is turned on.
      *
      * \sa setTurnOffOnScreensaver()
      */
-    virtual bool getTurnOffOnScreensaver() = 0;
+    virtual bool getTurnOffOnScreensaver();
+
+    /*!
+     * Non-throwing variant of getTurnOffOnScreensaver().
+     */
+    virtual Result<bool> tryGetTurnOffOnScreensaver() = 0;
 
     /*!
      * Returns status of the daemon, see DaemonStatus.
+     *
+     * The state of the systemd unit is read through the D-Bus API of systemd and cached until systemd reports that unit files changed. The \c LIBOPENRAZER_SYSTEMD_SERVICE environment variable can be set to use a stand-in service instead of \c org.freedesktop.systemd1.
+     *
+     * \sa getDaemonStatusAsync()
      */
     virtual DaemonStatus getDaemonStatus() = 0;
 
     /*!
-     * Returns the multiline output of systemctl status.
+     * Asynchronous variant of getDaemonStatus(). \a callback is called with the status in the thread of \a context, unless \a context has been destroyed by then.
+     */
+    virtual void getDaemonStatusAsync(QObject *context, const std::function<void(DaemonStatus status)> &callback) = 0;
+
+    /*!
+     * Returns a multiline summary of the systemd unit of the daemon, like the one of systemctl status.
      */
     virtual QString getDaemonStatusOutput() = 0;
 
@@ -94,8 +244,15 @@ public:
      * Enables the systemd unit for the OpenRazer daemon to auto-start when the user logs in.
      *
      * Returns if the call was successful.
+     *
+     * \sa enableDaemonAsync()
      */
     virtual bool enableDaemon() = 0;
+
+    /*!
+     * Asynchronous variant of enableDaemon(). \a callback is called with the result in the thread of \a context, unless \a context has been destroyed by then.
+     */
+    virtual void enableDaemonAsync(QObject *context, const std::function<void(bool success)> &callback) = 0;
     // bool disableDaemon();
 
     /*!
@@ -118,6 +275,89 @@ public:
      * The \c serviceRegistered and \c serviceUnregistered signals are probably the most interesting ones.
      */
     virtual QDBusServiceWatcher *getServiceWatcher() = 0;
+
+    /*!
+     * Sets the timeout in milliseconds for D-Bus calls of this manager and of the devices returned by getDevice() afterwards to \a msecs.
+     *
+     * A negative value (the default) uses the default timeout of QtDBus, which is 25 seconds.
+     * Use a Deadline to limit the time of individual calls or of a group of calls further.
+     *
+     * \sa defaultTimeout()
+     */
+    virtual void setDefaultTimeout(int msecs) = 0;
+
+    /*!
+     * Returns the timeout in milliseconds for D-Bus calls of this manager, or a negative value if the QtDBus default is used.
+     *
+     * \sa setDefaultTimeout()
+     */
+    virtual int defaultTimeout() = 0;
+
+    /*!
+     * Spreads the devices returned by getDevice() and openAllDevices() afterwards over \a connections.
+     *
+     * Each device is assigned to one of the connections the first time it is opened and keeps it, new devices get the connections in turn.
+     * Messages on one connection are written to and read from a single socket in order, so calls to devices on different connections don't queue up behind each other. This helps when many devices are driven at high rates, e.g. with custom frames.
+     *
+     * The connections have to reach the daemon, e.g. private connections to its bus from openPrivateConnections(). Calls of the manager itself keep using its own connection.
+     * An empty list (the default) uses the connection of the manager for all devices. For a CompositeManager set the connections on its backends instead, see CompositeManager::backends().
+     */
+    void setDeviceConnections(const QList<QDBusConnection> &connections);
+
+    /*!
+     * Returns the connections the devices are spread over, see setDeviceConnections().
+     */
+    QList<QDBusConnection> deviceConnections() const;
+
+    /*!
+     * Opens \a count private connections to the bus of the given \a type, e.g. for setDeviceConnections().
+     *
+     * Unlike QDBusConnection::sessionBus() and QDBusConnection::systemBus(), each of them has its own socket. They stay open until they are closed with QDBusConnection::disconnectFromBus().
+     */
+    static QList<QDBusConnection> openPrivateConnections(QDBusConnection::BusType type, int count);
+
+Q_SIGNALS:
+    /*!
+     * Emitted when \a device has been plugged in, see getTrackedDevices().
+     */
+    void deviceAdded(libopenrazer::Device *device);
+
+    /*!
+     * Emitted when the device with the given \a objectPath has been removed, see getTrackedDevices().
+     *
+     * Its Device object is deleted once control returns to the event loop.
+     */
+    void deviceRemoved(QDBusObjectPath objectPath);
+
+protected:
+    // The connection for the device at objectPath, fallback if no device connections are set
+    QDBusConnection deviceConnection(const QDBusObjectPath &objectPath, const QDBusConnection &fallback);
+
+private Q_SLOTS:
+    void updateTrackedDevices();
+
+private:
+    // For CompositeManager, the default implementations fail with org.freedesktop.DBus.Error.NotSupported
+    virtual Result<DBusCommand> prepareGetDevices();
+    virtual Result<QList<QDBusObjectPath>> parseDevices(const QDBusMessage &reply);
+    virtual Result<DBusCommand> prepareGetSerial(const QDBusObjectPath &objectPath);
+    // Sets up the devices at objectPaths for openAllDevices(), the default calls getDevice() for each
+    virtual QList<Device *> openDevices(const QList<QDBusObjectPath> &objectPaths);
+    // What identifies the device at objectPath besides the path, empty by default
+    virtual QString deviceIdentity(const QDBusObjectPath &objectPath);
+
+    void syncTrackedDevices(bool notify);
+
+    bool m_tracking = false;
+    QString m_catalogCacheFile;
+    QMap<QString, Device *> m_trackedDevices;
+    // deviceIdentity() of the tracked devices when they were last synced
+    QHash<QString, QString> m_trackedIdentities;
+    QList<QDBusConnection> m_deviceConnections;
+    // Index into m_deviceConnections for every device opened so far
+    QHash<QString, int> m_deviceShards;
+
+    friend class CompositeManager;
 };
 
 namespace openrazer {
@@ -127,22 +367,39 @@ class Manager : public ::libopenrazer::Manager
 {
 public:
     Manager();
-    QList<QDBusObjectPath> getDevices() override;
+    /*!
+     * Creates a manager that talks to the daemon over \a connection instead of the bus the daemon usually is on.
+     */
+    explicit Manager(const QDBusConnection &connection);
+    /*!
+     * Returns the connection the manager talks to the daemon over.
+     */
+    QDBusConnection connection() const;
+    Result<QList<QDBusObjectPath>> tryGetDevices() override;
     Device *getDevice(QDBusObjectPath objectPath) override;
-    QString getDaemonVersion() override;
+    Result<QString> tryGetDaemonVersion() override;
     bool isDaemonRunning() override;
-    QVariantHash getSupportedDevices() override;
-    void syncEffects(bool yes) override;
-    bool getSyncEffects() override;
-    void setTurnOffOnScreensaver(bool turnOffOnScreensaver) override;
-    bool getTurnOffOnScreensaver() override;
+    Result<DeviceCatalog> tryGetDeviceCatalog() override;
+    Result<void> trySyncEffects(bool yes) override;
+    Result<bool> tryGetSyncEffects() override;
+    Result<void> trySetTurnOffOnScreensaver(bool turnOffOnScreensaver) override;
+    Result<bool> tryGetTurnOffOnScreensaver() override;
     DaemonStatus getDaemonStatus() override;
+    void getDaemonStatusAsync(QObject *context, const std::function<void(DaemonStatus status)> &callback) override;
     QString getDaemonStatusOutput() override;
     bool enableDaemon() override;
+    void enableDaemonAsync(QObject *context, const std::function<void(bool success)> &callback) override;
     bool connectDevicesChanged(QObject *receiver, const char *slot) override;
     QDBusServiceWatcher *getServiceWatcher() override;
+    void setDefaultTimeout(int msecs) override;
+    int defaultTimeout() override;
 
 private:
+    Result<DBusCommand> prepareGetDevices() override;
+    Result<QList<QDBusObjectPath>> parseDevices(const QDBusMessage &reply) override;
+    Result<DBusCommand> prepareGetSerial(const QDBusObjectPath &objectPath) override;
+    QList<::libopenrazer::Device *> openDevices(const QList<QDBusObjectPath> &objectPaths) override;
+
     ManagerPrivate *d;
 };
 
@@ -155,27 +412,96 @@ class Manager : public ::libopenrazer::Manager
 {
 public:
     Manager();
-    QList<QDBusObjectPath> getDevices() override;
+    /*!
+     * Creates a manager that talks to the daemon over \a connection instead of the bus the daemon usually is on.
+     */
+    explicit Manager(const QDBusConnection &connection);
+    /*!
+     * Returns the connection the manager talks to the daemon over.
+     */
+    QDBusConnection connection() const;
+    Result<QList<QDBusObjectPath>> tryGetDevices() override;
     Device *getDevice(QDBusObjectPath objectPath) override;
-    QString getDaemonVersion() override;
+    Result<QString> tryGetDaemonVersion() override;
     bool isDaemonRunning() override;
-    QVariantHash getSupportedDevices() override;
-    void syncEffects(bool yes) override;
-    bool getSyncEffects() override;
-    void setTurnOffOnScreensaver(bool turnOffOnScreensaver) override;
-    bool getTurnOffOnScreensaver() override;
+    Result<DeviceCatalog> tryGetDeviceCatalog() override;
+    Result<void> trySyncEffects(bool yes) override;
+    Result<bool> tryGetSyncEffects() override;
+    Result<void> trySetTurnOffOnScreensaver(bool turnOffOnScreensaver) override;
+    Result<bool> tryGetTurnOffOnScreensaver() override;
     DaemonStatus getDaemonStatus() override;
+    void getDaemonStatusAsync(QObject *context, const std::function<void(DaemonStatus status)> &callback) override;
     QString getDaemonStatusOutput() override;
     bool enableDaemon() override;
+    void enableDaemonAsync(QObject *context, const std::function<void(bool success)> &callback) override;
     bool connectDevicesChanged(QObject *receiver, const char *slot) override;
     QDBusServiceWatcher *getServiceWatcher() override;
+    void setDefaultTimeout(int msecs) override;
+    int defaultTimeout() override;
 
 private:
+    Result<DBusCommand> prepareGetDevices() override;
+    Result<QList<QDBusObjectPath>> parseDevices(const QDBusMessage &reply) override;
+    Result<DBusCommand> prepareGetSerial(const QDBusObjectPath &objectPath) override;
+
     ManagerPrivate *d;
 };
 
 }
 
+class CompositeManagerPrivate;
+
+/*!
+ * \brief Manager that drives the OpenRazer and the razer_test daemon at the same time.
+ *
+ * Devices of both daemons are listed together. A device handled by both daemons is only listed once, by its serial, and the OpenRazer daemon is preferred for it.
+ * getDevice() creates the Device through the backend that listed it, so all later calls go to the right daemon.
+ *
+ * Both daemons are asked concurrently when listing the devices. Batched writes like applyToAll() or Scene::apply() on the tracked devices also go to both buses concurrently.
+ * A daemon that isn't running is ignored as long as the other one is.
+ */
+class CompositeManager : public Manager
+{
+public:
+    CompositeManager();
+    ~CompositeManager() override;
+
+    /*!
+     * Returns the backend Manager that handles the device at \a objectPath, or \c nullptr if it isn't known.
+     */
+    Manager *managerFor(const QDBusObjectPath &objectPath);
+
+    /*!
+     * Returns the backend Managers in the order of preference, e.g. to set their device connections, see setDeviceConnections().
+     */
+    QList<Manager *> backends() const;
+
+    Result<QList<QDBusObjectPath>> tryGetDevices() override;
+    Device *getDevice(QDBusObjectPath objectPath) override;
+    QList<Device *> openAllDevices() override;
+    Result<QString> tryGetDaemonVersion() override;
+    bool isDaemonRunning() override;
+    Result<DeviceCatalog> tryGetDeviceCatalog() override;
+    Result<void> trySyncEffects(bool yes) override;
+    Result<bool> tryGetSyncEffects() override;
+    Result<void> trySetTurnOffOnScreensaver(bool turnOffOnScreensaver) override;
+    Result<bool> tryGetTurnOffOnScreensaver() override;
+    DaemonStatus getDaemonStatus() override;
+    void getDaemonStatusAsync(QObject *context, const std::function<void(DaemonStatus status)> &callback) override;
+    QString getDaemonStatusOutput() override;
+    bool enableDaemon() override;
+    void enableDaemonAsync(QObject *context, const std::function<void(bool success)> &callback) override;
+    bool connectDevicesChanged(QObject *receiver, const char *slot) override;
+    QDBusServiceWatcher *getServiceWatcher() override;
+    void setDefaultTimeout(int msecs) override;
+    int defaultTimeout() override;
+
+private:
+    QString deviceIdentity(const QDBusObjectPath &objectPath) override;
+
+    CompositeManagerPrivate *d;
+};
+
 }
 
 #endif // MANAGER_H
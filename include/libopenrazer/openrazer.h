@@ -182,6 +182,15 @@ struct DPI {
     ushort dpi_y;
 };
 
+inline bool operator==(const DPI &a, const DPI &b)
+{
+    return a.dpi_x == b.dpi_x && a.dpi_y == b.dpi_y;
+}
+inline bool operator!=(const DPI &a, const DPI &b)
+{
+    return !(a == b);
+}
+
 // Marshall the DPI data into a D-Bus argument
 inline QDBusArgument &operator<<(QDBusArgument &argument, const DPI &value)
 {
@@ -241,6 +250,15 @@ struct RGB {
     uchar b;
 };
 
+inline bool operator==(const RGB &a, const RGB &b)
+{
+    return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+inline bool operator!=(const RGB &a, const RGB &b)
+{
+    return !(a == b);
+}
+
 // Marshall the RGB data into a D-Bus argument
 inline QDBusArgument &operator<<(QDBusArgument &argument, const RGB &value)
 {
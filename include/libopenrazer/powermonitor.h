@@ -0,0 +1,114 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef POWERMONITOR_H
+#define POWERMONITOR_H
+
+#include "libopenrazer/device.h"
+#include "libopenrazer/manager.h"
+
+#include <QHash>
+#include <QPointer>
+#include <QSet>
+#include <QTimer>
+
+namespace libopenrazer {
+
+/*!
+ * \brief Watches the battery of all devices of a Manager.
+ *
+ * All users of a Manager share one monitor, see forManager(). While it has subscribers, it polls the battery level and charging state of all tracked devices with the Feature::Battery feature (see Manager::getTrackedDevices()) in a single batch of concurrent calls, and emits signals only when something changed.
+ *
+ * The poll interval adapts to the devices: it is reset to the minimum interval whenever something changed, a device is charging or a battery is close to its low battery threshold, and doubles after each poll without changes up to the maximum interval.
+ *
+ * \code
+ * libopenrazer::PowerMonitor *monitor = libopenrazer::PowerMonitor::forManager(manager);
+ * connect(monitor, &libopenrazer::PowerMonitor::batteryPercentChanged, this, &Window::updateBattery);
+ * monitor->subscribe(this);
+ * \endcode
+ */
+class PowerMonitor : public QObject
+{
+    Q_OBJECT
+public:
+    /*!
+     * Returns the monitor shared by all users of \a manager, creating it if needed. It is owned by \a manager.
+     */
+    static PowerMonitor *forManager(Manager *manager);
+
+    /*!
+     * Adds \a subscriber to the objects interested in the battery state. The monitor polls while it has at least one subscriber.
+     *
+     * Subscribers are removed automatically when they are destroyed.
+     *
+     * \sa unsubscribe()
+     */
+    void subscribe(QObject *subscriber);
+
+    /*!
+     * Removes \a subscriber again, see subscribe().
+     */
+    void unsubscribe(QObject *subscriber);
+
+    /*!
+     * Returns the last known battery percentage of \a device, or a negative value if it hasn't been read yet.
+     */
+    double getBatteryPercent(Device *device) const;
+
+    /*!
+     * Returns the last known charging state of \a device.
+     */
+    bool isCharging(Device *device) const;
+
+    /*!
+     * Sets the shortest and the longest time between two polls to \a minimumMsecs and \a maximumMsecs. The defaults are 30 seconds and 10 minutes.
+     */
+    void setPollIntervals(int minimumMsecs, int maximumMsecs);
+
+Q_SIGNALS:
+    /*!
+     * Emitted when the battery percentage of \a device changed to \a percent.
+     */
+    void batteryPercentChanged(libopenrazer::Device *device, double percent);
+
+    /*!
+     * Emitted when \a device started or stopped \a charging.
+     */
+    void chargingChanged(libopenrazer::Device *device, bool charging);
+
+private:
+    explicit PowerMonitor(Manager *manager);
+
+    enum Query {
+        BatteryPercent,
+        Charging,
+        LowBatteryThreshold,
+    };
+    struct DeviceState {
+        double batteryPercent = -1;
+        bool charging = false;
+        double lowBatteryThreshold = -1;
+    };
+
+    void poll();
+    bool update(Device *device, Query query, const QVariant &value);
+    void scheduleNextPoll(bool changed);
+    void removeDevice(const QDBusObjectPath &objectPath);
+
+    // How close to the low battery threshold, in percentage points, polling stays fast
+    static constexpr double LOW_BATTERY_MARGIN = 10;
+
+    Manager *m_manager;
+    QTimer m_timer;
+    QSet<QObject *> m_subscribers;
+    bool m_polling = false;
+    int m_minimumInterval = 30000;
+    int m_maximumInterval = 600000;
+    int m_interval = 30000;
+    QHash<Device *, DeviceState> m_states;
+};
+
+}
+
+#endif // POWERMONITOR_H
@@ -0,0 +1,163 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef RESULT_H
+#define RESULT_H
+
+#include <QDBusError>
+#include <QString>
+
+#include <optional>
+#include <variant>
+
+namespace libopenrazer {
+
+/*!
+ * \brief Describes why a call failed
+ *
+ * Contains the same information as the DBusException that the throwing variant of the call would have thrown.
+ *
+ * \sa Result
+ */
+class Error
+{
+public:
+    /*!
+     * The kind of failure, matching the DBusException subclasses.
+     */
+    enum Type {
+        /** The daemon returned an error or an invalid reply, see DBusException. */
+        Failed,
+        /** The daemon is not available, see ServiceUnavailableException. */
+        ServiceUnavailable,
+        /** The call didn't finish in time, see TimeoutException. */
+        Timeout,
+    };
+
+    /// @cond
+    Error(const QDBusError &error);
+    Error(const QString &name, const QString &message);
+    /// @endcond
+
+    /*!
+     * Returns the kind of failure.
+     */
+    Type type() const;
+
+    /*!
+     * Returns the "title" of this error, e.g. the D-Bus error name.
+     */
+    QString name() const;
+
+    /*!
+     * Returns a detailed message for this error.
+     */
+    QString message() const;
+
+private:
+    Type m_type;
+    QString m_name;
+    QString m_message;
+};
+
+/*!
+ * \brief Either the value returned by a call or the Error it failed with
+ *
+ * Returned by the \c try variants of the methods, which don't throw exceptions and don't log anything on failure.
+ *
+ * \code
+ * libopenrazer::Result<uchar> brightness = led->tryGetBrightness();
+ * if (brightness)
+ *     slider->setValue(brightness.value());
+ * \endcode
+ */
+template<typename T, typename E = Error>
+class Result
+{
+public:
+    /// @cond
+    Result(const T &value)
+        : m_data(std::in_place_index<0>, value) { }
+    Result(T &&value)
+        : m_data(std::in_place_index<0>, std::move(value)) { }
+    Result(const E &error)
+        : m_data(std::in_place_index<1>, error) { }
+    /// @endcond
+
+    /*!
+     * Returns if the call succeeded.
+     */
+    bool isOk() const { return m_data.index() == 0; }
+
+    /*!
+     * Same as isOk().
+     */
+    explicit operator bool() const { return isOk(); }
+
+    /*!
+     * Returns the value. Must only be called if isOk() returns true.
+     */
+    const T &value() const
+    {
+        Q_ASSERT(isOk());
+        return *std::get_if<0>(&m_data);
+    }
+
+    /*!
+     * Returns the value, or \a fallback if the call failed.
+     */
+    T valueOr(const T &fallback) const { return isOk() ? value() : fallback; }
+
+    /*!
+     * Returns the error. Must only be called if isOk() returns false.
+     */
+    const E &error() const
+    {
+        Q_ASSERT(!isOk());
+        return *std::get_if<1>(&m_data);
+    }
+
+private:
+    std::variant<T, E> m_data;
+};
+
+/*!
+ * \brief Result of a call that doesn't return a value
+ */
+template<typename E>
+class Result<void, E>
+{
+public:
+    /// @cond
+    Result() = default;
+    Result(const E &error)
+        : m_error(error) { }
+    /// @endcond
+
+    /*!
+     * Returns if the call succeeded.
+     */
+    bool isOk() const { return !m_error.has_value(); }
+
+    /*!
+     * Same as isOk().
+     */
+    explicit operator bool() const { return isOk(); }
+
+    /*!
+     * Returns the error. Must only be called if isOk() returns false.
+     */
+    const E &error() const
+    {
+        Q_ASSERT(!isOk());
+        return *m_error;
+    }
+
+private:
+    std::optional<E> m_error;
+};
+
+}
+
+#endif // RESULT_H
@@ -0,0 +1,113 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SCENE_H
+#define SCENE_H
+
+#include "libopenrazer/device.h"
+#include "libopenrazer/led.h"
+#include "libopenrazer/openrazer.h"
+#include "libopenrazer/result.h"
+
+namespace libopenrazer {
+
+class ScenePrivate;
+
+/*!
+ * \brief A set of device settings that can be applied at once, e.g. a lighting or DPI profile.
+ *
+ * The settings are addressed by the serial of the device (see Device::getSerial()) and, for Led settings, by the ::openrazer::LedId of the Led.
+ * Setting the same thing twice replaces the previous value.
+ *
+ * Before a scene can be applied it has to be compiled against the current devices with compile(). This does the capability checks and prepares the D-Bus calls once, apply() then only sends them.
+ * Compile the scene again after devices have been added or removed.
+ *
+ * \code
+ * libopenrazer::Scene scene;
+ * scene.setEffect(serial, openrazer::LedId::LogoLED, openrazer::Effect::Static, { { 255, 0, 0 } });
+ * scene.setDPI(serial, { 800, 800 });
+ * scene.compile(manager->getTrackedDevices());
+ * scene.apply();
+ * \endcode
+ */
+class Scene
+{
+public:
+    Scene();
+    ~Scene();
+
+    Scene(const Scene &) = delete;
+    Scene &operator=(const Scene &) = delete;
+
+    /*!
+     * Sets \a effect with the arguments in \a params on the Led \a ledId of the device with the given \a serial.
+     */
+    void setEffect(const QString &serial, ::openrazer::LedId ledId, ::openrazer::Effect effect, const EffectParams &params = EffectParams());
+
+    /*!
+     * Sets the brightness of the Led \a ledId of the device with the given \a serial to \a brightness.
+     */
+    void setBrightness(const QString &serial, ::openrazer::LedId ledId, uchar brightness);
+
+    /*!
+     * Sets the DPI of the device with the given \a serial to \a dpi.
+     */
+    void setDPI(const QString &serial, ::openrazer::DPI dpi);
+
+    /*!
+     * Sets the DPI stages of the device with the given \a serial to \a dpiStages, with stage nr. \a activeStage active.
+     */
+    void setDPIStages(const QString &serial, uchar activeStage, const QVector<::openrazer::DPI> &dpiStages);
+
+    /*!
+     * Sets the poll rate of the device with the given \a serial to \a pollrate.
+     */
+    void setPollRate(const QString &serial, ushort pollrate);
+
+    /*!
+     * Removes all settings from the scene.
+     */
+    void clear();
+
+    /*!
+     * Prepares the D-Bus calls for the settings of the scene on \a devices.
+     *
+     * Settings for devices that are not in \a devices or that the device doesn't support are skipped.
+     * Returns the number of settings that will be applied.
+     */
+    int compile(const QList<Device *> &devices);
+
+    /*!
+     * Returns if compile() has been called since the scene was last changed.
+     */
+    bool isCompiled() const;
+
+    /*!
+     * Applies the compiled scene.
+     *
+     * All calls are sent before waiting for the first reply, also if some of them fail. Returns the first error, if any.
+     */
+    Result<void> apply();
+
+    /*!
+     * Writes the settings of the scene to \a fileName. Returns if this was successful.
+     *
+     * \sa load()
+     */
+    bool save(const QString &fileName) const;
+
+    /*!
+     * Replaces the settings of the scene with the ones in \a fileName. Returns if this was successful, otherwise the scene is left unchanged.
+     *
+     * \sa save()
+     */
+    bool load(const QString &fileName);
+
+private:
+    ScenePrivate *d;
+};
+
+}
+
+#endif // SCENE_H
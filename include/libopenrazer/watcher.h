@@ -0,0 +1,146 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef WATCHER_H
+#define WATCHER_H
+
+#include "libopenrazer/device.h"
+#include "libopenrazer/led.h"
+
+#include <QHash>
+#include <QPointer>
+#include <QTimer>
+
+#include <optional>
+
+namespace libopenrazer {
+
+namespace openrazer {
+
+/*!
+ * \brief Notices changes made to an OpenRazer device from outside of the application.
+ *
+ * The OpenRazer daemon doesn't emit signals when a setting is changed, e.g. by another application or by a key combination on the device. A watcher polls the current effect, colors and brightness of all Leds of the device and its DPI and poll rate in a single batch of concurrent calls, and emits a signal only for the values that changed since the previous poll. Values the device doesn't support aren't polled.
+ *
+ * Watchers are opt-in, nothing is polled until start() is called. The first poll only records the current values, read them with the getters of Device and Led.
+ *
+ * \code
+ * auto *watcher = new libopenrazer::openrazer::Watcher(device, this);
+ * connect(watcher, &libopenrazer::openrazer::Watcher::brightnessChanged, this, &Window::updateBrightness);
+ * watcher->start();
+ * \endcode
+ */
+class Watcher : public QObject
+{
+    Q_OBJECT
+public:
+    /*!
+     * Creates a stopped watcher for \a device.
+     */
+    explicit Watcher(Device *device, QObject *parent = nullptr);
+
+    /*!
+     * Returns the watched device, or \c nullptr if it has been destroyed.
+     */
+    Device *device() const;
+
+    /*!
+     * Sets the time between two polls to \a msecs. The default is 2 seconds.
+     */
+    void setInterval(int msecs);
+
+    /*!
+     * Returns the time between two polls in milliseconds.
+     */
+    int interval() const;
+
+    /*!
+     * Sets the time the calls of a single poll may take to \a msecs. Values that haven't been read by then are skipped until the next poll. The default of -1 uses the timeout of the device.
+     */
+    void setPollBudget(int msecs);
+
+    /*!
+     * Returns the time the calls of a single poll may take in milliseconds, see setPollBudget().
+     */
+    int pollBudget() const;
+
+    /*!
+     * Starts polling. The first poll happens right away.
+     */
+    void start();
+
+    /*!
+     * Stops polling and forgets the recorded values.
+     */
+    void stop();
+
+    /*!
+     * Returns if the watcher is polling.
+     */
+    bool isActive() const;
+
+Q_SIGNALS:
+    /*!
+     * Emitted when the current effect of \a led changed to \a effect.
+     */
+    void effectChanged(libopenrazer::Led *led, ::openrazer::Effect effect);
+
+    /*!
+     * Emitted when the colors of the current effect of \a led changed to \a colors.
+     */
+    void colorsChanged(libopenrazer::Led *led, const QVector<::openrazer::RGB> &colors);
+
+    /*!
+     * Emitted when the brightness of \a led changed to \a brightness.
+     */
+    void brightnessChanged(libopenrazer::Led *led, uchar brightness);
+
+    /*!
+     * Emitted when the DPI of the device changed to \a dpi.
+     */
+    void dpiChanged(::openrazer::DPI dpi);
+
+    /*!
+     * Emitted when the poll rate of the device changed to \a pollRate.
+     */
+    void pollRateChanged(ushort pollRate);
+
+private:
+    enum Property {
+        Effect,
+        Colors,
+        Brightness,
+        DPI,
+        PollRate,
+    };
+    struct Target {
+        QPointer<Led> led;
+        Property property;
+    };
+    struct LedState {
+        std::optional<::openrazer::Effect> effect;
+        std::optional<QVector<::openrazer::RGB>> colors;
+        std::optional<uchar> brightness;
+    };
+
+    void poll();
+    void handleReply(const Target &target, const QDBusMessage &reply);
+
+    QPointer<Device> m_device;
+    QTimer m_timer;
+    int m_pollBudget = -1;
+    // A poll is only started when the previous one has finished
+    bool m_polling = false;
+    // Incremented by stop(), so replies of an older poll are dropped
+    int m_session = 0;
+    QHash<Led *, LedState> m_ledStates;
+    std::optional<::openrazer::DPI> m_dpi;
+    std::optional<ushort> m_pollRate;
+};
+
+}
+
+}
+
+#endif // WATCHER_H
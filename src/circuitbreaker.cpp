@@ -0,0 +1,151 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "circuitbreaker_p.h"
+#include "logging_p.h"
+
+#include <QCoreApplication>
+#include <QDBusError>
+#include <QDeadlineTimer>
+#include <QHash>
+#include <QMutex>
+
+namespace libopenrazer {
+
+const char *SERVICE_UNAVAILABLE_ERROR = "libopenrazer.Error.ServiceUnavailable";
+const char *DEADLINE_EXCEEDED_ERROR = "libopenrazer.Error.DeadlineExceeded";
+
+namespace {
+struct BreakerRegistry {
+    QMutex mutex;
+    QHash<QString, CircuitBreaker *> breakers;
+};
+}
+Q_GLOBAL_STATIC(BreakerRegistry, breakerRegistry)
+
+CircuitBreaker *CircuitBreaker::forService(const QString &service, const QDBusConnection &connection)
+{
+    QString key = connection.name() + QLatin1Char('/') + service;
+    QMutexLocker locker(&breakerRegistry->mutex);
+    CircuitBreaker *&breaker = breakerRegistry->breakers[key];
+    if (breaker == nullptr)
+        breaker = new CircuitBreaker(service, connection);
+    return breaker;
+}
+
+CircuitBreaker::CircuitBreaker(const QString &service, const QDBusConnection &connection)
+    : service(service)
+{
+    watcher = new QDBusServiceWatcher(service, connection, QDBusServiceWatcher::WatchForOwnerChange);
+    // Breakers can get created from any thread, deliver the signals in the main thread
+    if (QCoreApplication::instance() != nullptr)
+        watcher->moveToThread(QCoreApplication::instance()->thread());
+    QObject::connect(watcher, &QDBusServiceWatcher::serviceUnregistered, watcher, [this]() { open(); });
+    QObject::connect(watcher, &QDBusServiceWatcher::serviceRegistered, watcher, [this]() { close(); });
+    QObject::connect(watcher, &QDBusServiceWatcher::serviceOwnerChanged, watcher, [this]() { generation.ref(); });
+}
+
+bool CircuitBreaker::allowRequest()
+{
+    switch (state.loadAcquire()) {
+    case Closed:
+        return true;
+    case HalfOpen:
+        // A probe call is already on its way. If its reply never gets recorded,
+        // go back to Open so another probe is let through later.
+        if (QDeadlineTimer::current().deadline() >= retryAt.loadRelaxed()
+            && state.testAndSetOrdered(HalfOpen, Open))
+            retryAt.storeRelaxed(QDeadlineTimer::current().deadline() + RETRY_INTERVAL);
+        return false;
+    default: {
+        qint64 now = QDeadlineTimer::current().deadline();
+        if (now < retryAt.loadRelaxed())
+            return false;
+        // Let exactly one call through to check if the service is back, in
+        // HalfOpen retryAt is when the probe is given up on
+        retryAt.storeRelaxed(now + PROBE_TIMEOUT);
+        return state.testAndSetOrdered(Open, HalfOpen);
+    }
+    }
+}
+
+void CircuitBreaker::recordSuccess()
+{
+    consecutiveFailures.storeRelaxed(0);
+    if (state.loadRelaxed() != Closed)
+        close();
+}
+
+void CircuitBreaker::recordAborted()
+{
+    // Just make sure a probe that got cut short doesn't keep the breaker half-open
+    if (state.testAndSetOrdered(HalfOpen, Open))
+        retryAt.storeRelaxed(QDeadlineTimer::current().deadline());
+}
+
+void CircuitBreaker::recordReply(const QDBusMessage &reply)
+{
+    if (reply.type() != QDBusMessage::ErrorMessage) {
+        recordSuccess();
+        return;
+    }
+
+    // The caller ran out of time, that doesn't say anything about the service
+    if (reply.errorName() == DEADLINE_EXCEEDED_ERROR) {
+        recordAborted();
+        return;
+    }
+
+    switch (QDBusError(reply).type()) {
+    case QDBusError::ServiceUnknown:
+    case QDBusError::NameHasNoOwner:
+    case QDBusError::Disconnected:
+        open();
+        break;
+    case QDBusError::NoReply:
+    case QDBusError::Timeout:
+        if (state.loadRelaxed() == HalfOpen
+            || consecutiveFailures.fetchAndAddRelaxed(1) + 1 >= FAILURE_THRESHOLD)
+            open();
+        break;
+    default:
+        // The service did answer, just with an error
+        consecutiveFailures.storeRelaxed(0);
+        if (state.loadRelaxed() != Closed)
+            close();
+        break;
+    }
+}
+
+QDBusMessage CircuitBreaker::unavailableError() const
+{
+    return QDBusMessage::createError(SERVICE_UNAVAILABLE_ERROR,
+                                     QString("%1 is not available").arg(service));
+}
+
+bool CircuitBreaker::isOpen() const
+{
+    return state.loadRelaxed() != Closed;
+}
+
+int CircuitBreaker::ownerGeneration() const
+{
+    return generation.loadAcquire();
+}
+
+void CircuitBreaker::open()
+{
+    retryAt.storeRelaxed(QDeadlineTimer::current().deadline() + RETRY_INTERVAL);
+    if (state.fetchAndStoreOrdered(Open) == Closed)
+        qCWarning(lcTransport, "libopenrazer: %s is not available, failing calls until it is back", qUtf8Printable(service));
+}
+
+void CircuitBreaker::close()
+{
+    consecutiveFailures.storeRelaxed(0);
+    if (state.fetchAndStoreOrdered(Closed) != Closed)
+        qCInfo(lcTransport, "libopenrazer: %s is available again", qUtf8Printable(service));
+}
+
+}
@@ -0,0 +1,112 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef CIRCUITBREAKER_P_H
+#define CIRCUITBREAKER_P_H
+
+#include <QAtomicInteger>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusServiceWatcher>
+
+namespace libopenrazer {
+
+/*
+ * Error name used for calls that were rejected by an open circuit breaker.
+ */
+extern const char *SERVICE_UNAVAILABLE_ERROR;
+
+/*
+ * Error name used for calls that didn't finish before the active Deadline.
+ */
+extern const char *DEADLINE_EXCEEDED_ERROR;
+
+/*
+ * Per-connection circuit breaker for a D-Bus service.
+ *
+ * The breaker opens when the service disappears from the bus or stops
+ * answering calls. While it is open, calls are rejected immediately instead of
+ * blocking for the D-Bus timeout. It closes again as soon as the service
+ * reappears on the bus, or when a probe call (let through once every
+ * RETRY_INTERVAL) succeeds. A probe whose reply isn't recorded within
+ * PROBE_TIMEOUT opens the breaker again.
+ */
+class CircuitBreaker
+{
+public:
+    /*
+     * Returns the breaker shared by all calls to \a service over \a connection.
+     */
+    static CircuitBreaker *forService(const QString &service, const QDBusConnection &connection);
+
+    /*
+     * Returns if a call may be sent to the service right now.
+     */
+    bool allowRequest();
+
+    /*
+     * Updates the breaker state with the \a reply of a call that was let through.
+     */
+    void recordReply(const QDBusMessage &reply);
+
+    /*
+     * Like recordReply() for a call that succeeded, for replies that didn't
+     * arrive through QtDBus.
+     */
+    void recordSuccess();
+
+    /*
+     * Updates the breaker for a call that was let through but never reached
+     * the service, e.g. because the deadline of the caller expired or the
+     * connection of the caller was lost. This doesn't say anything about the
+     * service, if the call was a probe the next call is let through instead.
+     */
+    void recordAborted();
+
+    /*
+     * Returns an error message to use as reply for rejected calls.
+     */
+    QDBusMessage unavailableError() const;
+
+    bool isOpen() const;
+
+    /*
+     * Returns a counter that changes whenever the service gets a new owner
+     * on the bus, e.g. because the daemon was restarted. Can be used to
+     * invalidate data cached from an earlier instance of the daemon.
+     */
+    int ownerGeneration() const;
+
+private:
+    CircuitBreaker(const QString &service, const QDBusConnection &connection);
+
+    enum State {
+        Closed,
+        Open,
+        HalfOpen,
+    };
+
+    void open();
+    void close();
+
+    // Number of consecutive timeouts after which the breaker opens
+    static constexpr int FAILURE_THRESHOLD = 2;
+    // Time in ms after which an open breaker lets a probe call through
+    static constexpr int RETRY_INTERVAL = 5000;
+    // Time in ms after which a probe call counts as lost, longer than the
+    // default D-Bus timeout
+    static constexpr int PROBE_TIMEOUT = 30000;
+
+    QString service;
+    QDBusServiceWatcher *watcher;
+
+    QAtomicInt state { Closed };
+    QAtomicInt consecutiveFailures { 0 };
+    QAtomicInteger<qint64> retryAt { 0 };
+    QAtomicInt generation { 0 };
+};
+
+}
+
+#endif // CIRCUITBREAKER_P_H
@@ -0,0 +1,372 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "compositemanager_p.h"
+#include "libopenrazer.h"
+#include "libopenrazer_private.h"
+
+#include <QDBusReply>
+#include <QSet>
+
+#include <memory>
+#include <optional>
+
+namespace libopenrazer {
+
+// The daemon of the backend isn't running, which is expected for one of them
+static bool isNotRunning(const Error &error)
+{
+    return error.type() == Error::ServiceUnavailable
+            || error.name() == QDBusError::errorString(QDBusError::ServiceUnknown)
+            || error.name() == QDBusError::errorString(QDBusError::NameHasNoOwner);
+}
+
+// Either the daemon isn't running or the backend doesn't implement the call, the other backends decide
+static bool isSkipped(const Error &error)
+{
+    return isNotRunning(error) || error.name() == QDBusError::errorString(QDBusError::NotSupported);
+}
+
+// Calls call on the backends in order until one of them is running and implements it
+template<typename T, typename Call>
+static Result<T> firstRunning(const QList<Manager *> &backends, Call call)
+{
+    Result<T> result = call(backends.first());
+    for (int i = 1; i < backends.size() && !result && isSkipped(result.error()); i++)
+        result = call(backends[i]);
+    return result;
+}
+
+// Calls call on all backends, returns the first error of a running daemon that implements it
+template<typename Call>
+static Result<void> allRunning(const QList<Manager *> &backends, Call call)
+{
+    Result<void> failure;
+    std::optional<Error> notRunning;
+    bool running = false;
+    for (Manager *backend : backends) {
+        Result<void> result = call(backend);
+        if (!result && isSkipped(result.error())) {
+            if (!notRunning)
+                notRunning = result.error();
+            continue;
+        }
+        running = true;
+        if (!result && failure)
+            failure = result;
+    }
+    if (!running)
+        return *notRunning;
+    return failure;
+}
+
+// The most useful status to show, e.g. one enabled daemon is enough
+static DaemonStatus combineStatus(const QList<DaemonStatus> &statuses)
+{
+    for (DaemonStatus status : { DaemonStatus::Enabled, DaemonStatus::Disabled, DaemonStatus::NoSystemd, DaemonStatus::Unknown }) {
+        if (statuses.contains(status))
+            return status;
+    }
+    return DaemonStatus::NotInstalled;
+}
+
+CompositeManager::CompositeManager()
+{
+    d = new CompositeManagerPrivate();
+    for (Manager *backend : { static_cast<Manager *>(new openrazer::Manager()), static_cast<Manager *>(new razer_test::Manager()) }) {
+        backend->setParent(this);
+        d->backends.append(backend);
+    }
+}
+
+CompositeManager::~CompositeManager()
+{
+    delete d;
+}
+
+Manager *CompositeManager::managerFor(const QDBusObjectPath &objectPath)
+{
+    if (!d->owners.contains(objectPath.path()))
+        tryGetDevices();
+    return d->owners.value(objectPath.path());
+}
+
+QList<Manager *> CompositeManager::backends() const
+{
+    return d->backends;
+}
+
+Result<QList<QDBusObjectPath>> CompositeManager::tryGetDevices()
+{
+    // Ask all daemons before waiting for the first answer
+    QList<DBusCommand> commands;
+    QList<Manager *> asked;
+    for (Manager *backend : std::as_const(d->backends)) {
+        Result<DBusCommand> command = backend->prepareGetDevices();
+        if (!command)
+            continue;
+        commands.append(command.value());
+        asked.append(backend);
+    }
+    if (commands.isEmpty())
+        return notSupportedError("None of the backends can list its devices.");
+    QList<QDBusMessage> replies = sendDBusCommands(commands);
+
+    QList<QPair<Manager *, QDBusObjectPath>> listed;
+    std::optional<Error> failure;
+    bool listedAny = false;
+    for (int i = 0; i < replies.size(); i++) {
+        Result<QList<QDBusObjectPath>> objectPaths = asked[i]->parseDevices(replies[i]);
+        if (!objectPaths) {
+            // Keep the error of a running daemon over the one of a missing daemon
+            if (!failure || (isNotRunning(*failure) && !isNotRunning(objectPaths.error())))
+                failure = objectPaths.error();
+            continue;
+        }
+        listedAny = true;
+        for (const QDBusObjectPath &objectPath : objectPaths.value())
+            listed.append({ asked[i], objectPath });
+    }
+    if (!listedAny)
+        return *failure;
+    if (failure && !isNotRunning(*failure))
+        printDBusError(lcManager(), *failure, Q_FUNC_INFO);
+
+    // Only new devices need to be asked for their serial
+    commands.clear();
+    QStringList unknown;
+    for (const auto &[backend, objectPath] : std::as_const(listed)) {
+        if (d->serials.contains(objectPath.path()))
+            continue;
+        Result<DBusCommand> command = backend->prepareGetSerial(objectPath);
+        if (!command)
+            continue;
+        commands.append(command.value());
+        unknown.append(objectPath.path());
+    }
+    replies = sendDBusCommands(commands);
+    for (int i = 0; i < replies.size(); i++) {
+        QDBusReply<QString> reply = replies[i];
+        if (reply.isValid())
+            d->serials.insert(unknown[i], reply.value());
+    }
+
+    // The backends are in the order of preference, so the first one listing a serial keeps the device
+    QList<QDBusObjectPath> devices;
+    QHash<QString, Manager *> owners;
+    QHash<QString, QString> serials;
+    QSet<QString> seenSerials;
+    for (const auto &[backend, objectPath] : std::as_const(listed)) {
+        QString serial = d->serials.value(objectPath.path());
+        if (!serial.isEmpty()) {
+            serials.insert(objectPath.path(), serial);
+            if (seenSerials.contains(serial))
+                continue;
+            seenSerials.insert(serial);
+        }
+        owners.insert(objectPath.path(), backend);
+        devices.append(objectPath);
+    }
+    d->owners = owners;
+    d->serials = serials;
+    return devices;
+}
+
+// The backend that owns the device and its serial, see tryGetDevices()
+QString CompositeManager::deviceIdentity(const QDBusObjectPath &objectPath)
+{
+    Manager *owner = d->owners.value(objectPath.path());
+    return QString("%1:%2").arg(d->backends.indexOf(owner)).arg(d->serials.value(objectPath.path()));
+}
+
+Device *CompositeManager::getDevice(QDBusObjectPath objectPath)
+{
+    Manager *backend = managerFor(objectPath);
+    if (backend == nullptr)
+        backend = d->backends.first();
+    return backend->getDevice(objectPath);
+}
+
+QList<Device *> CompositeManager::openAllDevices()
+{
+    QList<QDBusObjectPath> objectPaths = getDevices();
+    QHash<Manager *, QList<QDBusObjectPath>> owned;
+    for (const QDBusObjectPath &objectPath : objectPaths)
+        owned[d->owners.value(objectPath.path())].append(objectPath);
+
+    // Each backend sets up only the devices it owns, concurrently where it supports it
+    QList<Device *> devices;
+    for (Manager *backend : std::as_const(d->backends)) {
+        QList<QDBusObjectPath> paths = owned.value(backend);
+        if (!paths.isEmpty())
+            devices += backend->openDevices(paths);
+    }
+    return devices;
+}
+
+Result<QString> CompositeManager::tryGetDaemonVersion()
+{
+    return firstRunning<QString>(d->backends, [](Manager *backend) { return backend->tryGetDaemonVersion(); });
+}
+
+bool CompositeManager::isDaemonRunning()
+{
+    for (Manager *backend : std::as_const(d->backends)) {
+        if (backend->isDaemonRunning())
+            return true;
+    }
+    return false;
+}
+
+Result<DeviceCatalog> CompositeManager::tryGetDeviceCatalog()
+{
+    QList<DeviceCatalog> catalogs;
+    std::optional<Error> failure;
+    for (Manager *backend : std::as_const(d->backends)) {
+        Result<DeviceCatalog> catalog = backend->tryGetDeviceCatalog();
+        if (catalog)
+            catalogs.append(catalog.value());
+        else if (!failure)
+            failure = catalog.error();
+    }
+    if (catalogs.isEmpty())
+        return *failure;
+
+    QStringList versions;
+    for (const DeviceCatalog &catalog : std::as_const(catalogs))
+        versions.append(catalog.daemonVersion());
+    DeviceCatalog merged(versions.join(", "));
+    for (const DeviceCatalog &catalog : std::as_const(catalogs)) {
+        for (const SupportedDevice &device : catalog.devices()) {
+            if (merged.find(device.name) == nullptr)
+                merged.insert(device.name, device.vid, device.pid);
+        }
+    }
+    return merged;
+}
+
+Result<void> CompositeManager::trySyncEffects(bool yes)
+{
+    return allRunning(d->backends, [yes](Manager *backend) { return backend->trySyncEffects(yes); });
+}
+
+Result<bool> CompositeManager::tryGetSyncEffects()
+{
+    return firstRunning<bool>(d->backends, [](Manager *backend) { return backend->tryGetSyncEffects(); });
+}
+
+Result<void> CompositeManager::trySetTurnOffOnScreensaver(bool turnOffOnScreensaver)
+{
+    return allRunning(d->backends, [turnOffOnScreensaver](Manager *backend) { return backend->trySetTurnOffOnScreensaver(turnOffOnScreensaver); });
+}
+
+Result<bool> CompositeManager::tryGetTurnOffOnScreensaver()
+{
+    return firstRunning<bool>(d->backends, [](Manager *backend) { return backend->tryGetTurnOffOnScreensaver(); });
+}
+
+DaemonStatus CompositeManager::getDaemonStatus()
+{
+    QList<DaemonStatus> statuses;
+    for (Manager *backend : std::as_const(d->backends))
+        statuses.append(backend->getDaemonStatus());
+    return combineStatus(statuses);
+}
+
+void CompositeManager::getDaemonStatusAsync(QObject *context, const std::function<void(DaemonStatus status)> &callback)
+{
+    struct State {
+        QList<DaemonStatus> statuses;
+        int remaining;
+    };
+    auto state = std::make_shared<State>();
+    state->remaining = d->backends.size();
+    for (Manager *backend : std::as_const(d->backends)) {
+        backend->getDaemonStatusAsync(context, [state, callback](DaemonStatus status) {
+            state->statuses.append(status);
+            if (--state->remaining == 0)
+                callback(combineStatus(state->statuses));
+        });
+    }
+}
+
+QString CompositeManager::getDaemonStatusOutput()
+{
+    QStringList outputs;
+    for (Manager *backend : std::as_const(d->backends))
+        outputs.append(backend->getDaemonStatusOutput());
+    return outputs.join("\n");
+}
+
+// Enables the installed daemons, returns if at least one of them is enabled afterwards
+bool CompositeManager::enableDaemon()
+{
+    bool enabled = false;
+    for (Manager *backend : std::as_const(d->backends)) {
+        DaemonStatus status = backend->getDaemonStatus();
+        if (status == DaemonStatus::Enabled)
+            enabled = true;
+        else if (status == DaemonStatus::Disabled)
+            enabled |= backend->enableDaemon();
+    }
+    return enabled;
+}
+
+void CompositeManager::enableDaemonAsync(QObject *context, const std::function<void(bool success)> &callback)
+{
+    struct State {
+        bool enabled = false;
+        int remaining;
+    };
+    auto state = std::make_shared<State>();
+    state->remaining = d->backends.size();
+    auto finish = [state, callback](bool enabled) {
+        state->enabled |= enabled;
+        if (--state->remaining == 0)
+            callback(state->enabled);
+    };
+    for (Manager *backend : std::as_const(d->backends)) {
+        backend->getDaemonStatusAsync(context, [backend, context, finish](DaemonStatus status) {
+            if (status == DaemonStatus::Disabled)
+                backend->enableDaemonAsync(context, finish);
+            else
+                finish(status == DaemonStatus::Enabled);
+        });
+    }
+}
+
+bool CompositeManager::connectDevicesChanged(QObject *receiver, const char *slot)
+{
+    bool connected = false;
+    for (Manager *backend : std::as_const(d->backends))
+        connected |= backend->connectDevicesChanged(receiver, slot);
+    return connected;
+}
+
+QDBusServiceWatcher *CompositeManager::getServiceWatcher()
+{
+    // The daemons can be on different buses, forward the signals of the other watchers through the first one
+    QDBusServiceWatcher *watcher = d->backends.first()->getServiceWatcher();
+    for (int i = 1; i < d->backends.size(); i++) {
+        QDBusServiceWatcher *other = d->backends[i]->getServiceWatcher();
+        other->setParent(watcher);
+        connect(other, &QDBusServiceWatcher::serviceRegistered, watcher, &QDBusServiceWatcher::serviceRegistered);
+        connect(other, &QDBusServiceWatcher::serviceUnregistered, watcher, &QDBusServiceWatcher::serviceUnregistered);
+        connect(other, &QDBusServiceWatcher::serviceOwnerChanged, watcher, &QDBusServiceWatcher::serviceOwnerChanged);
+    }
+    return watcher;
+}
+
+void CompositeManager::setDefaultTimeout(int msecs)
+{
+    for (Manager *backend : std::as_const(d->backends))
+        backend->setDefaultTimeout(msecs);
+}
+
+int CompositeManager::defaultTimeout()
+{
+    return d->backends.first()->defaultTimeout();
+}
+
+}
@@ -0,0 +1,27 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef COMPOSITEMANAGER_P_H
+#define COMPOSITEMANAGER_P_H
+
+#include "libopenrazer/manager.h"
+
+#include <QHash>
+
+namespace libopenrazer {
+
+class CompositeManagerPrivate
+{
+public:
+    // In the order of preference for devices handled by more than one daemon
+    QList<Manager *> backends;
+    // The backend that listed each device, see CompositeManager::tryGetDevices()
+    QHash<QString, Manager *> owners;
+    // The serial of an object path never changes, so each is only asked for once
+    QHash<QString, QString> serials;
+};
+
+}
+
+#endif // COMPOSITEMANAGER_P_H
@@ -41,4 +41,24 @@ QString DBusException::message() const
     return m_message;
 }
 
+void ServiceUnavailableException::raise() const
+{
+    throw *this;
+}
+
+ServiceUnavailableException *ServiceUnavailableException::clone() const
+{
+    return new ServiceUnavailableException(*this);
+}
+
+void TimeoutException::raise() const
+{
+    throw *this;
+}
+
+TimeoutException *TimeoutException::clone() const
+{
+    return new TimeoutException(*this);
+}
+
 }
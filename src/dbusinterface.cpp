@@ -0,0 +1,236 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dbusinterface_p.h"
+#include "libopenrazer/deadline.h"
+
+#include <QDBusError>
+#include <QDBusPendingCall>
+#include <QDBusPendingCallWatcher>
+#include <QHash>
+#include <QPointer>
+
+#include <memory>
+
+namespace libopenrazer {
+
+static QDBusMessage deadlineExceededError(const QDBusMessage &message)
+{
+    return QDBusMessage::createError(DEADLINE_EXCEEDED_ERROR,
+                                     QString("The deadline expired before %1.%2 finished").arg(message.interface(), message.member()));
+}
+
+bool applyDeadline(int *timeout, bool *limitedByDeadline)
+{
+    *limitedByDeadline = false;
+    QDeadlineTimer deadline = Deadline::current();
+    if (!deadline.isForever()) {
+        qint64 remaining = deadline.remainingTime();
+        if (remaining <= 0)
+            return false;
+        // A negative timeout means the default timeout of QtDBus (25 seconds)
+        if (remaining < (*timeout < 0 ? 25000 : *timeout)) {
+            *timeout = static_cast<int>(remaining);
+            *limitedByDeadline = true;
+        }
+    }
+    return true;
+}
+
+static void finishReply(CircuitBreaker *breaker, const QDBusMessage &message, QDBusMessage *reply, bool limitedByDeadline)
+{
+    if (limitedByDeadline && reply->type() == QDBusMessage::ErrorMessage && QDBusError(*reply).type() == QDBusError::NoReply)
+        *reply = deadlineExceededError(message);
+    if (breaker != nullptr)
+        breaker->recordReply(*reply);
+}
+
+QDBusMessage sendDBusMessage(CircuitBreaker *breaker, const QDBusConnection &connection, const QDBusMessage &message, int timeout)
+{
+    bool limitedByDeadline;
+    if (!applyDeadline(&timeout, &limitedByDeadline))
+        return deadlineExceededError(message);
+
+    if (breaker != nullptr && !breaker->allowRequest())
+        return breaker->unavailableError();
+
+    QDBusMessage reply = connection.call(message, QDBus::Block, timeout);
+    finishReply(breaker, message, &reply, limitedByDeadline);
+    return reply;
+}
+
+QList<QDBusMessage> sendDBusMessages(CircuitBreaker *breaker, const QDBusConnection &connection, const QList<QDBusMessage> &messages, int timeout)
+{
+    QList<QDBusMessage> replies;
+    replies.reserve(messages.size());
+
+    bool limitedByDeadline;
+    if (!applyDeadline(&timeout, &limitedByDeadline)) {
+        for (const QDBusMessage &message : messages)
+            replies.append(deadlineExceededError(message));
+        return replies;
+    }
+
+    if (breaker != nullptr && !breaker->allowRequest()) {
+        for (int i = 0; i < messages.size(); i++)
+            replies.append(breaker->unavailableError());
+        return replies;
+    }
+
+    QList<QDBusPendingCall> calls;
+    calls.reserve(messages.size());
+    for (const QDBusMessage &message : messages)
+        calls.append(connection.asyncCall(message, timeout));
+
+    for (int i = 0; i < calls.size(); i++) {
+        calls[i].waitForFinished();
+        QDBusMessage reply = calls[i].reply();
+        finishReply(breaker, messages[i], &reply, limitedByDeadline);
+        replies.append(reply);
+    }
+    return replies;
+}
+
+QList<QDBusMessage> sendDBusCommands(const QList<DBusCommand> &commands)
+{
+    struct PendingCommand {
+        int index;
+        CircuitBreaker *breaker;
+        bool limitedByDeadline;
+        QDBusPendingCall call;
+    };
+
+    QList<QDBusMessage> replies(commands.size());
+    QList<PendingCommand> pending;
+    pending.reserve(commands.size());
+    // Ask each breaker only once, a half-open breaker lets a single request through
+    QHash<CircuitBreaker *, bool> allowed;
+
+    for (int i = 0; i < commands.size(); i++) {
+        const DBusCommand &command = commands[i];
+        int timeout = command.timeout;
+        bool limitedByDeadline;
+        if (!applyDeadline(&timeout, &limitedByDeadline)) {
+            replies[i] = deadlineExceededError(command.message);
+            continue;
+        }
+
+        CircuitBreaker *breaker = CircuitBreaker::forService(command.message.service(), command.connection);
+        auto it = allowed.constFind(breaker);
+        if (it == allowed.constEnd())
+            it = allowed.insert(breaker, breaker->allowRequest());
+        if (!it.value()) {
+            replies[i] = breaker->unavailableError();
+            continue;
+        }
+
+        pending.append({ i, breaker, limitedByDeadline, command.connection.asyncCall(command.message, timeout) });
+    }
+
+    for (PendingCommand &command : pending) {
+        command.call.waitForFinished();
+        QDBusMessage reply = command.call.reply();
+        finishReply(command.breaker, commands[command.index].message, &reply, command.limitedByDeadline);
+        replies[command.index] = reply;
+    }
+    return replies;
+}
+
+void sendDBusCommandsAsync(const QList<DBusCommand> &commands, QObject *context,
+                           const std::function<void(const QList<QDBusMessage> &replies)> &callback)
+{
+    struct Batch {
+        QList<QDBusMessage> replies;
+        int remaining;
+        QPointer<QObject> context;
+        std::function<void(const QList<QDBusMessage> &replies)> callback;
+    };
+    auto batch = std::make_shared<Batch>();
+    batch->replies.resize(commands.size());
+    batch->remaining = commands.size();
+    batch->context = context;
+    batch->callback = callback;
+
+    QHash<CircuitBreaker *, bool> allowed;
+    for (int i = 0; i < commands.size(); i++) {
+        const DBusCommand &command = commands[i];
+        CircuitBreaker *breaker = CircuitBreaker::forService(command.message.service(), command.connection);
+        auto it = allowed.constFind(breaker);
+        if (it == allowed.constEnd())
+            it = allowed.insert(breaker, breaker->allowRequest());
+        if (!it.value()) {
+            batch->replies[i] = breaker->unavailableError();
+            batch->remaining--;
+            continue;
+        }
+
+        // Not tied to the context, the breaker has to learn about the reply
+        // even if nobody is interested in it anymore
+        auto *watcher = new QDBusPendingCallWatcher(command.connection.asyncCall(command.message, command.timeout));
+        QObject::connect(watcher, &QDBusPendingCallWatcher::finished, watcher, [batch, breaker, i](QDBusPendingCallWatcher *watcher) {
+            QDBusMessage reply = watcher->reply();
+            breaker->recordReply(reply);
+            batch->replies[i] = reply;
+            watcher->deleteLater();
+            if (--batch->remaining == 0 && !batch->context.isNull())
+                batch->callback(batch->replies);
+        });
+    }
+
+    // Nothing was sent, still don't call back before returning
+    if (batch->remaining == 0)
+        QMetaObject::invokeMethod(context, [batch]() { batch->callback(batch->replies); }, Qt::QueuedConnection);
+}
+
+DBusInterface::DBusInterface(const QString &service, const QString &path, const QString &interface,
+                             const QDBusConnection &connection, QObject *parent)
+    : QDBusAbstractInterface(service, path, interface.toLatin1().constData(), connection, parent),
+      breaker(CircuitBreaker::forService(service, connection))
+{
+}
+
+QDBusMessage DBusInterface::callWithArgumentList(const QString &method, const QList<QVariant> &args)
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(service(), path(), interface(), method);
+    message.setArguments(args);
+    return send(message);
+}
+
+DBusCommand DBusInterface::prepareCall(const QString &method, const QList<QVariant> &args)
+{
+    DBusCommand command;
+    command.message = QDBusMessage::createMethodCall(service(), path(), interface(), method);
+    command.message.setArguments(args);
+    command.connection = connection();
+    command.timeout = timeout();
+    return command;
+}
+
+QDBusMessage DBusInterface::getProperty(const char *name)
+{
+    return send(propertyMessage(name));
+}
+
+DBusCommand DBusInterface::prepareGetProperty(const char *name)
+{
+    DBusCommand command;
+    command.message = propertyMessage(name);
+    command.connection = connection();
+    command.timeout = timeout();
+    return command;
+}
+
+QDBusMessage DBusInterface::propertyMessage(const char *name)
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(service(), path(), "org.freedesktop.DBus.Properties", "Get");
+    message << interface() << QString::fromLatin1(name);
+    return message;
+}
+
+QDBusMessage DBusInterface::send(const QDBusMessage &message)
+{
+    return sendDBusMessage(breaker, connection(), message, timeout());
+}
+
+}
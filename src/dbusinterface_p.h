@@ -0,0 +1,121 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DBUSINTERFACE_P_H
+#define DBUSINTERFACE_P_H
+
+#include "circuitbreaker_p.h"
+
+#include <QDBusAbstractInterface>
+#include <QDBusMessage>
+
+#include <functional>
+
+namespace libopenrazer {
+
+/*
+ * Shortens \a timeout to what's left of the current Deadline and sets
+ * \a limitedByDeadline if the Deadline is what limits the call. Returns false
+ * if the Deadline has already passed.
+ */
+bool applyDeadline(int *timeout, bool *limitedByDeadline);
+
+/*
+ * Sends \a message over \a connection and waits for the reply.
+ *
+ * All calls to the daemons go through here. The call is rejected without
+ * sending anything if \a breaker is open or the current Deadline has passed,
+ * and \a timeout is shortened to what's left of the current Deadline.
+ * \a breaker can be nullptr for connections without one, see PeerConnection.
+ */
+QDBusMessage sendDBusMessage(CircuitBreaker *breaker, const QDBusConnection &connection, const QDBusMessage &message, int timeout = -1);
+
+/*
+ * Like sendDBusMessage(), but sends all \a messages before waiting for the
+ * first reply, so the daemon can work on them concurrently. Returns the
+ * replies in the order of \a messages.
+ */
+QList<QDBusMessage> sendDBusMessages(CircuitBreaker *breaker, const QDBusConnection &connection, const QList<QDBusMessage> &messages, int timeout = -1);
+
+/*
+ * A method call that has been prepared but not sent yet, see
+ * DBusInterface::prepareCall().
+ */
+struct DBusCommand {
+    QDBusMessage message;
+    QDBusConnection connection = QDBusConnection(QString());
+    int timeout = -1;
+};
+
+/*
+ * Like sendDBusMessages(), but the \a commands can go to different services
+ * and connections. Each command is checked against the circuit breaker of its
+ * service. Returns the replies in the order of \a commands.
+ */
+QList<QDBusMessage> sendDBusCommands(const QList<DBusCommand> &commands);
+
+/*
+ * Like sendDBusCommands(), but returns right away. \a callback is called in
+ * the thread of \a context with the replies once all of them have arrived,
+ * unless \a context has been destroyed by then. The replies are recorded by
+ * the circuit breakers either way. The current Deadline is not applied.
+ */
+void sendDBusCommandsAsync(const QList<DBusCommand> &commands, QObject *context,
+                           const std::function<void(const QList<QDBusMessage> &replies)> &callback);
+
+/*
+ * Lightweight replacement for QDBusInterface.
+ *
+ * Unlike QDBusInterface this doesn't introspect the remote object on
+ * construction, and every call goes through sendDBusMessage() so calls fail
+ * fast while the daemon is unavailable and respect the current Deadline.
+ * Rejected calls return an error message with the SERVICE_UNAVAILABLE_ERROR or
+ * DEADLINE_EXCEEDED_ERROR name. The timeout() of the interface is used as
+ * default timeout for its calls.
+ */
+class DBusInterface : public QDBusAbstractInterface
+{
+public:
+    DBusInterface(const QString &service, const QString &path, const QString &interface,
+                  const QDBusConnection &connection, QObject *parent);
+
+    template<typename... Args>
+    QDBusMessage call(const QString &method, Args &&...args)
+    {
+        return callWithArgumentList(method, { QVariant(std::forward<Args>(args))... });
+    }
+
+    QDBusMessage callWithArgumentList(const QString &method, const QList<QVariant> &args);
+
+    /*
+     * Returns the call of \a method with \a args without sending it, to be
+     * sent with sendDBusCommands().
+     */
+    DBusCommand prepareCall(const QString &method, const QList<QVariant> &args = {});
+
+    /*
+     * Reads the property \a name using org.freedesktop.DBus.Properties.
+     *
+     * Meant to be used with QDBusReply<QVariant>, see variantToResult().
+     */
+    QDBusMessage getProperty(const char *name);
+
+    /*
+     * Returns the read of the property \a name without sending it, see
+     * prepareCall().
+     */
+    DBusCommand prepareGetProperty(const char *name);
+
+    CircuitBreaker *circuitBreaker() const { return breaker; }
+
+private:
+    QDBusMessage send(const QDBusMessage &message);
+    QDBusMessage propertyMessage(const char *name);
+
+    CircuitBreaker *breaker;
+};
+
+}
+
+#endif // DBUSINTERFACE_P_H
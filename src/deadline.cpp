@@ -0,0 +1,36 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "libopenrazer/deadline.h"
+
+namespace libopenrazer {
+
+static thread_local Deadline *currentDeadline = nullptr;
+
+Deadline::Deadline(int msecs)
+    : Deadline(QDeadlineTimer(msecs, Qt::PreciseTimer))
+{
+}
+
+Deadline::Deadline(QDeadlineTimer timer)
+    : m_timer(timer), m_outer(currentDeadline)
+{
+    if (m_outer != nullptr && m_outer->m_timer < m_timer)
+        m_timer = m_outer->m_timer;
+    currentDeadline = this;
+}
+
+Deadline::~Deadline()
+{
+    currentDeadline = m_outer;
+}
+
+QDeadlineTimer Deadline::current()
+{
+    if (currentDeadline == nullptr)
+        return QDeadlineTimer(QDeadlineTimer::Forever);
+    return currentDeadline->m_timer;
+}
+
+}
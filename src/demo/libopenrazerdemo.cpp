@@ -85,13 +85,15 @@ int main(int argc, char *argv[])
 
     QCommandLineParser parser;
     parser.addHelpOption();
-    parser.addOption({ "backend", "libopenrazer backend to use (openrazer/razer_test)", "backend" });
+    parser.addOption({ "backend", "libopenrazer backend to use (openrazer/razer_test), detected if not given", "backend" });
     parser.process(app);
 
     QString chosenBackend = parser.value("backend");
 
     libopenrazer::Manager *manager;
-    if (chosenBackend == "" || chosenBackend == "openrazer") {
+    if (chosenBackend == "") {
+        manager = libopenrazer::Manager::createForRunningDaemon();
+    } else if (chosenBackend == "openrazer") {
         manager = new libopenrazer::openrazer::Manager();
     } else if (chosenBackend == "razer_test") {
         manager = new libopenrazer::razer_test::Manager();
@@ -118,15 +120,16 @@ int main(int argc, char *argv[])
         qDebug() << "Device mode:" << device->getDeviceMode();
         qDebug() << "Device type:" << device->getDeviceType();
         qDebug() << "Device image:" << device->getDeviceImageUrl();
+        libopenrazer::Features features = device->features();
 
-        if (device->hasFeature("keyboard_layout")) {
+        if (features.testFlag(libopenrazer::Feature::KeyboardLayout)) {
             qDebug() << "Keyboard layout:" << device->getKeyboardLayout();
         }
 
-        if (device->hasFeature("dpi")) {
+        if (features.testFlag(libopenrazer::Feature::DPI)) {
             openrazer::DPI dpi = device->getDPI();
             qDebug() << "DPI:" << dpi;
-            if (device->hasFeature("restricted_dpi")) {
+            if (features.testFlag(libopenrazer::Feature::RestrictedDPI)) {
                 QVector<ushort> allowedDPI = device->getAllowedDPI();
                 qDebug() << "Allowed DPI:" << allowedDPI;
                 device->setDPI({ allowedDPI.first(), 0 });
@@ -134,7 +137,7 @@ int main(int argc, char *argv[])
             } else {
                 device->setDPI({ 500, 500 });
             }
-            if (device->hasFeature("dpi_stages")) {
+            if (features.testFlag(libopenrazer::Feature::DPIStages)) {
                 QPair<uchar, QVector<openrazer::DPI>> dpiStages = device->getDPIStages();
                 qDebug() << "DPI stages:" << dpiStages;
                 device->setDPIStages(2, { { 400, 500 }, { 600, 700 }, { 800, 900 } });
@@ -146,7 +149,7 @@ int main(int argc, char *argv[])
             device->setDPI(dpi);
         }
 
-        if (device->hasFeature("poll_rate")) {
+        if (features.testFlag(libopenrazer::Feature::PollRate)) {
             ushort poll_rate = device->getPollRate();
             qDebug() << "Poll rate:" << poll_rate;
             QVector<ushort> supportedPollRates = device->getSupportedPollRates();
@@ -157,16 +160,16 @@ int main(int argc, char *argv[])
             device->setPollRate(poll_rate);
         }
 
-        if (device->hasFeature("custom_frame")) {
+        if (features.testFlag(libopenrazer::Feature::CustomFrame)) {
             qDebug() << "Matrix dimensions:" << device->getMatrixDimensions();
         }
 
-        if (device->hasFeature("battery")) {
+        if (features.testFlag(libopenrazer::Feature::Battery)) {
             qDebug() << "Battery:" << device->getBatteryPercent() << "%";
             qDebug() << "Charging:" << device->isCharging();
         }
 
-        if (device->hasFeature("low_battery_threshold")) {
+        if (features.testFlag(libopenrazer::Feature::LowBatteryThreshold)) {
             double threshold = device->getLowBatteryThreshold();
             qDebug() << "Low battery threshold:" << threshold << "%";
             device->setLowBatteryThreshold(50);
@@ -174,7 +177,7 @@ int main(int argc, char *argv[])
             device->setLowBatteryThreshold(threshold);
         }
 
-        if (device->hasFeature("idle_time")) {
+        if (features.testFlag(libopenrazer::Feature::IdleTime)) {
             ushort idleTime = device->getIdleTime();
             qDebug() << "Idle time:" << idleTime << "seconds";
             device->setIdleTime(900);
@@ -0,0 +1,256 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "libopenrazer.h"
+#include "libopenrazer_private.h"
+#include "writecache_p.h"
+
+namespace libopenrazer {
+
+namespace {
+struct FeatureName {
+    const char *name;
+    Feature feature;
+};
+// The names used by hasFeature(const QString &) and the SupportedFeatures property of razer_test
+constexpr FeatureName FEATURE_NAMES[] = {
+    { "keyboard_layout", Feature::KeyboardLayout },
+    { "dpi", Feature::DPI },
+    { "restricted_dpi", Feature::RestrictedDPI },
+    { "dpi_stages", Feature::DPIStages },
+    { "poll_rate", Feature::PollRate },
+    { "custom_frame", Feature::CustomFrame },
+    { "battery", Feature::Battery },
+    { "low_battery_threshold", Feature::LowBatteryThreshold },
+    { "idle_time", Feature::IdleTime },
+};
+}
+
+Features featuresFromStrings(const QStringList &featureStrs)
+{
+    Features features;
+    for (const FeatureName &entry : FEATURE_NAMES) {
+        if (featureStrs.contains(QLatin1String(entry.name)))
+            features |= entry.feature;
+    }
+    return features;
+}
+
+Device::~Device()
+{
+    delete m_writeCache;
+}
+
+void Device::setWriteCacheEnabled(bool enabled)
+{
+    if (m_writeCache == nullptr) {
+        if (!enabled)
+            return;
+        m_writeCache = new WriteCache();
+    }
+    m_writeCache->setEnabled(enabled);
+    for (Led *led : getLeds())
+        led->setWriteCacheEnabled(enabled);
+}
+
+bool Device::isWriteCacheEnabled() const
+{
+    return m_writeCache != nullptr && m_writeCache->isEnabled();
+}
+
+void Device::clearWriteCache()
+{
+    if (m_writeCache != nullptr)
+        m_writeCache->clear();
+    for (Led *led : getLeds())
+        led->clearWriteCache();
+}
+
+quint64 Device::getElidedWrites()
+{
+    quint64 elided = m_writeCache != nullptr ? m_writeCache->elidedWrites() : 0;
+    for (Led *led : getLeds())
+        elided += led->getElidedWrites();
+    return elided;
+}
+
+bool Device::hasFeature(Feature feature)
+{
+    return features().testFlag(feature);
+}
+
+bool Device::hasFeature(const QString &featureStr)
+{
+    for (const FeatureName &entry : FEATURE_NAMES) {
+        if (featureStr == QLatin1String(entry.name))
+            return hasFeature(entry.feature);
+    }
+    return false;
+}
+
+QString Device::getDeviceImageUrl()
+{
+    return unwrap(tryGetDeviceImageUrl(), lcDevice(), Q_FUNC_INFO, objectPath());
+}
+
+QString Device::getDeviceMode()
+{
+    return unwrap(tryGetDeviceMode(), lcDevice(), Q_FUNC_INFO, objectPath());
+}
+
+QString Device::getSerial()
+{
+    return unwrap(tryGetSerial(), lcDevice(), Q_FUNC_INFO, objectPath());
+}
+
+QString Device::getDeviceName()
+{
+    return unwrap(tryGetDeviceName(), lcDevice(), Q_FUNC_INFO, objectPath());
+}
+
+QString Device::getDeviceType()
+{
+    return unwrap(tryGetDeviceType(), lcDevice(), Q_FUNC_INFO, objectPath());
+}
+
+QString Device::getFirmwareVersion()
+{
+    return unwrap(tryGetFirmwareVersion(), lcDevice(), Q_FUNC_INFO, objectPath());
+}
+
+QString Device::getKeyboardLayout()
+{
+    return unwrap(tryGetKeyboardLayout(), lcDevice(), Q_FUNC_INFO, objectPath());
+}
+
+ushort Device::getPollRate()
+{
+    return unwrap(tryGetPollRate(), lcDevice(), Q_FUNC_INFO, objectPath());
+}
+
+void Device::setPollRate(ushort pollrate)
+{
+    unwrap(trySetPollRate(pollrate), lcDevice(), Q_FUNC_INFO, objectPath());
+}
+
+QVector<ushort> Device::getSupportedPollRates()
+{
+    return unwrap(tryGetSupportedPollRates(), lcDevice(), Q_FUNC_INFO, objectPath());
+}
+
+void Device::setDPI(::openrazer::DPI dpi)
+{
+    unwrap(trySetDPI(dpi), lcDevice(), Q_FUNC_INFO, objectPath());
+}
+
+::openrazer::DPI Device::getDPI()
+{
+    return unwrap(tryGetDPI(), lcDevice(), Q_FUNC_INFO, objectPath());
+}
+
+void Device::setDPIStages(uchar activeStage, QVector<::openrazer::DPI> dpiStages)
+{
+    unwrap(trySetDPIStages(activeStage, dpiStages), lcDevice(), Q_FUNC_INFO, objectPath());
+}
+
+QPair<uchar, QVector<::openrazer::DPI>> Device::getDPIStages()
+{
+    return unwrap(tryGetDPIStages(), lcDevice(), Q_FUNC_INFO, objectPath());
+}
+
+ushort Device::maxDPI()
+{
+    return unwrap(tryMaxDPI(), lcDevice(), Q_FUNC_INFO, objectPath());
+}
+
+QVector<ushort> Device::getAllowedDPI()
+{
+    return unwrap(tryGetAllowedDPI(), lcDevice(), Q_FUNC_INFO, objectPath());
+}
+
+double Device::getBatteryPercent()
+{
+    return unwrap(tryGetBatteryPercent(), lcDevice(), Q_FUNC_INFO, objectPath());
+}
+
+bool Device::isCharging()
+{
+    return unwrap(tryIsCharging(), lcDevice(), Q_FUNC_INFO, objectPath());
+}
+
+ushort Device::getIdleTime()
+{
+    return unwrap(tryGetIdleTime(), lcDevice(), Q_FUNC_INFO, objectPath());
+}
+
+void Device::setIdleTime(ushort idleTime)
+{
+    unwrap(trySetIdleTime(idleTime), lcDevice(), Q_FUNC_INFO, objectPath());
+}
+
+double Device::getLowBatteryThreshold()
+{
+    return unwrap(tryGetLowBatteryThreshold(), lcDevice(), Q_FUNC_INFO, objectPath());
+}
+
+void Device::setLowBatteryThreshold(double threshold)
+{
+    unwrap(trySetLowBatteryThreshold(threshold), lcDevice(), Q_FUNC_INFO, objectPath());
+}
+
+void Device::displayCustomFrame()
+{
+    unwrap(tryDisplayCustomFrame(), lcDevice(), Q_FUNC_INFO, objectPath());
+}
+
+void Device::defineCustomFrame(uchar row, uchar startColumn, uchar endColumn, QVector<::openrazer::RGB> colorData)
+{
+    unwrap(tryDefineCustomFrame(row, startColumn, endColumn, colorData), lcDevice(), Q_FUNC_INFO, objectPath());
+}
+
+::openrazer::MatrixDimensions Device::getMatrixDimensions()
+{
+    return unwrap(tryGetMatrixDimensions(), lcDevice(), Q_FUNC_INFO, objectPath());
+}
+
+Result<DBusCommand> Device::prepareSetPollRate(ushort pollrate)
+{
+    Q_UNUSED(pollrate);
+    return notSupportedError("Preparing calls is not supported by this device.");
+}
+
+Result<DBusCommand> Device::prepareSetDPI(::openrazer::DPI dpi)
+{
+    Q_UNUSED(dpi);
+    return notSupportedError("Preparing calls is not supported by this device.");
+}
+
+Result<DBusCommand> Device::prepareSetDPIStages(uchar activeStage, QVector<::openrazer::DPI> dpiStages)
+{
+    Q_UNUSED(activeStage);
+    Q_UNUSED(dpiStages);
+    return notSupportedError("Preparing calls is not supported by this device.");
+}
+
+Result<DBusCommand> Device::prepareGetSerial()
+{
+    return notSupportedError("Preparing calls is not supported by this device.");
+}
+
+Result<DBusCommand> Device::prepareGetBatteryPercent()
+{
+    return notSupportedError("Preparing calls is not supported by this device.");
+}
+
+Result<DBusCommand> Device::prepareIsCharging()
+{
+    return notSupportedError("Preparing calls is not supported by this device.");
+}
+
+Result<DBusCommand> Device::prepareGetLowBatteryThreshold()
+{
+    return notSupportedError("Preparing calls is not supported by this device.");
+}
+
+}
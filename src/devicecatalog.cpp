@@ -0,0 +1,167 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "devicecatalog_p.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+namespace libopenrazer {
+
+static constexpr quint32 FILE_MAGIC = 0x4c4f5344; // "LOSD"
+static constexpr quint32 FILE_VERSION = 1;
+
+DeviceCatalog::DeviceCatalog(const QString &daemonVersion)
+    : m_daemonVersion(daemonVersion)
+{
+}
+
+QString DeviceCatalog::daemonVersion() const
+{
+    return m_daemonVersion;
+}
+
+void DeviceCatalog::insert(const QString &name, ushort vid, ushort pid)
+{
+    QHash<QString, int>::const_iterator it = m_byName.constFind(name);
+    if (it != m_byName.constEnd()) {
+        SupportedDevice &device = m_devices[it.value()];
+        if (m_byId.value(idKey(device.vid, device.pid), -1) == it.value())
+            m_byId.remove(idKey(device.vid, device.pid));
+        device.vid = vid;
+        device.pid = pid;
+        if (!m_byId.contains(idKey(vid, pid)))
+            m_byId.insert(idKey(vid, pid), it.value());
+        return;
+    }
+
+    m_byName.insert(name, m_devices.size());
+    if (!m_byId.contains(idKey(vid, pid)))
+        m_byId.insert(idKey(vid, pid), m_devices.size());
+    m_devices.append({ name, vid, pid });
+}
+
+const QVector<SupportedDevice> &DeviceCatalog::devices() const
+{
+    return m_devices;
+}
+
+int DeviceCatalog::size() const
+{
+    return m_devices.size();
+}
+
+bool DeviceCatalog::isEmpty() const
+{
+    return m_devices.isEmpty();
+}
+
+const SupportedDevice *DeviceCatalog::find(ushort vid, ushort pid) const
+{
+    QHash<quint32, int>::const_iterator it = m_byId.constFind(idKey(vid, pid));
+    if (it == m_byId.constEnd())
+        return nullptr;
+    return &m_devices[it.value()];
+}
+
+const SupportedDevice *DeviceCatalog::find(const QString &name) const
+{
+    QHash<QString, int>::const_iterator it = m_byName.constFind(name);
+    if (it == m_byName.constEnd())
+        return nullptr;
+    return &m_devices[it.value()];
+}
+
+QVariantHash DeviceCatalog::toVariantHash() const
+{
+    QVariantHash hash;
+    hash.reserve(m_devices.size());
+    for (const SupportedDevice &device : m_devices)
+        hash.insert(device.name, QVariantList { double(device.vid), double(device.pid) });
+    return hash;
+}
+
+bool DeviceCatalog::save(const QString &fileName) const
+{
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << FILE_MAGIC << FILE_VERSION << m_daemonVersion << quint32(m_devices.size());
+    for (const SupportedDevice &device : m_devices)
+        stream << device.name << device.vid << device.pid;
+    return stream.status() == QDataStream::Ok && file.commit();
+}
+
+bool DeviceCatalog::load(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    quint32 magic, version, count;
+    QString daemonVersion;
+    stream >> magic >> version;
+    if (stream.status() != QDataStream::Ok || magic != FILE_MAGIC || version != FILE_VERSION)
+        return false;
+    stream >> daemonVersion >> count;
+
+    DeviceCatalog catalog(daemonVersion);
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; i++) {
+        SupportedDevice device;
+        stream >> device.name >> device.vid >> device.pid;
+        catalog.insert(device.name, device.vid, device.pid);
+    }
+    if (stream.status() != QDataStream::Ok)
+        return false;
+
+    *this = catalog;
+    return true;
+}
+
+Result<DeviceCatalog> DeviceCatalogCache::get(CircuitBreaker *breaker, const QString &fileName,
+                                              const std::function<Result<QString>()> &daemonVersion,
+                                              const std::function<Result<DeviceCatalog>(const QString &daemonVersion)> &fetch)
+{
+    // Read the generation before the calls, so a restart during them invalidates the result
+    int currentGeneration = breaker->ownerGeneration();
+    if (generation == currentGeneration)
+        return catalog;
+
+    Result<QString> version = daemonVersion();
+    if (!version)
+        return version.error();
+
+    if (catalog.daemonVersion() != version.value() || catalog.isEmpty()) {
+        DeviceCatalog stored;
+        if (!fileName.isEmpty() && stored.load(fileName) && stored.daemonVersion() == version.value()) {
+            catalog = stored;
+        } else {
+            Result<DeviceCatalog> fetched = fetch(version.value());
+            if (!fetched)
+                return fetched.error();
+            catalog = fetched.value();
+            if (!fileName.isEmpty()) {
+                QDir().mkpath(QFileInfo(fileName).path());
+                if (!catalog.save(fileName))
+                    qCWarning(lcManager, "libopenrazer: Failed to write device catalog %s", qUtf8Printable(fileName));
+            }
+        }
+    }
+
+    generation = currentGeneration;
+    return catalog;
+}
+
+void DeviceCatalogCache::invalidate()
+{
+    generation = -1;
+}
+
+}
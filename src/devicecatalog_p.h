@@ -0,0 +1,42 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DEVICECATALOG_P_H
+#define DEVICECATALOG_P_H
+
+#include "libopenrazer/devicecatalog.h"
+#include "libopenrazer/result.h"
+
+#include "circuitbreaker_p.h"
+#include "logging_p.h"
+
+#include <functional>
+
+namespace libopenrazer {
+
+/*
+ * The DeviceCatalog of a Manager, fetched once per daemon version.
+ *
+ * While the daemon keeps running the cached catalog is returned without any
+ * call. After it has been restarted only its version is asked for, the
+ * catalog is read from \a fileName (if set) or fetched again only if the
+ * version changed.
+ */
+class DeviceCatalogCache
+{
+public:
+    Result<DeviceCatalog> get(CircuitBreaker *breaker, const QString &fileName,
+                              const std::function<Result<QString>()> &daemonVersion,
+                              const std::function<Result<DeviceCatalog>(const QString &daemonVersion)> &fetch);
+    void invalidate();
+
+private:
+    DeviceCatalog catalog;
+    // Owner generation of the daemon the catalog was checked against
+    int generation = -1;
+};
+
+}
+
+#endif // DEVICECATALOG_P_H
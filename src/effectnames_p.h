@@ -0,0 +1,124 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef EFFECTNAMES_P_H
+#define EFFECTNAMES_P_H
+
+#include "libopenrazer/openrazer.h"
+
+#include <QLatin1String>
+#include <QString>
+
+#include <algorithm>
+#include <iterator>
+
+namespace libopenrazer {
+
+struct EffectName {
+    const char *name;
+    ::openrazer::Effect effect;
+};
+
+namespace effectnames {
+
+constexpr int compare(const char *a, const char *b)
+{
+    while (*a != '\0' && *a == *b) {
+        a++;
+        b++;
+    }
+    return static_cast<unsigned char>(*a) - static_cast<unsigned char>(*b);
+}
+
+template<size_t N>
+constexpr bool isSorted(const EffectName (&table)[N])
+{
+    for (size_t i = 1; i < N; i++) {
+        if (compare(table[i - 1].name, table[i].name) >= 0)
+            return false;
+    }
+    return true;
+}
+
+// Binary search in a table sorted by name
+template<size_t N>
+bool effectFromName(const EffectName (&table)[N], const QString &name, ::openrazer::Effect *effect)
+{
+    const EffectName *it = std::lower_bound(std::begin(table), std::end(table), name,
+                                            [](const EffectName &entry, const QString &name) { return QLatin1String(entry.name) < name; });
+    if (it == std::end(table) || QLatin1String(it->name) != name)
+        return false;
+    *effect = it->effect;
+    return true;
+}
+
+// Returns the first name of the effect in the table, or nullptr if the table doesn't have it
+template<size_t N>
+constexpr const char *nameFromEffect(const EffectName (&table)[N], ::openrazer::Effect effect)
+{
+    for (size_t i = 0; i < N; i++) {
+        if (table[i].effect == effect)
+            return table[i].name;
+    }
+    return nullptr;
+}
+
+}
+
+namespace openrazer {
+
+/*
+ * Effect names returned by get*Effect of the OpenRazer daemon, sorted by name.
+ * TODO:
+ * * breathTriple
+ * * starlightSingle
+ * * starlightDual
+ * * starlightRandom
+ */
+constexpr EffectName EFFECT_NAMES[] = {
+    { "blinking", ::openrazer::Effect::Blinking },
+    { "breathDual", ::openrazer::Effect::BreathingDual },
+    { "breathMono", ::openrazer::Effect::BreathingMono },
+    { "breathRandom", ::openrazer::Effect::BreathingRandom },
+    { "breathSingle", ::openrazer::Effect::Breathing },
+    { "none", ::openrazer::Effect::Off },
+    { "on", ::openrazer::Effect::On },
+    { "pulsate", ::openrazer::Effect::Breathing },
+    { "reactive", ::openrazer::Effect::Reactive },
+    { "ripple", ::openrazer::Effect::Ripple },
+    { "rippleRandomColour", ::openrazer::Effect::RippleRandom },
+    { "spectrum", ::openrazer::Effect::Spectrum },
+    { "static", ::openrazer::Effect::Static },
+    { "wave", ::openrazer::Effect::Wave },
+    { "wheel", ::openrazer::Effect::Wheel },
+};
+static_assert(effectnames::isSorted(EFFECT_NAMES), "EFFECT_NAMES must be sorted by name");
+
+}
+
+namespace razer_test {
+
+/*
+ * Effect names in the SupportedFx property of razer_test, sorted by name.
+ * TODO: Wheel, BreathingMono, Ripple and RippleRandom
+ */
+constexpr EffectName EFFECT_NAMES[] = {
+    { "blinking", ::openrazer::Effect::Blinking },
+    { "breathing", ::openrazer::Effect::Breathing },
+    { "breathing_dual", ::openrazer::Effect::BreathingDual },
+    { "breathing_random", ::openrazer::Effect::BreathingRandom },
+    { "off", ::openrazer::Effect::Off },
+    { "on", ::openrazer::Effect::On },
+    { "reactive", ::openrazer::Effect::Reactive },
+    { "spectrum", ::openrazer::Effect::Spectrum },
+    { "static", ::openrazer::Effect::Static },
+    { "wave", ::openrazer::Effect::Wave },
+};
+static_assert(effectnames::isSorted(EFFECT_NAMES), "EFFECT_NAMES must be sorted by name");
+
+}
+
+}
+
+#endif // EFFECTNAMES_P_H
@@ -0,0 +1,155 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "libopenrazer.h"
+#include "libopenrazer_private.h"
+#include "writecache_p.h"
+
+namespace libopenrazer {
+
+Led::~Led()
+{
+    delete m_writeCache;
+}
+
+void Led::setWriteCacheEnabled(bool enabled)
+{
+    if (m_writeCache == nullptr) {
+        if (!enabled)
+            return;
+        m_writeCache = new WriteCache();
+    }
+    m_writeCache->setEnabled(enabled);
+}
+
+bool Led::isWriteCacheEnabled() const
+{
+    return m_writeCache != nullptr && m_writeCache->isEnabled();
+}
+
+void Led::clearWriteCache()
+{
+    if (m_writeCache != nullptr)
+        m_writeCache->clear();
+}
+
+quint64 Led::getElidedWrites() const
+{
+    return m_writeCache != nullptr ? m_writeCache->elidedWrites() : 0;
+}
+
+::openrazer::Effect Led::getCurrentEffect()
+{
+    return unwrap(tryGetCurrentEffect(), lcLed(), Q_FUNC_INFO, getObjectPath());
+}
+
+QVector<::openrazer::RGB> Led::getCurrentColors()
+{
+    return unwrap(tryGetCurrentColors(), lcLed(), Q_FUNC_INFO, getObjectPath());
+}
+
+::openrazer::WaveDirection Led::getWaveDirection()
+{
+    return unwrap(tryGetWaveDirection(), lcLed(), Q_FUNC_INFO, getObjectPath());
+}
+
+::openrazer::LedId Led::getLedId()
+{
+    return unwrap(tryGetLedId(), lcLed(), Q_FUNC_INFO, getObjectPath());
+}
+
+void Led::setOff()
+{
+    unwrap(trySetOff(), lcLed(), Q_FUNC_INFO, getObjectPath());
+}
+
+void Led::setOn()
+{
+    unwrap(trySetOn(), lcLed(), Q_FUNC_INFO, getObjectPath());
+}
+
+void Led::setStatic(::openrazer::RGB color)
+{
+    unwrap(trySetStatic(color), lcLed(), Q_FUNC_INFO, getObjectPath());
+}
+
+void Led::setBreathing(::openrazer::RGB color)
+{
+    unwrap(trySetBreathing(color), lcLed(), Q_FUNC_INFO, getObjectPath());
+}
+
+void Led::setBreathingDual(::openrazer::RGB color, ::openrazer::RGB color2)
+{
+    unwrap(trySetBreathingDual(color, color2), lcLed(), Q_FUNC_INFO, getObjectPath());
+}
+
+void Led::setBreathingRandom()
+{
+    unwrap(trySetBreathingRandom(), lcLed(), Q_FUNC_INFO, getObjectPath());
+}
+
+void Led::setBreathingMono()
+{
+    unwrap(trySetBreathingMono(), lcLed(), Q_FUNC_INFO, getObjectPath());
+}
+
+void Led::setBlinking(::openrazer::RGB color)
+{
+    unwrap(trySetBlinking(color), lcLed(), Q_FUNC_INFO, getObjectPath());
+}
+
+void Led::setSpectrum()
+{
+    unwrap(trySetSpectrum(), lcLed(), Q_FUNC_INFO, getObjectPath());
+}
+
+void Led::setWave(::openrazer::WaveDirection direction)
+{
+    unwrap(trySetWave(direction), lcLed(), Q_FUNC_INFO, getObjectPath());
+}
+
+void Led::setWheel(::openrazer::WheelDirection direction)
+{
+    unwrap(trySetWheel(direction), lcLed(), Q_FUNC_INFO, getObjectPath());
+}
+
+void Led::setReactive(::openrazer::RGB color, ::openrazer::ReactiveSpeed speed)
+{
+    unwrap(trySetReactive(color, speed), lcLed(), Q_FUNC_INFO, getObjectPath());
+}
+
+void Led::setRipple(::openrazer::RGB color)
+{
+    unwrap(trySetRipple(color), lcLed(), Q_FUNC_INFO, getObjectPath());
+}
+
+void Led::setRippleRandom()
+{
+    unwrap(trySetRippleRandom(), lcLed(), Q_FUNC_INFO, getObjectPath());
+}
+
+void Led::setBrightness(uchar brightness)
+{
+    unwrap(trySetBrightness(brightness), lcLed(), Q_FUNC_INFO, getObjectPath());
+}
+
+uchar Led::getBrightness()
+{
+    return unwrap(tryGetBrightness(), lcLed(), Q_FUNC_INFO, getObjectPath());
+}
+
+Result<DBusCommand> Led::prepareEffect(::openrazer::Effect effect, const EffectParams &params)
+{
+    Q_UNUSED(effect);
+    Q_UNUSED(params);
+    return notSupportedError("Preparing calls is not supported by this Led.");
+}
+
+Result<DBusCommand> Led::prepareSetBrightness(uchar brightness)
+{
+    Q_UNUSED(brightness);
+    return notSupportedError("Preparing calls is not supported by this Led.");
+}
+
+}
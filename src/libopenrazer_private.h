@@ -5,45 +5,74 @@
 #ifndef LIBOPENRAZER_PRIVATE_H
 #define LIBOPENRAZER_PRIVATE_H
 
+#include "libopenrazer/device.h"
+
+#include "dbusinterface_p.h"
+#include "logging_p.h"
+
 #include <QDBusReply>
 
 namespace libopenrazer {
 
-void printDBusError(QDBusError error, const char *functionname);
-void handleVoidDBusReply(QDBusReply<bool> reply, const char *functionname);
+// objectPath is the object the error is about, if any, see warnRateLimited()
+void printDBusError(const QLoggingCategory &category, const Error &error, const char *functionname, const QDBusObjectPath &objectPath = QDBusObjectPath());
+[[noreturn]] void throwDBusException(const Error &error);
 QString fromCamelCase(const QString &s);
+// Unknown names are ignored
+Features featuresFromStrings(const QStringList &featureStrs);
 
 template<typename T>
-T handleDBusReply(QDBusReply<T> reply, const char *functionname)
+Result<T> toResult(const QDBusReply<T> &reply)
 {
     if (reply.isValid()) {
         return reply.value();
     }
-    printDBusError(reply.error(), functionname);
-    throw DBusException(reply.error());
+    return Error(reply.error());
 }
 
-// Specialization for QDBusReply<void>
-template<>
-void handleDBusReply(QDBusReply<void> reply, const char *functionname);
+Result<void> toResult(const QDBusReply<void> &reply);
+
+// For methods that return false if they didn't succeed
+Result<void> toVoidResult(const QDBusReply<bool> &reply, const char *functionname);
+
+// For the replies of sendDBusCommands(), a single false return value counts as failure like in toVoidResult()
+Result<void> commandResult(const DBusCommand &command, const QDBusMessage &reply);
+
+// For whatever a backend or device doesn't implement, named org.freedesktop.DBus.Error.NotSupported
+Error notSupportedError(const QString &message);
+
+// Used for property reads, see DBusInterface::getProperty()
+template<typename T>
+Result<T> variantToResult(const QDBusReply<QVariant> &reply)
+{
+    if (reply.isValid()) {
+        return qdbus_cast<T>(reply.value());
+    }
+    return Error(reply.error());
+}
 
+// Returns the value of the result, or logs the error to category and throws it
 template<typename T>
-T handleDBusVariant(QVariant variant, QDBusError error, const char *functionname)
+T unwrap(const Result<T> &result, const QLoggingCategory &category, const char *functionname, const QDBusObjectPath &objectPath = QDBusObjectPath())
 {
-    if (variant.isValid()) {
-        return variant.value<T>();
+    if (result.isOk()) {
+        return result.value();
     }
-    printDBusError(error, functionname);
-    throw DBusException(error);
+    printDBusError(category, result.error(), functionname, objectPath);
+    throwDBusException(result.error());
 }
 
+void unwrap(const Result<void> &result, const QLoggingCategory &category, const char *functionname, const QDBusObjectPath &objectPath = QDBusObjectPath());
+
 namespace openrazer {
 extern const char *OPENRAZER_SERVICE_NAME;
-extern QDBusConnection OPENRAZER_DBUS_BUS;
+// The bus of the daemon, used where no other connection was given
+QDBusConnection defaultConnection();
 }
 namespace razer_test {
 extern const char *OPENRAZER_SERVICE_NAME;
-extern QDBusConnection OPENRAZER_DBUS_BUS;
+// The bus of the daemon, used where no other connection was given
+QDBusConnection defaultConnection();
 }
 
 }
@@ -0,0 +1,70 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logging_p.h"
+
+#include <QDeadlineTimer>
+#include <QHash>
+#include <QMutex>
+#include <QPair>
+
+namespace libopenrazer {
+
+Q_LOGGING_CATEGORY(lcManager, "libopenrazer.manager")
+Q_LOGGING_CATEGORY(lcDevice, "libopenrazer.device")
+Q_LOGGING_CATEGORY(lcLed, "libopenrazer.led")
+Q_LOGGING_CATEGORY(lcTransport, "libopenrazer.transport")
+
+// How long identical messages from the same site are suppressed, in msecs
+static constexpr qint64 REPEAT_INTERVAL = 30000;
+
+namespace {
+struct SiteState {
+    QString lastMessage;
+    qint64 lastLogged = 0;
+    int suppressed = 0;
+};
+
+struct SiteRegistry {
+    QMutex mutex;
+    // Keyed by the site and the object path, so one device failing doesn't hide another one
+    QHash<QPair<const char *, QString>, SiteState> sites;
+};
+}
+
+Q_GLOBAL_STATIC(SiteRegistry, siteRegistry)
+
+void warnRateLimited(const QLoggingCategory &category, const char *site, const QString &objectPath, const QString &message)
+{
+    if (!category.isWarningEnabled())
+        return;
+
+    qint64 now = QDeadlineTimer::current().deadline();
+    int suppressed;
+    {
+        SiteRegistry *registry = siteRegistry();
+        QMutexLocker locker(&registry->mutex);
+        SiteState &state = registry->sites[qMakePair(site, objectPath)];
+        if (state.lastMessage == message && now - state.lastLogged < REPEAT_INTERVAL) {
+            state.suppressed++;
+            return;
+        }
+        suppressed = state.suppressed;
+        state.lastMessage = message;
+        state.lastLogged = now;
+        state.suppressed = 0;
+    }
+
+    if (objectPath.isEmpty()) {
+        if (suppressed > 0)
+            qCWarning(category, "libopenrazer: suppressed %d identical errors in %s", suppressed, site);
+        qCWarning(category, "libopenrazer: %s", qUtf8Printable(message));
+    } else {
+        if (suppressed > 0)
+            qCWarning(category, "libopenrazer: %s: suppressed %d identical errors in %s", qUtf8Printable(objectPath), suppressed, site);
+        qCWarning(category, "libopenrazer: %s: %s", qUtf8Printable(objectPath), qUtf8Printable(message));
+    }
+}
+
+}
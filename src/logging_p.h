@@ -0,0 +1,32 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGGING_P_H
+#define LOGGING_P_H
+
+#include <QLoggingCategory>
+
+namespace libopenrazer {
+
+Q_DECLARE_LOGGING_CATEGORY(lcManager)
+Q_DECLARE_LOGGING_CATEGORY(lcDevice)
+Q_DECLARE_LOGGING_CATEGORY(lcLed)
+Q_DECLARE_LOGGING_CATEGORY(lcTransport)
+
+/*
+ * Logs \a message about \a objectPath as a warning in \a category, unless
+ * it's a repeat of the last message logged from \a site for that object.
+ *
+ * \a site identifies the call site, usually Q_FUNC_INFO. \a objectPath is
+ * the D-Bus object the message is about, or empty if there is none, and is
+ * prepended to the message. Repeats are dropped and counted, and the count is
+ * reported with the next message logged from the same site for the same
+ * object: either a different message, or the same one again once
+ * REPEAT_INTERVAL has passed.
+ */
+void warnRateLimited(const QLoggingCategory &category, const char *site, const QString &objectPath, const QString &message);
+
+}
+
+#endif // LOGGING_P_H
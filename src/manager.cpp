@@ -0,0 +1,303 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "libopenrazer.h"
+#include "libopenrazer_private.h"
+#include "writecache_p.h"
+
+#include <QAtomicInt>
+#include <QDBusPendingReply>
+#include <QSet>
+
+namespace libopenrazer {
+
+Backend Manager::detectBackend(int msecs)
+{
+    struct Candidate {
+        Backend backend;
+        QDBusConnection connection;
+        const char *service;
+    };
+    // In the order of preference
+    const Candidate candidates[] = {
+        { Backend::OpenRazer, openrazer::defaultConnection(), openrazer::OPENRAZER_SERVICE_NAME },
+        { Backend::RazerTest, razer_test::defaultConnection(), razer_test::OPENRAZER_SERVICE_NAME },
+    };
+
+    // Send all questions before waiting for the first answer
+    QList<QDBusPendingCall> calls;
+    for (const Candidate &candidate : candidates) {
+        QDBusMessage m = QDBusMessage::createMethodCall("org.freedesktop.DBus", "/org/freedesktop/DBus", "org.freedesktop.DBus", "NameHasOwner");
+        m << QString::fromLatin1(candidate.service);
+        calls.append(candidate.connection.asyncCall(m, msecs));
+    }
+
+    for (int i = 0; i < calls.size(); i++) {
+        QDBusPendingReply<bool> reply = calls[i];
+        reply.waitForFinished();
+        if (reply.isValid() && reply.value())
+            return candidates[i].backend;
+    }
+    return Backend::None;
+}
+
+Manager *Manager::create(Backend backend)
+{
+    switch (backend) {
+    case Backend::OpenRazer:
+        return new openrazer::Manager();
+    case Backend::RazerTest:
+        return new razer_test::Manager();
+    case Backend::None:
+        break;
+    }
+    return nullptr;
+}
+
+Manager *Manager::createForRunningDaemon(int msecs)
+{
+    Backend backend = detectBackend(msecs);
+    return create(backend == Backend::None ? Backend::OpenRazer : backend);
+}
+
+QList<QDBusObjectPath> Manager::getDevices()
+{
+    return unwrap(tryGetDevices(), lcManager(), Q_FUNC_INFO);
+}
+
+QString Manager::getDaemonVersion()
+{
+    return unwrap(tryGetDaemonVersion(), lcManager(), Q_FUNC_INFO);
+}
+
+QVariantHash Manager::getSupportedDevices()
+{
+    return unwrap(tryGetSupportedDevices(), lcManager(), Q_FUNC_INFO);
+}
+
+Result<QVariantHash> Manager::tryGetSupportedDevices()
+{
+    Result<DeviceCatalog> catalog = tryGetDeviceCatalog();
+    if (!catalog)
+        return catalog.error();
+    return catalog.value().toVariantHash();
+}
+
+DeviceCatalog Manager::getDeviceCatalog()
+{
+    return unwrap(tryGetDeviceCatalog(), lcManager(), Q_FUNC_INFO);
+}
+
+void Manager::setDeviceCatalogCacheFile(const QString &fileName)
+{
+    m_catalogCacheFile = fileName;
+}
+
+QString Manager::deviceCatalogCacheFile() const
+{
+    return m_catalogCacheFile;
+}
+
+void Manager::setDeviceConnections(const QList<QDBusConnection> &connections)
+{
+    m_deviceConnections = connections;
+    m_deviceShards.clear();
+}
+
+QList<QDBusConnection> Manager::deviceConnections() const
+{
+    return m_deviceConnections;
+}
+
+QList<QDBusConnection> Manager::openPrivateConnections(QDBusConnection::BusType type, int count)
+{
+    // Connection names are process-wide, a name that is in use would return the existing connection
+    static QAtomicInt counter;
+    QList<QDBusConnection> connections;
+    for (int i = 0; i < count; i++) {
+        QString name = QString("libopenrazer-private-%1").arg(counter.fetchAndAddRelaxed(1));
+        QDBusConnection connection = QDBusConnection::connectToBus(type, name);
+        if (!connection.isConnected()) {
+            qCWarning(lcManager, "libopenrazer: Failed to open private D-Bus connection: %s", qUtf8Printable(connection.lastError().message()));
+            QDBusConnection::disconnectFromBus(name);
+            continue;
+        }
+        connections.append(connection);
+    }
+    return connections;
+}
+
+QDBusConnection Manager::deviceConnection(const QDBusObjectPath &objectPath, const QDBusConnection &fallback)
+{
+    if (m_deviceConnections.isEmpty())
+        return fallback;
+    // Hashing the path could put the few devices of a typical setup on the same connection, so assign them in turn
+    QHash<QString, int>::const_iterator it = m_deviceShards.constFind(objectPath.path());
+    if (it == m_deviceShards.constEnd())
+        it = m_deviceShards.insert(objectPath.path(), m_deviceShards.size() % m_deviceConnections.size());
+    return m_deviceConnections[it.value()];
+}
+
+void Manager::syncEffects(bool yes)
+{
+    unwrap(trySyncEffects(yes), lcManager(), Q_FUNC_INFO);
+}
+
+bool Manager::getSyncEffects()
+{
+    return unwrap(tryGetSyncEffects(), lcManager(), Q_FUNC_INFO);
+}
+
+void Manager::setTurnOffOnScreensaver(bool turnOffOnScreensaver)
+{
+    unwrap(trySetTurnOffOnScreensaver(turnOffOnScreensaver), lcManager(), Q_FUNC_INFO);
+}
+
+bool Manager::getTurnOffOnScreensaver()
+{
+    return unwrap(tryGetTurnOffOnScreensaver(), lcManager(), Q_FUNC_INFO);
+}
+
+QList<Device *> Manager::openAllDevices()
+{
+    return openDevices(getDevices());
+}
+
+QList<Device *> Manager::openDevices(const QList<QDBusObjectPath> &objectPaths)
+{
+    QList<Device *> devices;
+    for (const QDBusObjectPath &objectPath : objectPaths) {
+        try {
+            devices.append(getDevice(objectPath));
+        } catch (const DBusException &e) {
+            qCWarning(lcManager, "libopenrazer: Failed to set up device %s: %s", qUtf8Printable(objectPath.path()), qUtf8Printable(e.message()));
+        }
+    }
+    return devices;
+}
+
+QList<Device *> Manager::getTrackedDevices()
+{
+    if (!m_tracking) {
+        // Subscribe first so no hotplug event between the two calls gets lost
+        m_tracking = connectDevicesChanged(this, SLOT(updateTrackedDevices()));
+        syncTrackedDevices(false);
+    }
+    return m_trackedDevices.values();
+}
+
+QList<LedResult> Manager::applyToAll(::openrazer::Effect effect, const EffectParams &params,
+                                     const std::function<bool(Device *device, Led *led)> &filter)
+{
+    QList<LedResult> results;
+    QList<DBusCommand> commands;
+    // Index in results for each of the commands
+    QList<int> targets;
+
+    for (Device *device : getTrackedDevices()) {
+        for (Led *led : device->getLeds()) {
+            if (!led->hasFx(effect) || (filter && !filter(device, led)))
+                continue;
+            Result<DBusCommand> command = led->prepareEffect(effect, params);
+            if (!command) {
+                results.append({ device, led, command.error() });
+                continue;
+            }
+            targets.append(results.size());
+            results.append({ device, led, Result<void>() });
+            commands.append(command.value());
+        }
+    }
+
+    QList<QDBusMessage> replies = sendDBusCommands(commands);
+    for (int i = 0; i < replies.size(); i++) {
+        LedResult &result = results[targets[i]];
+        result.result = commandResult(commands[i], replies[i]);
+        // The effect was set without going through the write cache
+        if (result.led->m_writeCache != nullptr)
+            result.led->m_writeCache->invalidate(WriteCache::Effect);
+    }
+    return results;
+}
+
+Result<DBusCommand> Manager::prepareGetDevices()
+{
+    return notSupportedError("Listing the devices is not implemented by this backend.");
+}
+
+Result<QList<QDBusObjectPath>> Manager::parseDevices(const QDBusMessage &reply)
+{
+    Q_UNUSED(reply);
+    return notSupportedError("Listing the devices is not implemented by this backend.");
+}
+
+Result<DBusCommand> Manager::prepareGetSerial(const QDBusObjectPath &objectPath)
+{
+    Q_UNUSED(objectPath);
+    return notSupportedError("Reading the serial is not implemented by this backend.");
+}
+
+QString Manager::deviceIdentity(const QDBusObjectPath &objectPath)
+{
+    Q_UNUSED(objectPath);
+    return QString();
+}
+
+void Manager::updateTrackedDevices()
+{
+    syncTrackedDevices(true);
+}
+
+void Manager::syncTrackedDevices(bool notify)
+{
+    Result<QList<QDBusObjectPath>> result = tryGetDevices();
+    if (!result) {
+        printDBusError(lcManager(), result.error(), Q_FUNC_INFO);
+        return;
+    }
+
+    QSet<QString> current;
+    for (const QDBusObjectPath &objectPath : result.value())
+        current.insert(objectPath.path());
+
+    auto it = m_trackedDevices.begin();
+    while (it != m_trackedDevices.end()) {
+        if (current.contains(it.key())) {
+            // Another device, or the same one from another daemon, took over the path.
+            // A restart of the daemon is noticed by the write cache itself.
+            QString identity = deviceIdentity(QDBusObjectPath(it.key()));
+            if (identity != m_trackedIdentities.value(it.key())) {
+                it.value()->clearWriteCache();
+                m_trackedIdentities.insert(it.key(), identity);
+            }
+            ++it;
+            continue;
+        }
+        Device *device = it.value();
+        m_trackedIdentities.remove(it.key());
+        it = m_trackedDevices.erase(it);
+        if (notify)
+            emit deviceRemoved(device->objectPath());
+        device->deleteLater();
+    }
+
+    for (const QDBusObjectPath &objectPath : result.value()) {
+        if (m_trackedDevices.contains(objectPath.path()))
+            continue;
+        Device *device;
+        try {
+            device = getDevice(objectPath);
+        } catch (const DBusException &e) {
+            qCWarning(lcManager, "libopenrazer: Failed to set up device %s: %s", qUtf8Printable(objectPath.path()), qUtf8Printable(e.message()));
+            continue;
+        }
+        device->setParent(this);
+        m_trackedDevices.insert(objectPath.path(), device);
+        m_trackedIdentities.insert(objectPath.path(), deviceIdentity(objectPath));
+        if (notify)
+            emit deviceAdded(device);
+    }
+}
+
+}
@@ -13,34 +13,70 @@
 
 namespace libopenrazer {
 
-void printDBusError(QDBusError error, const char *functionname)
+void printDBusError(const QLoggingCategory &category, const Error &error, const char *functionname, const QDBusObjectPath &objectPath)
 {
-    qWarning("libopenrazer: There was an error in %s", functionname);
-    qWarning("libopenrazer: %s", qUtf8Printable(error.name()));
-    qWarning("libopenrazer: %s", qUtf8Printable(error.message()));
+    // The circuit breaker already logged that the daemon is gone
+    if (error.type() == Error::ServiceUnavailable || !category.isWarningEnabled())
+        return;
+    warnRateLimited(category, functionname, objectPath.path(),
+                    QString("There was an error in %1: %2: %3").arg(QString::fromLatin1(functionname), error.name(), error.message()));
+}
+
+void throwDBusException(const Error &error)
+{
+    switch (error.type()) {
+    case Error::ServiceUnavailable:
+        throw ServiceUnavailableException(error.name(), error.message());
+    case Error::Timeout:
+        throw TimeoutException(error.name(), error.message());
+    default:
+        throw DBusException(error.name(), error.message());
+    }
 }
 
-// Specialization for QDBusReply<void>
-template<>
-void handleDBusReply(QDBusReply<void> reply, const char *functionname)
+Result<void> toResult(const QDBusReply<void> &reply)
 {
     if (reply.isValid()) {
-        return;
+        return Result<void>();
     }
-    printDBusError(reply.error(), functionname);
-    throw DBusException(reply.error());
+    return Error(reply.error());
 }
 
-void handleVoidDBusReply(QDBusReply<bool> reply, const char *functionname)
+Result<void> toVoidResult(const QDBusReply<bool> &reply, const char *functionname)
 {
     if (!reply.isValid()) {
-        printDBusError(reply.error(), functionname);
-        throw DBusException(reply.error());
+        return Error(reply.error());
     }
     if (!reply.value()) {
-        qWarning("libopenrazer: %s: The function has returned false", functionname);
-        throw DBusException("Call failed", QString(functionname) + " has returned false");
+        return Error("Call failed", QString(functionname) + " has returned false");
+    }
+    return Result<void>();
+}
+
+Result<void> commandResult(const DBusCommand &command, const QDBusMessage &reply)
+{
+    if (reply.type() == QDBusMessage::ErrorMessage) {
+        return Error(QDBusError(reply));
+    }
+    const QList<QVariant> arguments = reply.arguments();
+    if (arguments.size() == 1 && arguments.first().metaType().id() == QMetaType::Bool && !arguments.first().toBool()) {
+        return Error("Call failed", command.message.member() + " has returned false");
+    }
+    return Result<void>();
+}
+
+Error notSupportedError(const QString &message)
+{
+    return Error(QDBusError::errorString(QDBusError::NotSupported), message);
+}
+
+void unwrap(const Result<void> &result, const QLoggingCategory &category, const char *functionname, const QDBusObjectPath &objectPath)
+{
+    if (result.isOk()) {
+        return;
     }
+    printDBusError(category, result.error(), functionname, objectPath);
+    throwDBusException(result.error());
 }
 
 // Convert CamelCase string to snake_case
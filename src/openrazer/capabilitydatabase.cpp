@@ -0,0 +1,167 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "capabilitydatabase_p.h"
+#include "libopenrazer_private.h"
+
+#include <QDataStream>
+#include <QDBusReply>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace libopenrazer {
+
+namespace openrazer {
+
+static constexpr quint32 FILE_MAGIC = 0x4c4f5243; // "LORC"
+// Version 1 also stored the devices by their object path
+static constexpr quint32 FILE_VERSION = 2;
+
+CapabilityDatabase *CapabilityDatabase::instance()
+{
+    static CapabilityDatabase database;
+    return &database;
+}
+
+CapabilityDatabase::CapabilityDatabase()
+{
+    fileName = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/libopenrazer/capabilities.bin";
+}
+
+QDBusMessage CapabilityDatabase::vidPidMessage(const QDBusObjectPath &objectPath)
+{
+    return QDBusMessage::createMethodCall(OPENRAZER_SERVICE_NAME, objectPath.path(), "razer.device.misc", "getVidPid");
+}
+
+QDBusMessage CapabilityDatabase::versionMessage()
+{
+    return QDBusMessage::createMethodCall(OPENRAZER_SERVICE_NAME, "/org/razer", "razer.daemon", "version");
+}
+
+QString CapabilityDatabase::modelKey(const QString &version, const QDBusMessage &vidPidReply)
+{
+    QDBusReply<QList<int>> reply = vidPidReply;
+    if (version.isEmpty() || !reply.isValid() || reply.value().size() != 2)
+        return QString();
+
+    return QString("%1/%2:%3").arg(version).arg(reply.value()[0], 4, 16, QLatin1Char('0')).arg(reply.value()[1], 4, 16, QLatin1Char('0'));
+}
+
+bool CapabilityDatabase::lookup(const QString &key, CapabilityIndex *index)
+{
+    QMutexLocker locker(&mutex);
+    if (!loaded)
+        load();
+
+    QHash<QString, CapabilityIndex>::const_iterator it = entries.constFind(key);
+    if (it == entries.constEnd())
+        return false;
+    *index = it.value();
+    return true;
+}
+
+void CapabilityDatabase::insert(const QString &key, const CapabilityIndex &index)
+{
+    QMutexLocker locker(&mutex);
+    if (!loaded)
+        load();
+
+    // Known devices are inserted again each time they are opened
+    QHash<QString, CapabilityIndex>::iterator it = entries.find(key);
+    if (it != entries.end() && it.value() == index)
+        return;
+    entries.insert(key, index);
+    dirty = true;
+}
+
+QString CapabilityDatabase::knownDaemonVersion(const QDBusConnection &connection)
+{
+    int generation = CircuitBreaker::forService(OPENRAZER_SERVICE_NAME, connection)->ownerGeneration();
+    QMutexLocker locker(&mutex);
+    CachedDaemon cached = cachedDaemons.value(connection.name());
+    return generation == cached.generation ? cached.version : QString();
+}
+
+QString CapabilityDatabase::storeDaemonVersion(const QDBusConnection &connection, int generation, const QDBusMessage &reply)
+{
+    QDBusReply<QString> version = reply;
+    if (!version.isValid())
+        return QString();
+
+    QMutexLocker locker(&mutex);
+    CachedDaemon &cached = cachedDaemons[connection.name()];
+    // The devices of an earlier owner are gone
+    if (cached.generation != generation)
+        cached.deviceKeys.clear();
+    cached.version = version.value();
+    cached.generation = generation;
+    return version.value();
+}
+
+QString CapabilityDatabase::knownDeviceKey(const QDBusConnection &connection, const QDBusObjectPath &objectPath)
+{
+    int generation = CircuitBreaker::forService(OPENRAZER_SERVICE_NAME, connection)->ownerGeneration();
+    QMutexLocker locker(&mutex);
+    QHash<QString, CachedDaemon>::const_iterator it = cachedDaemons.constFind(connection.name());
+    if (it == cachedDaemons.constEnd() || it->generation != generation)
+        return QString();
+    return it->deviceKeys.value(objectPath.path());
+}
+
+void CapabilityDatabase::storeDeviceKey(const QDBusConnection &connection, int generation, const QDBusObjectPath &objectPath, const QString &key)
+{
+    QMutexLocker locker(&mutex);
+    QHash<QString, CachedDaemon>::iterator it = cachedDaemons.find(connection.name());
+    // The key has the version of the owner the VID/PID was read from
+    if (it != cachedDaemons.end() && it->generation == generation)
+        it->deviceKeys.insert(objectPath.path(), key);
+}
+
+void CapabilityDatabase::load()
+{
+    loaded = true;
+
+    // The whole file is deserialized anyway, so just read it
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    quint32 magic, version;
+    stream >> magic >> version;
+    if (magic == FILE_MAGIC && version == FILE_VERSION) {
+        QHash<QString, CapabilityIndex> fileEntries;
+        stream >> fileEntries;
+        if (stream.status() == QDataStream::Ok)
+            entries = fileEntries;
+    }
+}
+
+void CapabilityDatabase::save()
+{
+    QMutexLocker locker(&mutex);
+    if (!dirty)
+        return;
+    dirty = false;
+
+    QDir().mkpath(QFileInfo(fileName).path());
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(lcDevice, "libopenrazer: Failed to write capability database %s: %s", qUtf8Printable(fileName), qUtf8Printable(file.errorString()));
+        return;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << FILE_MAGIC << FILE_VERSION << entries;
+    file.commit();
+}
+
+}
+
+}
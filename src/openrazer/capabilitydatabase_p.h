@@ -0,0 +1,130 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef OPENRAZER_CAPABILITYDATABASE_P_H
+#define OPENRAZER_CAPABILITYDATABASE_P_H
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusObjectPath>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+
+namespace libopenrazer {
+
+namespace openrazer {
+
+// Maps the interfaces of a device to the names of their methods
+using CapabilityIndex = QHash<QString, QSet<QString>>;
+
+/*
+ * Persistent cache of the capability index of each device model.
+ *
+ * The D-Bus API the daemon exposes for a device only depends on the daemon
+ * version and the VID/PID of the device, so once a model has been introspected
+ * its capability index can be reused for every later device of the same model,
+ * also across restarts of the application. The entries are kept in a compact
+ * binary file in the generic cache directory, which is read when it is first
+ * needed and written by save().
+ *
+ * Which model is at which object path is only remembered in memory for the
+ * current owner of the daemon service, as the paths aren't stable across
+ * restarts of the daemon.
+ */
+class CapabilityDatabase
+{
+public:
+    static CapabilityDatabase *instance();
+
+    /*
+     * Returns the message asking the device at \a objectPath for its VID/PID.
+     */
+    static QDBusMessage vidPidMessage(const QDBusObjectPath &objectPath);
+
+    /*
+     * Returns the message asking the daemon for its version.
+     */
+    static QDBusMessage versionMessage();
+
+    /*
+     * Returns the database key for the model that sent \a vidPidReply to a
+     * daemon with the given \a version, or an empty string if the version is
+     * empty or the reply isn't a VID/PID, e.g. because the daemon is too old
+     * to report it.
+     */
+    static QString modelKey(const QString &version, const QDBusMessage &vidPidReply);
+
+    /*
+     * Looks up \a key and stores the capability index in \a index.
+     * Returns false if the model hasn't been seen yet.
+     */
+    bool lookup(const QString &key, CapabilityIndex *index);
+
+    /*
+     * Adds or replaces \a key, the file is only written by save().
+     */
+    void insert(const QString &key, const CapabilityIndex &index);
+
+    /*
+     * Writes the database to disk if entries have been inserted since it
+     * was last written.
+     */
+    void save();
+
+    /*
+     * Returns the version of the daemon on \a connection if it has been read
+     * before from the current owner of the service, without calling it.
+     */
+    QString knownDaemonVersion(const QDBusConnection &connection);
+
+    /*
+     * Remembers the version of the daemon from \a reply to versionMessage(),
+     * if the owner \a generation of the service read before the call is still
+     * current. Returns the version, or an empty string if the reply is an
+     * error.
+     */
+    QString storeDaemonVersion(const QDBusConnection &connection, int generation, const QDBusMessage &reply);
+
+    /*
+     * Returns the database key of the device at \a objectPath on \a connection
+     * if it has been stored for the current owner of the service, without
+     * calling it.
+     */
+    QString knownDeviceKey(const QDBusConnection &connection, const QDBusObjectPath &objectPath);
+
+    /*
+     * Remembers the database key of the device at \a objectPath, if the owner
+     * \a generation read before asking for its VID/PID is the one the daemon
+     * version is stored for.
+     */
+    void storeDeviceKey(const QDBusConnection &connection, int generation, const QDBusObjectPath &objectPath, const QString &key);
+
+private:
+    CapabilityDatabase();
+
+    void load();
+
+    QMutex mutex;
+    QString fileName;
+    bool loaded = false;
+    // Entries have been inserted since the file was written
+    bool dirty = false;
+    QHash<QString, CapabilityIndex> entries;
+
+    struct CachedDaemon {
+        QString version;
+        int generation = -1;
+        // Database keys by object path
+        QHash<QString, QString> deviceKeys;
+    };
+    // By connection name, the owner generations of different connections can't be compared
+    QHash<QString, CachedDaemon> cachedDaemons;
+};
+
+}
+
+}
+
+#endif // OPENRAZER_CAPABILITYDATABASE_P_H
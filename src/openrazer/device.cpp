@@ -5,24 +5,32 @@
 #include "device_p.h"
 #include "libopenrazer.h"
 #include "libopenrazer_private.h"
+#include "writecache_p.h"
 
 #include <QDBusReply>
-#include <QDomDocument>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QVector>
+#include <QXmlStreamReader>
 
 namespace libopenrazer {
 
 namespace openrazer {
 
-Device::Device(QDBusObjectPath objectPath)
+Device::Device(QDBusObjectPath objectPath, int timeout)
+    : Device(objectPath, defaultConnection(), timeout)
 {
-    d = new DevicePrivate();
-    d->mParent = this;
-    d->mObjectPath = objectPath;
+}
+
+Device::Device(QDBusObjectPath objectPath, const QDBusConnection &connection, int timeout)
+    : Device(new DevicePrivate(objectPath, connection, timeout, DevicePrivate::introspect(objectPath, connection, timeout)))
+{
+}
 
-    d->introspect();
+Device::Device(DevicePrivate *d)
+    : d(d)
+{
+    d->mParent = this;
     d->setupCapabilities();
 
     QMap<::openrazer::LedId, QString>::const_iterator i = d->supportedLeds.constBegin();
@@ -38,34 +46,93 @@ Device::~Device()
     for (libopenrazer::Led *led : d->leds) {
         delete led;
     }
+    delete d;
+}
+
+QDBusMessage DevicePrivate::introspectMessage(const QDBusObjectPath &objectPath)
+{
+    return QDBusMessage::createMethodCall(OPENRAZER_SERVICE_NAME, objectPath.path(), "org.freedesktop.DBus.Introspectable", "Introspect");
 }
 
-void DevicePrivate::introspect()
+DevicePrivate::DevicePrivate(const QDBusObjectPath &objectPath, const QDBusConnection &connection, int timeout, const CapabilityIndex &introspection)
+    : connection(connection), mObjectPath(objectPath), timeout(timeout), introspection(introspection)
 {
-    QStringList intr;
+}
+
+/**
+ * Returns the capability index of the device, from the capability database if the device is known and by introspecting it otherwise.
+ */
+CapabilityIndex DevicePrivate::introspect(const QDBusObjectPath &objectPath, const QDBusConnection &connection, int timeout)
+{
+    CircuitBreaker *breaker = CircuitBreaker::forService(OPENRAZER_SERVICE_NAME, connection);
+    CapabilityDatabase *database = CapabilityDatabase::instance();
+
+    // Devices opened before with the same daemon are set up without calling the daemon at all
+    CapabilityIndex index;
+    QString key = database->knownDeviceKey(connection, objectPath);
+    if (!key.isEmpty() && database->lookup(key, &index)) {
+        return index;
+    }
+
+    // Otherwise known models only need the VID/PID, the version is asked for alongside if needed
+    int generation = breaker->ownerGeneration();
+    QString version = database->knownDaemonVersion(connection);
+    QList<QDBusMessage> messages { CapabilityDatabase::vidPidMessage(objectPath) };
+    if (version.isEmpty())
+        messages.append(CapabilityDatabase::versionMessage());
+    QList<QDBusMessage> replies = sendDBusMessages(breaker, connection, messages, timeout);
+
+    if (version.isEmpty())
+        version = database->storeDaemonVersion(connection, generation, replies[1]);
+    key = CapabilityDatabase::modelKey(version, replies[0]);
+    if (!key.isEmpty()) {
+        database->storeDeviceKey(connection, generation, objectPath, key);
+        if (database->lookup(key, &index))
+            return index;
+    }
 
-    QDBusMessage m = QDBusMessage::createMethodCall(OPENRAZER_SERVICE_NAME, mObjectPath.path(), "org.freedesktop.DBus.Introspectable", "Introspect");
-    QDBusReply<QString> reply = OPENRAZER_DBUS_BUS.call(m);
+    QDBusReply<QString> reply = sendDBusMessage(breaker, connection, introspectMessage(objectPath), timeout);
     if (!reply.isValid()) {
-        throw DBusException(reply.error());
+        throwDBusException(reply.error());
     }
-    QDomDocument doc;
-    doc.setContent(reply.value());
-
-    QDomNodeList nodes = doc.documentElement().childNodes();
-    for (int i = 0; i < nodes.count(); i++) {
-        // Check if "interface" and also not org.freedesktop.DBus.Introspectable
-        QDomElement element = nodes.at(i).toElement();
-        QString interfacename = element.attributeNode("name").value();
-
-        QDomNodeList methodnodes = element.childNodes();
-        for (int ii = 0; ii < methodnodes.count(); ii++) {
-            QDomElement methodelement = methodnodes.at(ii).toElement();
-            intr.append(interfacename + ";" + methodelement.attributeNode("name").value());
+    index = parseIntrospection(reply.value());
+
+    if (!key.isEmpty()) {
+        database->insert(key, index);
+        database->save();
+    }
+    return index;
+}
+
+/**
+ * Builds the capability index from the introspection XML in a single pass, only looking at the methods of the interfaces of the object itself.
+ */
+CapabilityIndex DevicePrivate::parseIntrospection(const QString &xml)
+{
+    CapabilityIndex index;
+    QSet<QString> *methods = nullptr;
+    int depth = 0;
+
+    QXmlStreamReader reader(xml);
+    while (!reader.atEnd()) {
+        switch (reader.readNext()) {
+        case QXmlStreamReader::StartElement:
+            depth++;
+            if (depth == 2 && reader.name() == QLatin1String("interface"))
+                methods = &index[reader.attributes().value(QLatin1String("name")).toString()];
+            else if (depth == 3 && methods != nullptr && reader.name() == QLatin1String("method"))
+                methods->insert(reader.attributes().value(QLatin1String("name")).toString());
+            break;
+        case QXmlStreamReader::EndElement:
+            if (depth == 2)
+                methods = nullptr;
+            depth--;
+            break;
+        default:
+            break;
         }
-        intr.append(interfacename);
     }
-    introspection = intr;
+    return index;
 }
 
 /**
@@ -74,23 +141,23 @@ void DevicePrivate::introspect()
 void DevicePrivate::setupCapabilities()
 {
     if (hasCapabilityInternal("razer.device.misc", "getKeyboardLayout"))
-        supportedFeatures.append("keyboard_layout");
+        supportedFeatures |= Feature::KeyboardLayout;
     if (hasCapabilityInternal("razer.device.dpi", "setDPI"))
-        supportedFeatures.append("dpi");
+        supportedFeatures |= Feature::DPI;
     if (hasCapabilityInternal("razer.device.dpi", "availableDPI"))
-        supportedFeatures.append("restricted_dpi");
+        supportedFeatures |= Feature::RestrictedDPI;
     if (hasCapabilityInternal("razer.device.dpi", "setDPIStages"))
-        supportedFeatures.append("dpi_stages");
+        supportedFeatures |= Feature::DPIStages;
     if (hasCapabilityInternal("razer.device.misc", "setPollRate"))
-        supportedFeatures.append("poll_rate");
+        supportedFeatures |= Feature::PollRate;
     if (hasCapabilityInternal("razer.device.lighting.chroma", "setCustom"))
-        supportedFeatures.append("custom_frame");
+        supportedFeatures |= Feature::CustomFrame;
     if (hasCapabilityInternal("razer.device.power", "getBattery"))
-        supportedFeatures.append("battery");
+        supportedFeatures |= Feature::Battery;
     if (hasCapabilityInternal("razer.device.power", "getLowBatteryThreshold"))
-        supportedFeatures.append("low_battery_threshold");
+        supportedFeatures |= Feature::LowBatteryThreshold;
     if (hasCapabilityInternal("razer.device.power", "getIdleTime"))
-        supportedFeatures.append("idle_time");
+        supportedFeatures |= Feature::IdleTime;
 
     // razer.device.lighting.chroma more than only the normal fx, so check for methods directly
     if (hasCapabilityInternal("razer.device.lighting.chroma", "setNone")
@@ -127,10 +194,11 @@ void DevicePrivate::setupCapabilities()
  */
 bool DevicePrivate::hasCapabilityInternal(const QString &interface, const QString &method)
 {
-    if (method.isNull()) {
-        return introspection.contains(interface);
+    CapabilityIndex::const_iterator it = introspection.constFind(interface);
+    if (it == introspection.constEnd()) {
+        return false;
     }
-    return introspection.contains(interface + ";" + method);
+    return method.isNull() || it->contains(method);
 }
 
 QDBusObjectPath Device::objectPath()
@@ -138,16 +206,17 @@ QDBusObjectPath Device::objectPath()
     return d->mObjectPath;
 }
 
-bool Device::hasFeature(const QString &featureStr)
+Features Device::features()
 {
-    return d->supportedFeatures.contains(featureStr);
+    return d->supportedFeatures;
 }
 
-QString Device::getDeviceImageUrl()
+Result<QString> Device::tryGetDeviceImageUrl()
 {
     QDBusReply<QString> reply = d->deviceMiscIface()->call("getRazerUrls");
-    QString json = handleDBusReply(reply, Q_FUNC_INFO);
-    return QJsonDocument::fromJson(json.toUtf8()).object().value("top_img").toString();
+    if (!reply.isValid())
+        return Error(reply.error());
+    return QJsonDocument::fromJson(reply.value().toUtf8()).object().value("top_img").toString();
 }
 
 // ----- DBUS METHODS -----
@@ -157,28 +226,35 @@ QList<::libopenrazer::Led *> Device::getLeds()
     return d->leds;
 }
 
-QString Device::getDeviceMode()
+Result<QString> Device::tryGetDeviceMode()
 {
     QDBusReply<QString> reply = d->deviceMiscIface()->call("getDeviceMode");
-    return handleDBusReply(reply, Q_FUNC_INFO);
+    return toResult(reply);
 }
 
-QString Device::getSerial()
+Result<QString> Device::tryGetSerial()
 {
     QDBusReply<QString> reply = d->deviceMiscIface()->call("getSerial");
-    return handleDBusReply(reply, Q_FUNC_INFO);
+    return toResult(reply);
+}
+
+Result<DBusCommand> Device::prepareGetSerial()
+{
+    return d->deviceMiscIface()->prepareCall("getSerial");
 }
 
-QString Device::getDeviceName()
+Result<QString> Device::tryGetDeviceName()
 {
     QDBusReply<QString> reply = d->deviceMiscIface()->call("getDeviceName");
-    return handleDBusReply(reply, Q_FUNC_INFO);
+    return toResult(reply);
 }
 
-QString Device::getDeviceType()
+Result<QString> Device::tryGetDeviceType()
 {
     QDBusReply<QString> reply = d->deviceMiscIface()->call("getDeviceType");
-    QString type = handleDBusReply(reply, Q_FUNC_INFO);
+    if (!reply.isValid())
+        return Error(reply.error());
+    QString type = reply.value();
     const QHash<QString, QString> translationTable = {
         { "core", "accessory" },
         { "mousemat", "mousepad" },
@@ -189,16 +265,18 @@ QString Device::getDeviceType()
     return type;
 }
 
-QString Device::getFirmwareVersion()
+Result<QString> Device::tryGetFirmwareVersion()
 {
     QDBusReply<QString> reply = d->deviceMiscIface()->call("getFirmware");
-    return handleDBusReply(reply, Q_FUNC_INFO);
+    return toResult(reply);
 }
 
-QString Device::getKeyboardLayout()
+Result<QString> Device::tryGetKeyboardLayout()
 {
     QDBusReply<QString> reply = d->deviceMiscIface()->call("getKeyboardLayout");
-    QString layout = handleDBusReply(reply, Q_FUNC_INFO);
+    if (!reply.isValid())
+        return Error(reply.error());
+    QString layout = reply.value();
     const QHash<QString, QString> translationTable = {
         { "de_DE", "German" },
         { "el_GR", "Greek" },
@@ -216,83 +294,135 @@ QString Device::getKeyboardLayout()
     return layout;
 }
 
-ushort Device::getPollRate()
+Result<ushort> Device::tryGetPollRate()
 {
-    QDBusReply<int> reply = d->deviceMiscIface()->call("getPollRate");
-    return handleDBusReply(reply, Q_FUNC_INFO);
+    Result<ushort> result = DevicePrivate::parsePollRate(d->deviceMiscIface()->call("getPollRate"));
+    observeRead(writeCache(), WriteCache::PollRate, result);
+    return result;
 }
 
-void Device::setPollRate(ushort pollrate)
+Result<void> Device::trySetPollRate(ushort pollrate)
 {
-    QDBusReply<void> reply = d->deviceMiscIface()->call("setPollRate", QVariant::fromValue(pollrate));
-    handleDBusReply(reply, Q_FUNC_INFO);
+    return cachedWrite(writeCache(), d->deviceMiscIface(), WriteCache::PollRate, QVariant::fromValue(pollrate), [&]() {
+        std::unique_ptr<TransportCall> call = d->controlTransport()->createCall("razer.device.misc", "setPollRate");
+        call->appendUInt16(pollrate);
+        return call->send(d->timeout);
+    });
 }
 
-QVector<ushort> Device::getSupportedPollRates()
+Result<DBusCommand> Device::prepareSetPollRate(ushort pollrate)
+{
+    return d->deviceMiscIface()->prepareCall("setPollRate", { QVariant::fromValue(pollrate) });
+}
+
+Result<QVector<ushort>> Device::tryGetSupportedPollRates()
 {
     // Not every device has getSupportedPollRates yet, return defaults in that case.
     if (!d->hasCapabilityInternal("razer.device.misc", "getSupportedPollRates")) {
-        return { 125, 500, 1000 };
+        return QVector<ushort> { 125, 500, 1000 };
     }
     QDBusReply<QVector<ushort>> reply = d->deviceMiscIface()->call("getSupportedPollRates");
-    return handleDBusReply(reply, Q_FUNC_INFO);
+    return toResult(reply);
+}
+
+Result<void> Device::trySetDPI(::openrazer::DPI dpi)
+{
+    std::unique_ptr<TransportCall> call = d->controlTransport()->createCall("razer.device.dpi", "setDPI");
+    call->appendUInt16(dpi.dpi_x);
+    call->appendUInt16(dpi.dpi_y);
+    return call->send(d->timeout);
+}
+
+Result<DBusCommand> Device::prepareSetDPI(::openrazer::DPI dpi)
+{
+    return d->deviceDpiIface()->prepareCall("setDPI", { QVariant::fromValue(dpi.dpi_x), QVariant::fromValue(dpi.dpi_y) });
 }
 
-void Device::setDPI(::openrazer::DPI dpi)
+Result<::openrazer::DPI> Device::tryGetDPI()
 {
-    QDBusReply<void> reply = d->deviceDpiIface()->call("setDPI", QVariant::fromValue(dpi.dpi_x), QVariant::fromValue(dpi.dpi_y));
-    handleDBusReply(reply, Q_FUNC_INFO);
+    return DevicePrivate::parseDPI(d->deviceDpiIface()->call("getDPI"));
 }
 
-::openrazer::DPI Device::getDPI()
+Result<ushort> DevicePrivate::parsePollRate(const QDBusMessage &message)
 {
-    QDBusReply<QList<int>> reply = d->deviceDpiIface()->call("getDPI");
-    QList<int> dpi = handleDBusReply(reply, Q_FUNC_INFO);
+    QDBusReply<int> reply = message;
+    if (!reply.isValid())
+        return Error(reply.error());
+    return static_cast<ushort>(reply.value());
+}
+
+Result<::openrazer::DPI> DevicePrivate::parseDPI(const QDBusMessage &message)
+{
+    QDBusReply<QList<int>> reply = message;
+    if (!reply.isValid())
+        return Error(reply.error());
+    QList<int> dpi = reply.value();
     if (dpi.size() == 1) {
-        return { static_cast<ushort>(dpi[0]), 0 };
+        return ::openrazer::DPI { static_cast<ushort>(dpi[0]), 0 };
     } else if (dpi.size() == 2) {
-        return { static_cast<ushort>(dpi[0]), static_cast<ushort>(dpi[1]) };
+        return ::openrazer::DPI { static_cast<ushort>(dpi[0]), static_cast<ushort>(dpi[1]) };
     } else {
-        throw DBusException("Invalid return array from DPI", "The DPI return array has an invalid size.");
+        return Error("Invalid return array from DPI", "The DPI return array has an invalid size.");
     }
 }
 
-void Device::setDPIStages(uchar activeStage, QVector<::openrazer::DPI> dpiStages)
+Result<void> Device::trySetDPIStages(uchar activeStage, QVector<::openrazer::DPI> dpiStages)
+{
+    std::unique_ptr<TransportCall> call = d->controlTransport()->createCall("razer.device.dpi", "setDPIStages");
+    call->appendByte(activeStage);
+    call->appendDPIs(dpiStages);
+    return call->send(d->timeout);
+}
+
+Result<DBusCommand> Device::prepareSetDPIStages(uchar activeStage, QVector<::openrazer::DPI> dpiStages)
 {
-    QDBusReply<void> reply = d->deviceDpiIface()->call("setDPIStages", QVariant::fromValue(activeStage), QVariant::fromValue(dpiStages));
-    handleDBusReply(reply, Q_FUNC_INFO);
+    return d->deviceDpiIface()->prepareCall("setDPIStages", { QVariant::fromValue(activeStage), QVariant::fromValue(dpiStages) });
 }
 
-QPair<uchar, QVector<::openrazer::DPI>> Device::getDPIStages()
+Result<QPair<uchar, QVector<::openrazer::DPI>>> Device::tryGetDPIStages()
 {
     QDBusReply<QPair<uchar, QVector<::openrazer::DPI>>> reply = d->deviceDpiIface()->call("getDPIStages");
-    return handleDBusReply(reply, Q_FUNC_INFO);
+    return toResult(reply);
 }
 
-ushort Device::maxDPI()
+Result<ushort> Device::tryMaxDPI()
 {
     QDBusReply<int> reply = d->deviceDpiIface()->call("maxDPI");
-    return handleDBusReply(reply, Q_FUNC_INFO);
+    if (!reply.isValid())
+        return Error(reply.error());
+    return static_cast<ushort>(reply.value());
 }
 
-double Device::getBatteryPercent()
+Result<double> Device::tryGetBatteryPercent()
 {
     QDBusReply<double> reply = d->devicePowerIface()->call("getBattery");
-    return handleDBusReply(reply, Q_FUNC_INFO);
+    return toResult(reply);
 }
 
-bool Device::isCharging()
+Result<DBusCommand> Device::prepareGetBatteryPercent()
+{
+    return d->devicePowerIface()->prepareCall("getBattery");
+}
+
+Result<bool> Device::tryIsCharging()
 {
     QDBusReply<bool> reply = d->devicePowerIface()->call("isCharging");
-    return handleDBusReply(reply, Q_FUNC_INFO);
+    return toResult(reply);
 }
 
-QVector<ushort> Device::getAllowedDPI()
+Result<DBusCommand> Device::prepareIsCharging()
+{
+    return d->devicePowerIface()->prepareCall("isCharging");
+}
+
+Result<QVector<ushort>> Device::tryGetAllowedDPI()
 {
     QDBusReply<QVector<int>> reply = d->deviceDpiIface()->call("availableDPI");
-    QVector<int> values = handleDBusReply(reply, Q_FUNC_INFO);
+    if (!reply.isValid())
+        return Error(reply.error());
+    QVector<int> values = reply.value();
     if (values.isEmpty())
-        throw DBusException("Invalid return array from availableDPI", "The availableDPI return array is empty.");
+        return Error("Invalid return array from availableDPI", "The availableDPI return array is empty.");
     // Convert QVector<int> to QVector<ushort>
     QVector<ushort> out;
     out.reserve(values.size());
@@ -301,38 +431,68 @@ QVector<ushort> Device::getAllowedDPI()
     return out;
 }
 
-ushort Device::getIdleTime()
+Result<ushort> Device::tryGetIdleTime()
 {
     QDBusReply<ushort> reply = d->devicePowerIface()->call("getIdleTime");
-    return handleDBusReply(reply, Q_FUNC_INFO);
+    Result<ushort> result = toResult(reply);
+    observeRead(writeCache(), WriteCache::IdleTime, result);
+    return result;
 }
 
-void Device::setIdleTime(ushort idleTime)
+Result<void> Device::trySetIdleTime(ushort idleTime)
 {
-    QDBusReply<void> reply = d->devicePowerIface()->call("setIdleTime", QVariant::fromValue(idleTime));
-    handleDBusReply(reply, Q_FUNC_INFO);
+    return cachedWrite(writeCache(), d->devicePowerIface(), WriteCache::IdleTime, QVariant::fromValue(idleTime), [&]() {
+        std::unique_ptr<TransportCall> call = d->controlTransport()->createCall("razer.device.power", "setIdleTime");
+        call->appendUInt16(idleTime);
+        return call->send(d->timeout);
+    });
 }
 
-double Device::getLowBatteryThreshold()
+Result<double> Device::tryGetLowBatteryThreshold()
 {
     QDBusReply<uchar> reply = d->devicePowerIface()->call("getLowBatteryThreshold");
-    return handleDBusReply(reply, Q_FUNC_INFO);
+    if (!reply.isValid())
+        return Error(reply.error());
+    Result<double> result = static_cast<double>(reply.value());
+    observeRead(writeCache(), WriteCache::LowBatteryThreshold, result);
+    return result;
 }
 
-void Device::setLowBatteryThreshold(double threshold)
+Result<DBusCommand> Device::prepareGetLowBatteryThreshold()
 {
-    QDBusReply<void> reply = d->devicePowerIface()->call("setLowBatteryThreshold", QVariant::fromValue(threshold));
-    handleDBusReply(reply, Q_FUNC_INFO);
+    return d->devicePowerIface()->prepareCall("getLowBatteryThreshold");
 }
 
-void Device::displayCustomFrame()
+Result<void> Device::trySetLowBatteryThreshold(double threshold)
 {
-    QDBusReply<void> reply = d->deviceLightingChromaIface()->call("setCustom");
-    handleDBusReply(reply, Q_FUNC_INFO);
+    // The daemon takes whole percents as a byte, cache what it will report back
+    uchar percent = static_cast<uchar>(qBound(0, qRound(threshold), 100));
+    return cachedWrite(writeCache(), d->devicePowerIface(), WriteCache::LowBatteryThreshold, QVariant::fromValue(static_cast<double>(percent)), [&]() {
+        std::unique_ptr<TransportCall> call = d->controlTransport()->createCall("razer.device.power", "setLowBatteryThreshold");
+        call->appendByte(percent);
+        return call->send(d->timeout);
+    });
 }
 
-void Device::defineCustomFrame(uchar row, uchar startColumn, uchar endColumn, QVector<::openrazer::RGB> colorData)
+Result<void> Device::tryDisplayCustomFrame()
 {
+    if (FrameBuffer *buffer = d->customFrameBuffer()) {
+        std::unique_ptr<TransportCall> call = d->transport()->createCall("razer.device.lighting.chroma", "displayCustomFrameBuffer");
+        call->appendUInt32(buffer->nextFrame());
+        return call->send(d->timeout);
+    }
+    return d->transport()->createCall("razer.device.lighting.chroma", "setCustom")->send(d->timeout);
+}
+
+Result<void> Device::tryDefineCustomFrame(uchar row, uchar startColumn, uchar endColumn, QVector<::openrazer::RGB> colorData)
+{
+    // The daemon reads the rows from the shared buffer once the frame is displayed
+    if (FrameBuffer *buffer = d->customFrameBuffer()) {
+        if (!buffer->writeRow(row, startColumn, endColumn, colorData))
+            return Error("Invalid custom frame row", QString("Row %1 from column %2 to %3 with %4 colors doesn't fit into the %5x%6 matrix").arg(row).arg(startColumn).arg(endColumn).arg(colorData.size()).arg(buffer->rows()).arg(buffer->columns()));
+        return Result<void>();
+    }
+
     QByteArray data;
     data.append(row);
     data.append(startColumn);
@@ -342,71 +502,139 @@ void Device::defineCustomFrame(uchar row, uchar startColumn, uchar endColumn, QV
         data.append(color.g);
         data.append(color.b);
     }
-    QDBusReply<void> reply = d->deviceLightingChromaIface()->call("setKeyRow", data);
-    handleDBusReply(reply, Q_FUNC_INFO);
+    std::unique_ptr<TransportCall> call = d->transport()->createCall("razer.device.lighting.chroma", "setKeyRow");
+    call->appendBytes(data);
+    return call->send(d->timeout);
 }
 
-::openrazer::MatrixDimensions Device::getMatrixDimensions()
+Result<::openrazer::MatrixDimensions> Device::tryGetMatrixDimensions()
 {
     QDBusReply<QList<int>> reply = d->deviceMiscIface()->call("getMatrixDimensions");
-    QList<int> dims = handleDBusReply(reply, Q_FUNC_INFO);
+    if (!reply.isValid())
+        return Error(reply.error());
+    QList<int> dims = reply.value();
     if (dims.size() != 2)
-        throw DBusException("Invalid return array from getMatrixDimensions", "The getMatrixDimensions return array has an invalid size.");
-    return { static_cast<uchar>(dims[0]), static_cast<uchar>(dims[1]) };
+        return Error("Invalid return array from getMatrixDimensions", "The getMatrixDimensions return array has an invalid size.");
+    return ::openrazer::MatrixDimensions { static_cast<uchar>(dims[0]), static_cast<uchar>(dims[1]) };
 }
 
-QDBusInterface *DevicePrivate::deviceMiscIface()
+DBusInterface *DevicePrivate::deviceMiscIface()
 {
     if (ifaceMisc == nullptr) {
-        ifaceMisc = new QDBusInterface(OPENRAZER_SERVICE_NAME, mObjectPath.path(), "razer.device.misc",
-                                       OPENRAZER_DBUS_BUS, mParent);
+        ifaceMisc = new DBusInterface(OPENRAZER_SERVICE_NAME, mObjectPath.path(), "razer.device.misc",
+                                      connection, mParent);
+        ifaceMisc->setTimeout(timeout);
     }
     if (!ifaceMisc->isValid()) {
-        fprintf(stderr, "%s\n",
-                qPrintable(OPENRAZER_DBUS_BUS.lastError().message()));
+        warnRateLimited(lcTransport(), Q_FUNC_INFO, mObjectPath.path(), connection.lastError().message());
     }
     return ifaceMisc;
 }
 
-QDBusInterface *DevicePrivate::deviceDpiIface()
+DBusInterface *DevicePrivate::deviceDpiIface()
 {
     if (ifaceDpi == nullptr) {
-        ifaceDpi = new QDBusInterface(OPENRAZER_SERVICE_NAME, mObjectPath.path(), "razer.device.dpi",
-                                      OPENRAZER_DBUS_BUS, mParent);
+        ifaceDpi = new DBusInterface(OPENRAZER_SERVICE_NAME, mObjectPath.path(), "razer.device.dpi",
+                                     connection, mParent);
+        ifaceDpi->setTimeout(timeout);
     }
     if (!ifaceDpi->isValid()) {
-        fprintf(stderr, "%s\n",
-                qPrintable(OPENRAZER_DBUS_BUS.lastError().message()));
+        warnRateLimited(lcTransport(), Q_FUNC_INFO, mObjectPath.path(), connection.lastError().message());
     }
     return ifaceDpi;
 }
 
-QDBusInterface *DevicePrivate::devicePowerIface()
+DBusInterface *DevicePrivate::devicePowerIface()
 {
     if (ifacePower == nullptr) {
-        ifacePower = new QDBusInterface(OPENRAZER_SERVICE_NAME, mObjectPath.path(), "razer.device.power",
-                                        OPENRAZER_DBUS_BUS, mParent);
+        ifacePower = new DBusInterface(OPENRAZER_SERVICE_NAME, mObjectPath.path(), "razer.device.power",
+                                       connection, mParent);
+        ifacePower->setTimeout(timeout);
     }
     if (!ifacePower->isValid()) {
-        fprintf(stderr, "%s\n",
-                qPrintable(OPENRAZER_DBUS_BUS.lastError().message()));
+        warnRateLimited(lcTransport(), Q_FUNC_INFO, mObjectPath.path(), connection.lastError().message());
     }
     return ifacePower;
 }
 
-QDBusInterface *DevicePrivate::deviceLightingChromaIface()
+DBusInterface *DevicePrivate::deviceLightingChromaIface()
 {
     if (ifaceLightingChroma == nullptr) {
-        ifaceLightingChroma = new QDBusInterface(OPENRAZER_SERVICE_NAME, mObjectPath.path(), "razer.device.lighting.chroma",
-                                                 OPENRAZER_DBUS_BUS, mParent);
+        ifaceLightingChroma = new DBusInterface(OPENRAZER_SERVICE_NAME, mObjectPath.path(), "razer.device.lighting.chroma",
+                                                connection, mParent);
+        ifaceLightingChroma->setTimeout(timeout);
     }
     if (!ifaceLightingChroma->isValid()) {
-        fprintf(stderr, "%s\n",
-                qPrintable(OPENRAZER_DBUS_BUS.lastError().message()));
+        warnRateLimited(lcTransport(), Q_FUNC_INFO, mObjectPath.path(), connection.lastError().message());
     }
     return ifaceLightingChroma;
 }
 
+PeerConnection *DevicePrivate::peerConnection()
+{
+    if (peer == nullptr)
+        peer = PeerConnection::forService(OPENRAZER_SERVICE_NAME, connection, "/org/razer", "razer.daemon");
+    return peer;
+}
+
+Transport *DevicePrivate::transport()
+{
+    if (frameTransport == nullptr)
+        frameTransport = std::make_unique<Transport>(OPENRAZER_SERVICE_NAME, mObjectPath.path(), connection, peerConnection());
+    return frameTransport.get();
+}
+
+Transport *DevicePrivate::controlTransport()
+{
+    if (setterTransport == nullptr)
+        setterTransport = std::make_unique<Transport>(OPENRAZER_SERVICE_NAME, mObjectPath.path(), connection);
+    return setterTransport.get();
+}
+
+/**
+ * Returns the shared custom frame buffer, setting it up and handing it to the daemon first if needed. Returns nullptr if the daemon or the system doesn't support it, setKeyRow and setCustom are used then.
+ */
+FrameBuffer *DevicePrivate::customFrameBuffer()
+{
+    int generation = deviceLightingChromaIface()->circuitBreaker()->ownerGeneration();
+    if (generation == frameBufferGeneration)
+        return frameBuffer.get();
+    // Also on failure, so an unsupported daemon isn't asked again for every row
+    frameBufferGeneration = generation;
+
+    if (frameBuffer == nullptr) {
+        if (!hasCapabilityInternal("razer.device.lighting.chroma", "setCustomFrameBuffer")
+            || !hasCapabilityInternal("razer.device.lighting.chroma", "displayCustomFrameBuffer"))
+            return nullptr;
+        if (!QDBusUnixFileDescriptor::isSupported())
+            return nullptr;
+        Result<::openrazer::MatrixDimensions> dimensions = mParent->tryGetMatrixDimensions();
+        if (!dimensions)
+            return nullptr;
+        frameBuffer.reset(FrameBuffer::create(dimensions.value().x, dimensions.value().y));
+        if (frameBuffer == nullptr)
+            return nullptr;
+    }
+
+    // Checked each time, the buffer is handed over the peer connection if there is one
+    if (!(peerConnection()->connectionCapabilities(timeout) & QDBusConnection::UnixFileDescriptorPassing)) {
+        qCDebug(lcDevice, "libopenrazer: Not using a shared frame buffer, the connection can't pass file descriptors");
+        frameBuffer.reset();
+        return nullptr;
+    }
+
+    // A restarted daemon has to be handed the buffer again, its content is kept
+    DBusCommand command = deviceLightingChromaIface()->prepareCall("setCustomFrameBuffer",
+                                                                   { QVariant::fromValue(frameBuffer->fileDescriptor()), QVariant::fromValue(frameBuffer->rows()), QVariant::fromValue(frameBuffer->columns()) });
+    QDBusReply<void> reply = peerConnection()->call(command.message, command.timeout);
+    if (!reply.isValid()) {
+        qCDebug(lcDevice, "libopenrazer: Not using a shared frame buffer: %s", qUtf8Printable(reply.error().message()));
+        frameBuffer.reset();
+        return nullptr;
+    }
+    return frameBuffer.get();
+}
+
 }
 
 }
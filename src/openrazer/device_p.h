@@ -8,7 +8,13 @@
 #include "libopenrazer/device.h"
 #include "libopenrazer/led.h"
 
-#include <QDBusInterface>
+#include "capabilitydatabase_p.h"
+#include "dbusinterface_p.h"
+#include "framebuffer_p.h"
+#include "peerconnection_p.h"
+#include "transport_p.h"
+
+#include <memory>
 
 namespace libopenrazer {
 
@@ -17,27 +23,55 @@ namespace openrazer {
 class DevicePrivate
 {
 public:
+    DevicePrivate(const QDBusObjectPath &objectPath, const QDBusConnection &connection, int timeout, const CapabilityIndex &introspection);
+
     Device *mParent = nullptr;
 
-    QDBusInterface *ifaceMisc = nullptr;
-    QDBusInterface *ifaceDpi = nullptr;
-    QDBusInterface *ifacePower = nullptr;
-    QDBusInterface *ifaceLightingChroma = nullptr;
-    QDBusInterface *deviceMiscIface();
-    QDBusInterface *deviceDpiIface();
-    QDBusInterface *devicePowerIface();
-    QDBusInterface *deviceLightingChromaIface();
+    // Also used by the Leds of the device
+    QDBusConnection connection;
+
+    DBusInterface *ifaceMisc = nullptr;
+    DBusInterface *ifaceDpi = nullptr;
+    DBusInterface *ifacePower = nullptr;
+    DBusInterface *ifaceLightingChroma = nullptr;
+    DBusInterface *deviceMiscIface();
+    DBusInterface *deviceDpiIface();
+    DBusInterface *devicePowerIface();
+    DBusInterface *deviceLightingChromaIface();
+
+    // Custom frames go over this, see PeerConnection
+    PeerConnection *peer = nullptr;
+    PeerConnection *peerConnection();
+    // The calls for custom frames are written through this, see Transport
+    std::unique_ptr<Transport> frameTransport;
+    Transport *transport();
+    // The setters of the device and its Leds, these stay on the bus
+    std::unique_ptr<Transport> setterTransport;
+    Transport *controlTransport();
+
+    // Shared custom frame, nullptr if the daemon doesn't support it, see FrameBuffer
+    std::unique_ptr<FrameBuffer> frameBuffer;
+    // Owner generation of the daemon the frame buffer was handed to
+    int frameBufferGeneration = -1;
+    FrameBuffer *customFrameBuffer();
 
     QDBusObjectPath mObjectPath;
+    int timeout = -1;
 
-    QStringList supportedFeatures;
+    Features supportedFeatures;
 
     QList<::libopenrazer::Led *> leds;
 
-    void introspect();
+    static QDBusMessage introspectMessage(const QDBusObjectPath &objectPath);
+    static CapabilityIndex introspect(const QDBusObjectPath &objectPath, const QDBusConnection &connection, int timeout);
+    static CapabilityIndex parseIntrospection(const QString &xml);
     void setupCapabilities();
     bool hasCapabilityInternal(const QString &interface, const QString &method = QString());
-    QStringList introspection;
+
+    // Read the replies of the getters, shared with Watcher
+    static Result<ushort> parsePollRate(const QDBusMessage &message);
+    static Result<::openrazer::DPI> parseDPI(const QDBusMessage &message);
+    CapabilityIndex introspection;
 
     // Maps LedId to "Chroma" or "Scroll" (the string put e.g. into setScrollSpectrum)
     QMap<::openrazer::LedId, QString> supportedLeds;
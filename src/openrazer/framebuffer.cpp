@@ -0,0 +1,88 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "framebuffer_p.h"
+#include "logging_p.h"
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace libopenrazer {
+
+namespace openrazer {
+
+FrameBuffer *FrameBuffer::create(uchar rows, uchar columns)
+{
+#if defined(Q_OS_LINUX) && defined(MFD_ALLOW_SEALING)
+    size_t size = size_t(rows) * columns * 3;
+    if (size == 0)
+        return nullptr;
+
+    int fd = memfd_create("libopenrazer-frame", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0) {
+        qCDebug(lcDevice, "libopenrazer: memfd_create failed: %s", strerror(errno));
+        return nullptr;
+    }
+    // The daemon maps the buffer as well, it must not shrink under its feet
+    if (ftruncate(fd, size) < 0 || fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) < 0) {
+        qCDebug(lcDevice, "libopenrazer: Failed to set up the frame buffer: %s", strerror(errno));
+        close(fd);
+        return nullptr;
+    }
+    void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        qCDebug(lcDevice, "libopenrazer: Failed to map the frame buffer: %s", strerror(errno));
+        close(fd);
+        return nullptr;
+    }
+    return new FrameBuffer(fd, static_cast<uchar *>(data), rows, columns);
+#else
+    Q_UNUSED(rows)
+    Q_UNUSED(columns)
+    return nullptr;
+#endif
+}
+
+FrameBuffer::FrameBuffer(int fd, uchar *data, uchar rows, uchar columns)
+    : m_fd(fd), m_data(data), m_rows(rows), m_columns(columns)
+{
+}
+
+FrameBuffer::~FrameBuffer()
+{
+#ifdef Q_OS_LINUX
+    munmap(m_data, size_t(m_rows) * m_columns * 3);
+    close(m_fd);
+#endif
+}
+
+QDBusUnixFileDescriptor FrameBuffer::fileDescriptor() const
+{
+    // Duplicates the descriptor, the buffer keeps its own
+    return QDBusUnixFileDescriptor(m_fd);
+}
+
+bool FrameBuffer::writeRow(uchar row, uchar startColumn, uchar endColumn, const QVector<::openrazer::RGB> &colors)
+{
+    if (row >= m_rows || endColumn >= m_columns || startColumn > endColumn
+        || colors.size() != endColumn - startColumn + 1)
+        return false;
+    uchar *pixel = m_data + (size_t(row) * m_columns + startColumn) * 3;
+    for (const ::openrazer::RGB &color : colors) {
+        *pixel++ = color.r;
+        *pixel++ = color.g;
+        *pixel++ = color.b;
+    }
+    return true;
+}
+
+}
+
+}
@@ -0,0 +1,67 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef OPENRAZER_FRAMEBUFFER_P_H
+#define OPENRAZER_FRAMEBUFFER_P_H
+
+#include "libopenrazer/openrazer.h"
+
+#include <QDBusUnixFileDescriptor>
+#include <QVector>
+
+namespace libopenrazer {
+
+namespace openrazer {
+
+/*
+ * Custom frame shared with the daemon through a memfd, Linux only.
+ *
+ * Daemons with the setCustomFrameBuffer(h fd, y rows, y columns) and
+ * displayCustomFrameBuffer(u frame) methods in razer.device.lighting.chroma
+ * get the file descriptor of the buffer once. Afterwards defineCustomFrame()
+ * only writes the rows into the shared memory, and displayCustomFrame() just
+ * sends the number of the frame to show. The buffer holds rows * columns RGB
+ * triplets, row by row, and is sealed against resizing so the daemon can map
+ * it safely.
+ */
+class FrameBuffer
+{
+public:
+    /*
+     * Returns a new buffer for a matrix of \a rows by \a columns, or nullptr
+     * if shared memory can't be used on this system.
+     */
+    static FrameBuffer *create(uchar rows, uchar columns);
+    ~FrameBuffer();
+
+    uchar rows() const { return m_rows; }
+    uchar columns() const { return m_columns; }
+    QDBusUnixFileDescriptor fileDescriptor() const;
+
+    /*
+     * Copies \a colors into \a row, from \a startColumn to \a endColumn
+     * inclusive. Returns false if they don't fit into the matrix, or if the
+     * number of colors doesn't match the columns, like the kernel driver does
+     * for setKeyRow.
+     */
+    bool writeRow(uchar row, uchar startColumn, uchar endColumn, const QVector<::openrazer::RGB> &colors);
+
+    // Numbers the frames handed to the daemon, so it can tell them apart
+    quint32 nextFrame() { return ++m_frame; }
+
+private:
+    FrameBuffer(int fd, uchar *data, uchar rows, uchar columns);
+
+    int m_fd;
+    uchar *m_data;
+    uchar m_rows;
+    uchar m_columns;
+    quint32 m_frame = 0;
+};
+
+}
+
+}
+
+#endif // OPENRAZER_FRAMEBUFFER_P_H
@@ -3,9 +3,11 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "device_p.h"
+#include "effectnames_p.h"
 #include "led_p.h"
 #include "libopenrazer.h"
 #include "libopenrazer_private.h"
+#include "writecache_p.h"
 
 #include <QDBusReply>
 
@@ -39,12 +41,16 @@ Led::Led(Device *device, QDBusObjectPath objectPath, ::openrazer::LedId ledId, Q
     }
 
     d->setupCapabilities();
+    d->setupMethods();
 }
 
 /*
  * Destructor
  */
-Led::~Led() = default;
+Led::~Led()
+{
+    delete d;
+}
 
 void LedPrivate::setupCapabilities()
 {
@@ -103,6 +109,156 @@ void LedPrivate::setupCapabilities()
     }
 }
 
+void LedPrivate::setupMethods()
+{
+    auto set = [this](Method method, DBusInterface *(LedPrivate::*accessor)(), const QString &name,
+                      const QList<QVariant> &fixedArgs = {}, bool passArgs = true) {
+        methods[method] = { accessor, name, fixedArgs, passArgs };
+    };
+    const QString &location = lightingLocationMethod;
+
+    set(GetEffect, &LedPrivate::ledIface, "get" + location + "Effect");
+    set(GetEffectColors, &LedPrivate::ledIface, "get" + location + "EffectColors");
+    set(GetWaveDir, &LedPrivate::ledIface, "get" + location + "WaveDir");
+
+    // Devices with On/Off effects need special handling, except for when
+    // openrazer already supports the "On" effect. Then we can treat it
+    // standard.
+    effectFromActive = supportedFx.contains(::openrazer::Effect::On)
+            && !device->d->hasCapabilityInternal(interface, "set" + location + "On");
+    if (isProfileLed()) {
+        set(GetActive, &LedPrivate::ledIface, "get" + location);
+        set(SetOff, &LedPrivate::ledIface, "set" + location, { false }, false);
+        set(SetOn, &LedPrivate::ledIface, "set" + location, { true }, false);
+    } else if (device->d->hasCapabilityInternal(interface, "set" + location + "Active")) {
+        set(GetActive, &LedPrivate::ledIface, "get" + location + "Active");
+        set(SetOff, &LedPrivate::ledIface, "set" + location + "Active", { false }, false);
+        set(SetOn, &LedPrivate::ledIface, "set" + location + "Active", { true }, false);
+    } else {
+        set(GetActive, &LedPrivate::ledIface, "get" + location + "Active");
+        set(SetOff, &LedPrivate::ledIface, "set" + location + "None");
+        set(SetOn, &LedPrivate::ledIface, "set" + location + "On");
+    }
+
+    // The bw2013 variants don't take a color
+    if (device->d->hasCapabilityInternal("razer.device.lighting.bw2013", "setStatic"))
+        set(SetStatic, &LedPrivate::ledBw2013Iface, "setStatic", {}, false);
+    else
+        set(SetStatic, &LedPrivate::ledIface, "set" + location + "Static");
+    if (device->d->hasCapabilityInternal("razer.device.lighting.bw2013", "setPulsate"))
+        set(SetBreathing, &LedPrivate::ledBw2013Iface, "setPulsate", {}, false);
+    else
+        set(SetBreathing, &LedPrivate::ledIface, "set" + location + "BreathSingle");
+
+    set(SetBreathingDual, &LedPrivate::ledIface, "set" + location + "BreathDual");
+    set(SetBreathingRandom, &LedPrivate::ledIface, "set" + location + "BreathRandom");
+    set(SetBreathingMono, &LedPrivate::ledIface, "set" + location + "BreathMono");
+    set(SetBlinking, &LedPrivate::ledIface, "set" + location + "Blinking");
+    set(SetSpectrum, &LedPrivate::ledIface, "set" + location + "Spectrum");
+    set(SetWave, &LedPrivate::ledIface, "set" + location + "Wave");
+    set(SetWheel, &LedPrivate::ledIface, "set" + location + "Wheel");
+    set(SetReactive, &LedPrivate::ledIface, "set" + location + "Reactive");
+    set(SetRipple, &LedPrivate::ledCustomIface, "setRipple");
+    set(SetRippleRandom, &LedPrivate::ledCustomIface, "setRippleRandomColour");
+
+    if (lightingLocation == "Chroma") {
+        set(SetBrightness, &LedPrivate::ledBrightnessIface, "setBrightness");
+        set(GetBrightness, &LedPrivate::ledBrightnessIface, "getBrightness");
+    } else {
+        set(SetBrightness, &LedPrivate::ledIface, "set" + location + "Brightness");
+        set(GetBrightness, &LedPrivate::ledIface, "get" + location + "Brightness");
+    }
+}
+
+static QList<QVariant> methodArguments(const LedPrivate::MethodInfo &info, const QList<QVariant> &args)
+{
+    if (!info.passArgs)
+        return info.fixedArgs;
+    if (info.fixedArgs.isEmpty())
+        return args;
+    return info.fixedArgs + args;
+}
+
+QDBusMessage LedPrivate::callMethod(Method method, const QList<QVariant> &args)
+{
+    const MethodInfo &info = methods[method];
+    return (this->*info.accessor)()->callWithArgumentList(info.name, methodArguments(info, args));
+}
+
+// The Set* effect methods are in the same order as ::openrazer::Effect
+static constexpr ::openrazer::Effect effectOf(LedPrivate::Method method)
+{
+    return static_cast<::openrazer::Effect>(method - LedPrivate::SetOff);
+}
+
+static_assert(effectOf(LedPrivate::SetOff) == ::openrazer::Effect::Off);
+static_assert(effectOf(LedPrivate::SetOn) == ::openrazer::Effect::On);
+static_assert(effectOf(LedPrivate::SetStatic) == ::openrazer::Effect::Static);
+static_assert(effectOf(LedPrivate::SetBreathing) == ::openrazer::Effect::Breathing);
+static_assert(effectOf(LedPrivate::SetBreathingDual) == ::openrazer::Effect::BreathingDual);
+static_assert(effectOf(LedPrivate::SetBreathingRandom) == ::openrazer::Effect::BreathingRandom);
+static_assert(effectOf(LedPrivate::SetBreathingMono) == ::openrazer::Effect::BreathingMono);
+static_assert(effectOf(LedPrivate::SetBlinking) == ::openrazer::Effect::Blinking);
+static_assert(effectOf(LedPrivate::SetSpectrum) == ::openrazer::Effect::Spectrum);
+static_assert(effectOf(LedPrivate::SetWave) == ::openrazer::Effect::Wave);
+static_assert(effectOf(LedPrivate::SetWheel) == ::openrazer::Effect::Wheel);
+static_assert(effectOf(LedPrivate::SetReactive) == ::openrazer::Effect::Reactive);
+static_assert(effectOf(LedPrivate::SetRipple) == ::openrazer::Effect::Ripple);
+static_assert(effectOf(LedPrivate::SetRippleRandom) == ::openrazer::Effect::RippleRandom);
+
+// The arguments of the setters, written with their D-Bus type
+static void appendArgument(TransportCall *call, uchar value)
+{
+    call->appendByte(value);
+}
+
+static void appendArgument(TransportCall *call, int value)
+{
+    call->appendInt32(value);
+}
+
+static void appendArgument(TransportCall *call, double value)
+{
+    call->appendDouble(value);
+}
+
+// The daemon takes the colors as three separate bytes
+static void appendArgument(TransportCall *call, const ::openrazer::RGB &color)
+{
+    call->appendByte(color.r);
+    call->appendByte(color.g);
+    call->appendByte(color.b);
+}
+
+template<typename... Args>
+Result<void> LedPrivate::sendMethod(Method method, const Args &...args)
+{
+    const MethodInfo &info = methods[method];
+    std::unique_ptr<TransportCall> call = device->d->controlTransport()->createCall((this->*info.accessor)()->interface().toLatin1().constData(),
+                                                                                    info.name.toLatin1().constData());
+    // Only the On/Off setters of the Active and profile LED methods have fixed arguments, the state
+    for (const QVariant &arg : info.fixedArgs)
+        call->appendBool(arg.toBool());
+    if (info.passArgs)
+        (appendArgument(call.get(), args), ...);
+    return call->send(device->d->timeout);
+}
+
+template<typename... Args>
+Result<void> LedPrivate::setEffect(WriteCache *cache, Method method, const Args &...args)
+{
+    QVariantList value { static_cast<int>(effectOf(method)), QVariant::fromValue(args)... };
+    return cachedWrite(cache, (this->*methods[method].accessor)(), WriteCache::Effect, value, [&]() {
+        return sendMethod(method, args...);
+    });
+}
+
+DBusCommand LedPrivate::prepareMethod(Method method, const QList<QVariant> &args)
+{
+    const MethodInfo &info = methods[method];
+    return (this->*info.accessor)()->prepareCall(info.name, methodArguments(info, args));
+}
+
 QDBusObjectPath Led::getObjectPath()
 {
     return d->mObjectPath;
@@ -118,91 +274,30 @@ bool Led::hasFx(::openrazer::Effect fx)
     return d->supportedFx.contains(fx);
 }
 
-::openrazer::Effect Led::getCurrentEffect()
+Result<::openrazer::Effect> Led::tryGetCurrentEffect()
 {
     // OpenRazer doesn't expose get*Effect when there's no effect supported.
     if (!d->hasFx()) {
         return ::openrazer::Effect::Off;
     }
 
-    // Devices with On/Off effects need special handling, except for when
-    // openrazer already supports the "On" effect. Then we can treat it
-    // standard.
-    if (hasFx(::openrazer::Effect::On) &&
-            !d->device->d->hasCapabilityInternal(d->interface, "set" + d->lightingLocationMethod + "On")) {
-        QDBusReply<bool> reply;
-        if (d->isProfileLed())
-            reply = d->ledIface()->call("get" + d->lightingLocationMethod);
-        else
-            reply = d->ledIface()->call("get" + d->lightingLocationMethod + "Active");
-        bool on = handleDBusReply(reply, Q_FUNC_INFO);
-        return on ? ::openrazer::Effect::On : ::openrazer::Effect::Off;
-    }
-
-    QDBusReply<QString> reply = d->ledIface()->call("get" + d->lightingLocationMethod + "Effect");
-    QString effect = handleDBusReply(reply, Q_FUNC_INFO);
-    // TODO:
-    // * breathTriple
-    // * starlightSingle
-    // * starlightDual
-    // * starlightRandom
-    if (effect == "none") {
-        return ::openrazer::Effect::Off;
-    } else if (effect == "on") {
-        return ::openrazer::Effect::On;
-    } else if (effect == "static") {
-        return ::openrazer::Effect::Static;
-    } else if (effect == "breathSingle" || effect == "pulsate") {
-        return ::openrazer::Effect::Breathing;
-    } else if (effect == "breathDual") {
-        return ::openrazer::Effect::BreathingDual;
-    } else if (effect == "breathRandom") {
-        return ::openrazer::Effect::BreathingRandom;
-    } else if (effect == "breathMono") {
-        return ::openrazer::Effect::BreathingMono;
-    } else if (effect == "blinking") {
-        return ::openrazer::Effect::Blinking;
-    } else if (effect == "spectrum") {
-        return ::openrazer::Effect::Spectrum;
-    } else if (effect == "wave") {
-        return ::openrazer::Effect::Wave;
-    } else if (effect == "wheel") {
-        return ::openrazer::Effect::Wheel;
-    } else if (effect == "reactive") {
-        return ::openrazer::Effect::Reactive;
-    } else if (effect == "ripple") {
-        return ::openrazer::Effect::Ripple;
-    } else if (effect == "rippleRandomColour") {
-        return ::openrazer::Effect::RippleRandom;
-    } else {
-        qWarning("libopenrazer: Unhandled effect in getCurrentEffect: %s, defaulting to Spectrum", qUtf8Printable(effect));
-        return ::openrazer::Effect::Spectrum;
-    }
+    Result<::openrazer::Effect> result = d->parseEffect(d->callMethod(d->effectMethod()));
+    observeRead(writeCache(), result);
+    return result;
 }
 
-QVector<::openrazer::RGB> Led::getCurrentColors()
+Result<QVector<::openrazer::RGB>> Led::tryGetCurrentColors()
 {
     // OpenRazer doesn't expose get*EffectColors when there's no effect supported.
     // Also profile LEDs don't support any color
     if (!d->hasFx() || d->isProfileLed()) {
-        return {};
+        return QVector<::openrazer::RGB>();
     }
 
-    QDBusReply<QByteArray> reply = d->ledIface()->call("get" + d->lightingLocationMethod + "EffectColors");
-    QByteArray values = handleDBusReply(reply, Q_FUNC_INFO);
-    if (values.size() % 3 != 0) {
-        throw DBusException("Invalid return array from EffectColors", "The EffectColors return array has an invalid size.");
-    }
-    QVector<::openrazer::RGB> colors;
-    for (int i = 0; i < values.size() / 3; i++) {
-        colors.append({ static_cast<uchar>(values[i * 3]),
-                        static_cast<uchar>(values[i * 3 + 1]),
-                        static_cast<uchar>(values[i * 3 + 2]) });
-    }
-    return colors;
+    return LedPrivate::parseColors(d->callMethod(LedPrivate::GetEffectColors));
 }
 
-::openrazer::WaveDirection Led::getWaveDirection()
+Result<::openrazer::WaveDirection> Led::tryGetWaveDirection()
 {
     // OpenRazer doesn't expose get*WaveDir when there's no effect supported.
     // Also profile LEDs don't support any wave direction
@@ -210,141 +305,202 @@ QVector<::openrazer::RGB> Led::getCurrentColors()
         return ::openrazer::WaveDirection::LEFT_TO_RIGHT;
     }
 
-    QDBusReply<int> reply = d->ledIface()->call("get" + d->lightingLocationMethod + "WaveDir");
-    int value = handleDBusReply(reply, Q_FUNC_INFO);
-    return static_cast<::openrazer::WaveDirection>(value);
+    QDBusReply<int> reply = d->callMethod(LedPrivate::GetWaveDir);
+    if (!reply.isValid())
+        return Error(reply.error());
+    return static_cast<::openrazer::WaveDirection>(reply.value());
 }
 
-::openrazer::LedId Led::getLedId()
+Result<::openrazer::LedId> Led::tryGetLedId()
 {
     return d->ledId;
 }
 
-void Led::setOff()
+Result<void> Led::trySetOff()
 {
-    QDBusReply<void> reply;
-    if (d->isProfileLed())
-        reply = d->ledIface()->call("set" + d->lightingLocationMethod, false);
-    else if (d->device->d->hasCapabilityInternal(d->interface, "set" + d->lightingLocationMethod + "Active"))
-        reply = d->ledIface()->call("set" + d->lightingLocationMethod + "Active", false);
-    else
-        reply = d->ledIface()->call("set" + d->lightingLocationMethod + "None");
-    handleDBusReply(reply, Q_FUNC_INFO);
+    return d->setEffect(writeCache(), LedPrivate::SetOff);
 }
 
-void Led::setOn()
+Result<void> Led::trySetOn()
 {
-    QDBusReply<void> reply;
-    if (d->isProfileLed())
-        reply = d->ledIface()->call("set" + d->lightingLocationMethod, true);
-    else if (d->device->d->hasCapabilityInternal(d->interface, "set" + d->lightingLocationMethod + "Active"))
-        reply = d->ledIface()->call("set" + d->lightingLocationMethod + "Active", true);
-    else
-        reply = d->ledIface()->call("set" + d->lightingLocationMethod + "On");
-    handleDBusReply(reply, Q_FUNC_INFO);
+    return d->setEffect(writeCache(), LedPrivate::SetOn);
 }
 
-void Led::setStatic(::openrazer::RGB color)
+Result<void> Led::trySetStatic(::openrazer::RGB color)
 {
-    QDBusReply<void> reply;
-    if (d->device->d->hasCapabilityInternal("razer.device.lighting.bw2013", "setStatic"))
-        reply = d->ledBw2013Iface()->call("setStatic");
-    else
-        reply = d->ledIface()->call("set" + d->lightingLocationMethod + "Static", RGB_TO_QVARIANT(color));
-    handleDBusReply(reply, Q_FUNC_INFO);
+    return d->setEffect(writeCache(), LedPrivate::SetStatic, color);
 }
 
-void Led::setBreathing(::openrazer::RGB color)
+Result<void> Led::trySetBreathing(::openrazer::RGB color)
 {
-    QDBusReply<void> reply;
-    if (d->device->d->hasCapabilityInternal("razer.device.lighting.bw2013", "setPulsate"))
-        reply = d->ledBw2013Iface()->call("setPulsate");
-    else
-        reply = d->ledIface()->call("set" + d->lightingLocationMethod + "BreathSingle", RGB_TO_QVARIANT(color));
-    handleDBusReply(reply, Q_FUNC_INFO);
+    return d->setEffect(writeCache(), LedPrivate::SetBreathing, color);
 }
 
-void Led::setBreathingDual(::openrazer::RGB color, ::openrazer::RGB color2)
+Result<void> Led::trySetBreathingDual(::openrazer::RGB color, ::openrazer::RGB color2)
 {
-    QDBusReply<void> reply = d->ledIface()->call("set" + d->lightingLocationMethod + "BreathDual", RGB_TO_QVARIANT(color), RGB_TO_QVARIANT(color2));
-    handleDBusReply(reply, Q_FUNC_INFO);
+    return d->setEffect(writeCache(), LedPrivate::SetBreathingDual, color, color2);
 }
 
-void Led::setBreathingRandom()
+Result<void> Led::trySetBreathingRandom()
 {
-    QDBusReply<void> reply = d->ledIface()->call("set" + d->lightingLocationMethod + "BreathRandom");
-    handleDBusReply(reply, Q_FUNC_INFO);
+    return d->setEffect(writeCache(), LedPrivate::SetBreathingRandom);
 }
 
-void Led::setBreathingMono()
+Result<void> Led::trySetBreathingMono()
 {
-    QDBusReply<void> reply = d->ledIface()->call("set" + d->lightingLocationMethod + "BreathMono");
-    handleDBusReply(reply, Q_FUNC_INFO);
+    return d->setEffect(writeCache(), LedPrivate::SetBreathingMono);
 }
 
-void Led::setBlinking(::openrazer::RGB color)
+Result<void> Led::trySetBlinking(::openrazer::RGB color)
 {
-    QDBusReply<void> reply = d->ledIface()->call("set" + d->lightingLocationMethod + "Blinking", RGB_TO_QVARIANT(color));
-    handleDBusReply(reply, Q_FUNC_INFO);
+    return d->setEffect(writeCache(), LedPrivate::SetBlinking, color);
 }
 
-void Led::setSpectrum()
+Result<void> Led::trySetSpectrum()
 {
-    QDBusReply<void> reply = d->ledIface()->call("set" + d->lightingLocationMethod + "Spectrum");
-    handleDBusReply(reply, Q_FUNC_INFO);
+    return d->setEffect(writeCache(), LedPrivate::SetSpectrum);
 }
 
-void Led::setWave(::openrazer::WaveDirection direction)
+Result<void> Led::trySetWave(::openrazer::WaveDirection direction)
 {
-    QDBusReply<void> reply = d->ledIface()->call("set" + d->lightingLocationMethod + "Wave", static_cast<int>(direction));
-    handleDBusReply(reply, Q_FUNC_INFO);
+    return d->setEffect(writeCache(), LedPrivate::SetWave, static_cast<int>(direction));
 }
 
-void Led::setWheel(::openrazer::WheelDirection direction)
+Result<void> Led::trySetWheel(::openrazer::WheelDirection direction)
 {
-    QDBusReply<void> reply = d->ledIface()->call("set" + d->lightingLocationMethod + "Wheel", static_cast<int>(direction));
-    handleDBusReply(reply, Q_FUNC_INFO);
+    return d->setEffect(writeCache(), LedPrivate::SetWheel, static_cast<int>(direction));
 }
 
-void Led::setReactive(::openrazer::RGB color, ::openrazer::ReactiveSpeed speed)
+Result<void> Led::trySetReactive(::openrazer::RGB color, ::openrazer::ReactiveSpeed speed)
 {
-    QDBusReply<void> reply = d->ledIface()->call("set" + d->lightingLocationMethod + "Reactive", RGB_TO_QVARIANT(color), static_cast<uchar>(speed));
-    handleDBusReply(reply, Q_FUNC_INFO);
+    return d->setEffect(writeCache(), LedPrivate::SetReactive, color, static_cast<uchar>(speed));
 }
 
-void Led::setRipple(::openrazer::RGB color)
+Result<void> Led::trySetRipple(::openrazer::RGB color)
 {
-    QDBusReply<void> reply = d->ledCustomIface()->call("setRipple", RGB_TO_QVARIANT(color), 0.05);
-    handleDBusReply(reply, Q_FUNC_INFO);
+    return d->setEffect(writeCache(), LedPrivate::SetRipple, color, 0.05);
 }
 
-void Led::setRippleRandom()
+Result<void> Led::trySetRippleRandom()
 {
-    QDBusReply<void> reply = d->ledCustomIface()->call("setRippleRandomColour", 0.05);
-    handleDBusReply(reply, Q_FUNC_INFO);
+    return d->setEffect(writeCache(), LedPrivate::SetRippleRandom, 0.05);
 }
 
-void Led::setBrightness(uchar brightness)
+Result<void> Led::trySetBrightness(uchar brightness)
 {
-    double dbusBrightness = (double)brightness / 255 * 100;
-    QDBusReply<void> reply;
-    if (d->lightingLocation == "Chroma")
-        reply = d->ledBrightnessIface()->call("setBrightness", QVariant::fromValue(dbusBrightness));
-    else
-        reply = d->ledIface()->call("set" + d->lightingLocationMethod + "Brightness", QVariant::fromValue(dbusBrightness));
-    handleDBusReply(reply, Q_FUNC_INFO);
+    return cachedWrite(writeCache(), d->ledIface(), WriteCache::Brightness, QVariant::fromValue(brightness), [&]() {
+        return d->sendMethod(LedPrivate::SetBrightness, LedPrivate::brightnessToPercent(brightness));
+    });
 }
 
-uchar Led::getBrightness()
+Result<DBusCommand> Led::prepareSetBrightness(uchar brightness)
 {
-    QDBusReply<double> reply;
-    if (d->lightingLocation == "Chroma")
-        reply = d->ledBrightnessIface()->call("getBrightness");
-    else
-        reply = d->ledIface()->call("get" + d->lightingLocationMethod + "Brightness");
+    return d->prepareMethod(LedPrivate::SetBrightness, { LedPrivate::brightnessToPercent(brightness) });
+}
+
+Result<uchar> Led::tryGetBrightness()
+{
+    Result<uchar> result = LedPrivate::parseBrightness(d->callMethod(LedPrivate::GetBrightness));
+    observeRead(writeCache(), WriteCache::Brightness, result);
+    return result;
+}
 
-    double value = handleDBusReply(reply, Q_FUNC_INFO);
-    return value / 100 * 255;
+Result<DBusCommand> Led::prepareEffect(::openrazer::Effect effect, const EffectParams &params)
+{
+    switch (effect) {
+    case ::openrazer::Effect::Off:
+        return d->prepareMethod(LedPrivate::SetOff);
+    case ::openrazer::Effect::On:
+        return d->prepareMethod(LedPrivate::SetOn);
+    case ::openrazer::Effect::Static:
+        return d->prepareMethod(LedPrivate::SetStatic, { RGB_TO_QVARIANT(params.color) });
+    case ::openrazer::Effect::Breathing:
+        return d->prepareMethod(LedPrivate::SetBreathing, { RGB_TO_QVARIANT(params.color) });
+    case ::openrazer::Effect::BreathingDual:
+        return d->prepareMethod(LedPrivate::SetBreathingDual, { RGB_TO_QVARIANT(params.color), RGB_TO_QVARIANT(params.color2) });
+    case ::openrazer::Effect::BreathingRandom:
+        return d->prepareMethod(LedPrivate::SetBreathingRandom);
+    case ::openrazer::Effect::BreathingMono:
+        return d->prepareMethod(LedPrivate::SetBreathingMono);
+    case ::openrazer::Effect::Blinking:
+        return d->prepareMethod(LedPrivate::SetBlinking, { RGB_TO_QVARIANT(params.color) });
+    case ::openrazer::Effect::Spectrum:
+        return d->prepareMethod(LedPrivate::SetSpectrum);
+    case ::openrazer::Effect::Wave:
+        return d->prepareMethod(LedPrivate::SetWave, { static_cast<int>(params.waveDirection) });
+    case ::openrazer::Effect::Wheel:
+        return d->prepareMethod(LedPrivate::SetWheel, { static_cast<int>(params.wheelDirection) });
+    case ::openrazer::Effect::Reactive:
+        return d->prepareMethod(LedPrivate::SetReactive, { RGB_TO_QVARIANT(params.color), static_cast<uchar>(params.reactiveSpeed) });
+    case ::openrazer::Effect::Ripple:
+        return d->prepareMethod(LedPrivate::SetRipple, { RGB_TO_QVARIANT(params.color), 0.05 });
+    case ::openrazer::Effect::RippleRandom:
+        return d->prepareMethod(LedPrivate::SetRippleRandom, { 0.05 });
+    }
+    return notSupportedError("The effect is not supported by this Led.");
+}
+
+LedPrivate::Method LedPrivate::effectMethod()
+{
+    return effectFromActive ? GetActive : GetEffect;
+}
+
+Result<::openrazer::Effect> LedPrivate::parseEffect(const QDBusMessage &message)
+{
+    if (effectFromActive) {
+        QDBusReply<bool> reply = message;
+        if (!reply.isValid())
+            return Error(reply.error());
+        return reply.value() ? ::openrazer::Effect::On : ::openrazer::Effect::Off;
+    }
+
+    QDBusReply<QString> reply = message;
+    if (!reply.isValid())
+        return Error(reply.error());
+    QString effect = reply.value();
+    ::openrazer::Effect fx;
+    if (effectnames::effectFromName(EFFECT_NAMES, effect, &fx)) {
+        return fx;
+    }
+    warnRateLimited(lcLed(), Q_FUNC_INFO, mObjectPath.path(), QString("Unhandled effect in getCurrentEffect: %1, defaulting to Spectrum").arg(effect));
+    return ::openrazer::Effect::Spectrum;
+}
+
+Result<QVector<::openrazer::RGB>> LedPrivate::parseColors(const QDBusMessage &message)
+{
+    QDBusReply<QByteArray> reply = message;
+    if (!reply.isValid())
+        return Error(reply.error());
+    QByteArray values = reply.value();
+    if (values.size() % 3 != 0) {
+        return Error("Invalid return array from EffectColors", "The EffectColors return array has an invalid size.");
+    }
+    QVector<::openrazer::RGB> colors;
+    for (int i = 0; i < values.size() / 3; i++) {
+        colors.append({ static_cast<uchar>(values[i * 3]),
+                        static_cast<uchar>(values[i * 3 + 1]),
+                        static_cast<uchar>(values[i * 3 + 2]) });
+    }
+    return colors;
+}
+
+Result<uchar> LedPrivate::parseBrightness(const QDBusMessage &message)
+{
+    QDBusReply<double> reply = message;
+    if (!reply.isValid())
+        return Error(reply.error());
+    return brightnessFromPercent(reply.value());
+}
+
+double LedPrivate::brightnessToPercent(uchar brightness)
+{
+    return static_cast<double>(brightness) / 255 * 100;
+}
+
+uchar LedPrivate::brightnessFromPercent(double percent)
+{
+    // Truncating would turn e.g. 15 into 14
+    return static_cast<uchar>(qBound(0, qRound(percent / 100 * 255), 255));
 }
 
 bool LedPrivate::hasFx()
@@ -359,54 +515,54 @@ bool LedPrivate::isProfileLed()
             || ledId == ::openrazer::LedId::KeymapBlueLED;
 }
 
-QDBusInterface *LedPrivate::ledIface()
+DBusInterface *LedPrivate::ledIface()
 {
     if (iface == nullptr) {
-        iface = new QDBusInterface(OPENRAZER_SERVICE_NAME, mObjectPath.path(), interface,
-                                   OPENRAZER_DBUS_BUS, mParent);
+        iface = new DBusInterface(OPENRAZER_SERVICE_NAME, mObjectPath.path(), interface,
+                                  device->d->connection, mParent);
+        iface->setTimeout(device->d->timeout);
     }
     if (!iface->isValid()) {
-        fprintf(stderr, "%s\n",
-                qPrintable(OPENRAZER_DBUS_BUS.lastError().message()));
+        warnRateLimited(lcTransport(), Q_FUNC_INFO, mObjectPath.path(), device->d->connection.lastError().message());
     }
     return iface;
 }
 
-QDBusInterface *LedPrivate::ledBrightnessIface()
+DBusInterface *LedPrivate::ledBrightnessIface()
 {
     if (ifaceBrightness == nullptr) {
-        ifaceBrightness = new QDBusInterface(OPENRAZER_SERVICE_NAME, mObjectPath.path(), "razer.device.lighting.brightness",
-                                             OPENRAZER_DBUS_BUS, mParent);
+        ifaceBrightness = new DBusInterface(OPENRAZER_SERVICE_NAME, mObjectPath.path(), "razer.device.lighting.brightness",
+                                            device->d->connection, mParent);
+        ifaceBrightness->setTimeout(device->d->timeout);
     }
     if (!ifaceBrightness->isValid()) {
-        fprintf(stderr, "%s\n",
-                qPrintable(OPENRAZER_DBUS_BUS.lastError().message()));
+        warnRateLimited(lcTransport(), Q_FUNC_INFO, mObjectPath.path(), device->d->connection.lastError().message());
     }
     return ifaceBrightness;
 }
 
-QDBusInterface *LedPrivate::ledBw2013Iface()
+DBusInterface *LedPrivate::ledBw2013Iface()
 {
     if (ifaceBw2013 == nullptr) {
-        ifaceBw2013 = new QDBusInterface(OPENRAZER_SERVICE_NAME, mObjectPath.path(), "razer.device.lighting.bw2013",
-                                         OPENRAZER_DBUS_BUS, mParent);
+        ifaceBw2013 = new DBusInterface(OPENRAZER_SERVICE_NAME, mObjectPath.path(), "razer.device.lighting.bw2013",
+                                        device->d->connection, mParent);
+        ifaceBw2013->setTimeout(device->d->timeout);
     }
     if (!ifaceBw2013->isValid()) {
-        fprintf(stderr, "%s\n",
-                qPrintable(OPENRAZER_DBUS_BUS.lastError().message()));
+        warnRateLimited(lcTransport(), Q_FUNC_INFO, mObjectPath.path(), device->d->connection.lastError().message());
     }
     return ifaceBw2013;
 }
 
-QDBusInterface *LedPrivate::ledCustomIface()
+DBusInterface *LedPrivate::ledCustomIface()
 {
     if (ifaceCustom == nullptr) {
-        ifaceCustom = new QDBusInterface(OPENRAZER_SERVICE_NAME, mObjectPath.path(), "razer.device.lighting.custom",
-                                         OPENRAZER_DBUS_BUS, mParent);
+        ifaceCustom = new DBusInterface(OPENRAZER_SERVICE_NAME, mObjectPath.path(), "razer.device.lighting.custom",
+                                        device->d->connection, mParent);
+        ifaceCustom->setTimeout(device->d->timeout);
     }
     if (!ifaceCustom->isValid()) {
-        fprintf(stderr, "%s\n",
-                qPrintable(OPENRAZER_DBUS_BUS.lastError().message()));
+        warnRateLimited(lcTransport(), Q_FUNC_INFO, mObjectPath.path(), device->d->connection.lastError().message());
     }
     return ifaceCustom;
 }
@@ -7,7 +7,7 @@
 
 #include "libopenrazer/led.h"
 
-#include <QDBusInterface>
+#include "dbusinterface_p.h"
 
 namespace libopenrazer {
 
@@ -18,14 +18,14 @@ class LedPrivate
 public:
     Led *mParent = nullptr;
 
-    QDBusInterface *iface = nullptr;
-    QDBusInterface *ifaceBrightness = nullptr;
-    QDBusInterface *ifaceBw2013 = nullptr;
-    QDBusInterface *ifaceCustom = nullptr;
-    QDBusInterface *ledIface();
-    QDBusInterface *ledBrightnessIface();
-    QDBusInterface *ledBw2013Iface();
-    QDBusInterface *ledCustomIface();
+    DBusInterface *iface = nullptr;
+    DBusInterface *ifaceBrightness = nullptr;
+    DBusInterface *ifaceBw2013 = nullptr;
+    DBusInterface *ifaceCustom = nullptr;
+    DBusInterface *ledIface();
+    DBusInterface *ledBrightnessIface();
+    DBusInterface *ledBw2013Iface();
+    DBusInterface *ledCustomIface();
 
     Device *device;
     QDBusObjectPath mObjectPath;
@@ -41,6 +41,63 @@ public:
     bool hasFx();
     bool isProfileLed();
     void setupCapabilities();
+
+    // The D-Bus methods called by the Led, resolved once by setupMethods()
+    enum Method {
+        GetEffect,
+        GetActive,
+        GetEffectColors,
+        GetWaveDir,
+        GetBrightness,
+        SetOff,
+        SetOn,
+        SetStatic,
+        SetBreathing,
+        SetBreathingDual,
+        SetBreathingRandom,
+        SetBreathingMono,
+        SetBlinking,
+        SetSpectrum,
+        SetWave,
+        SetWheel,
+        SetReactive,
+        SetRipple,
+        SetRippleRandom,
+        SetBrightness,
+        MethodCount,
+    };
+    struct MethodInfo {
+        DBusInterface *(LedPrivate::*accessor)() = nullptr;
+        QString name;
+        // Arguments sent in front of the ones passed to callMethod()
+        QList<QVariant> fixedArgs;
+        // If the arguments passed to callMethod() are sent at all
+        bool passArgs = true;
+    };
+    MethodInfo methods[MethodCount];
+    // If only On/Off is supported and the current effect is read with GetActive
+    bool effectFromActive = false;
+
+    void setupMethods();
+    QDBusMessage callMethod(Method method, const QList<QVariant> &args = {});
+    // Like callMethod() for the setters, sent through the Transport of the device, defined in led.cpp
+    template<typename... Args>
+    Result<void> sendMethod(Method method, const Args &...args);
+    DBusCommand prepareMethod(Method method, const QList<QVariant> &args = {});
+    // The method that tells the current effect, either GetEffect or GetActive
+    Method effectMethod();
+
+    // Read the replies of the getters, shared with Watcher
+    Result<::openrazer::Effect> parseEffect(const QDBusMessage &message);
+    static Result<QVector<::openrazer::RGB>> parseColors(const QDBusMessage &message);
+    static Result<uchar> parseBrightness(const QDBusMessage &message);
+    // The daemon uses percent, rounded so every value survives the round trip
+    static double brightnessToPercent(uchar brightness);
+    static uchar brightnessFromPercent(double percent);
+
+    // Calls one of the Set* effect methods through the write cache of the Led, defined in led.cpp
+    template<typename... Args>
+    Result<void> setEffect(WriteCache *cache, Method method, const Args &...args);
 };
 
 }
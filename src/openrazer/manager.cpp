@@ -2,24 +2,37 @@
 //
 // SPDX-License-Identifier: GPL-3.0-or-later
 
+#include "device_p.h"
 #include "libopenrazer.h"
 #include "libopenrazer_private.h"
 #include "manager_p.h"
 
 #include <QDBusMetaType>
 #include <QDBusReply>
-#include <QFileInfo>
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
-#include <QProcess>
+#include <QtConcurrent>
 
 namespace libopenrazer {
 
 namespace openrazer {
 
+const char *OPENRAZER_SERVICE_NAME = "org.razer";
+
+QDBusConnection defaultConnection()
+{
+    return QDBusConnection::sessionBus();
+}
+
 Manager::Manager()
+    : Manager(defaultConnection())
 {
-    d = new ManagerPrivate();
+}
+
+Manager::Manager(const QDBusConnection &connection)
+{
+    d = new ManagerPrivate(connection);
     d->mParent = this;
 
     // Register the enums with the Qt system
@@ -32,154 +45,288 @@ bool Manager::isDaemonRunning()
     return reply.isValid();
 }
 
-QVariantHash Manager::getSupportedDevices()
+Result<DeviceCatalog> Manager::tryGetDeviceCatalog()
+{
+    auto fetch = [this](const QString &version) -> Result<DeviceCatalog> {
+        QDBusReply<QString> reply = d->managerDevicesIface()->call("supportedDevices");
+        if (!reply.isValid())
+            return Error(reply.error());
+        // Maps the name of each device to [VID, PID]
+        const QJsonObject devices = QJsonDocument::fromJson(reply.value().toUtf8()).object();
+        DeviceCatalog catalog(version);
+        for (auto it = devices.constBegin(); it != devices.constEnd(); ++it) {
+            const QJsonArray ids = it.value().toArray();
+            catalog.insert(it.key(), ids.at(0).toInt(), ids.at(1).toInt());
+        }
+        return catalog;
+    };
+    return d->catalog.get(d->managerDevicesIface()->circuitBreaker(), deviceCatalogCacheFile(),
+                          [this]() { return tryGetDaemonVersion(); }, fetch);
+}
+
+Result<QList<QDBusObjectPath>> Manager::tryGetDevices()
+{
+    return parseDevices(d->managerDevicesIface()->call("getDevices"));
+}
+
+Result<DBusCommand> Manager::prepareGetDevices()
 {
-    QDBusReply<QString> reply = d->managerDevicesIface()->call("supportedDevices");
-    QString content = handleDBusReply(reply, Q_FUNC_INFO);
-    return QJsonDocument::fromJson(content.toUtf8()).object().toVariantHash();
+    return d->managerDevicesIface()->prepareCall("getDevices");
 }
 
-QList<QDBusObjectPath> Manager::getDevices()
+Result<QList<QDBusObjectPath>> Manager::parseDevices(const QDBusMessage &message)
 {
-    QDBusReply<QStringList> reply = d->managerDevicesIface()->call("getDevices");
-    QStringList serialList = handleDBusReply(reply, Q_FUNC_INFO);
+    QDBusReply<QStringList> reply = message;
+    if (!reply.isValid())
+        return Error(reply.error());
     QList<QDBusObjectPath> ret;
-    for (const QString &serial : serialList) {
+    for (const QString &serial : reply.value()) {
         ret.append(QDBusObjectPath("/org/razer/device/" + serial));
     }
     return ret;
 }
 
+Result<DBusCommand> Manager::prepareGetSerial(const QDBusObjectPath &objectPath)
+{
+    DBusCommand command;
+    command.message = QDBusMessage::createMethodCall(OPENRAZER_SERVICE_NAME, objectPath.path(), "razer.device.misc", "getSerial");
+    command.connection = deviceConnection(objectPath, d->connection);
+    command.timeout = d->timeout;
+    return command;
+}
+
 Device *Manager::getDevice(QDBusObjectPath objectPath)
 {
-    return new Device(objectPath);
+    return new Device(objectPath, deviceConnection(objectPath, d->connection), d->timeout);
 }
 
-void Manager::syncEffects(bool yes)
+QList<::libopenrazer::Device *> Manager::openDevices(const QList<QDBusObjectPath> &objectPaths)
 {
-    QDBusReply<void> reply = d->managerDevicesIface()->call("syncEffects", QVariant::fromValue(yes));
-    handleDBusReply(reply, Q_FUNC_INFO);
+    CapabilityDatabase *database = CapabilityDatabase::instance();
+
+    QList<QDBusConnection> connections;
+    for (const QDBusObjectPath &objectPath : objectPaths)
+        connections.append(deviceConnection(objectPath, d->connection));
+
+    // Known models are set up from the capability database, which only needs their VID/PID
+    QList<int> generations;
+    QList<DBusCommand> commands;
+    for (int i = 0; i < objectPaths.size(); i++) {
+        // Read before the calls, so a restart of the daemon during them invalidates the keys
+        generations.append(CircuitBreaker::forService(OPENRAZER_SERVICE_NAME, connections[i])->ownerGeneration());
+        commands.append({ CapabilityDatabase::vidPidMessage(objectPaths[i]), connections[i], d->timeout });
+    }
+    // Plus the version of each daemon that isn't known yet, in the same batch
+    QHash<QString, QString> versions;
+    QList<int> versionCalls;
+    for (int i = 0; i < objectPaths.size(); i++) {
+        if (versions.contains(connections[i].name()))
+            continue;
+        QString version = database->knownDaemonVersion(connections[i]);
+        versions.insert(connections[i].name(), version);
+        if (version.isEmpty()) {
+            versionCalls.append(i);
+            commands.append({ CapabilityDatabase::versionMessage(), connections[i], d->timeout });
+        }
+    }
+    QList<QDBusMessage> replies = sendDBusCommands(commands);
+
+    for (int j = 0; j < versionCalls.size(); j++) {
+        int i = versionCalls[j];
+        versions.insert(connections[i].name(), database->storeDaemonVersion(connections[i], generations[i], replies[objectPaths.size() + j]));
+    }
+
+    QList<::libopenrazer::Device *> devices(objectPaths.size(), nullptr);
+    QList<int> unknown;
+    QStringList keys;
+    for (int i = 0; i < objectPaths.size(); i++) {
+        QString key = CapabilityDatabase::modelKey(versions.value(connections[i].name()), replies[i]);
+        // So Device finds the model without asking for the VID/PID again
+        if (!key.isEmpty())
+            database->storeDeviceKey(connections[i], generations[i], objectPaths[i], key);
+        CapabilityIndex index;
+        if (!key.isEmpty() && database->lookup(key, &index)) {
+            devices[i] = new Device(new DevicePrivate(objectPaths[i], connections[i], d->timeout, index));
+        } else {
+            unknown.append(i);
+            keys.append(key);
+        }
+    }
+
+    // Send all Introspect calls for the others before waiting for the first reply
+    commands.clear();
+    for (int i : unknown)
+        commands.append({ DevicePrivate::introspectMessage(objectPaths[i]), connections[i], d->timeout });
+    replies = sendDBusCommands(commands);
+
+    QList<int> introspected;
+    QStringList introspectedKeys;
+    QStringList xmls;
+    for (int i = 0; i < replies.size(); i++) {
+        QDBusReply<QString> reply = replies[i];
+        if (!reply.isValid()) {
+            printDBusError(lcManager(), reply.error(), Q_FUNC_INFO, objectPaths[unknown[i]]);
+            continue;
+        }
+        introspected.append(unknown[i]);
+        introspectedKeys.append(keys[i]);
+        xmls.append(reply.value());
+    }
+
+    // Parsing doesn't touch any QObject, so spread it across the thread pool
+    QList<CapabilityIndex> introspections = QtConcurrent::blockingMapped<QList<CapabilityIndex>>(xmls, &DevicePrivate::parseIntrospection);
+
+    for (int i = 0; i < introspected.size(); i++) {
+        int index = introspected[i];
+        if (!introspectedKeys[i].isEmpty())
+            database->insert(introspectedKeys[i], introspections[i]);
+        devices[index] = new Device(new DevicePrivate(objectPaths[index], connections[index], d->timeout, introspections[i]));
+    }
+    // Written once for all devices
+    database->save();
+
+    // Leave out the devices that failed to introspect
+    devices.removeAll(nullptr);
+    return devices;
 }
 
-bool Manager::getSyncEffects()
+Result<void> Manager::trySyncEffects(bool yes)
+{
+    std::unique_ptr<TransportCall> call = d->managerTransport()->createCall("razer.devices", "syncEffects");
+    call->appendBool(yes);
+    return call->send(d->timeout);
+}
+
+Result<bool> Manager::tryGetSyncEffects()
 {
     QDBusReply<bool> reply = d->managerDevicesIface()->call("getSyncEffects");
-    return handleDBusReply(reply, Q_FUNC_INFO);
+    return toResult(reply);
 }
 
-QString Manager::getDaemonVersion()
+Result<QString> Manager::tryGetDaemonVersion()
 {
     QDBusReply<QString> reply = d->managerDaemonIface()->call("version");
-    return handleDBusReply(reply, Q_FUNC_INFO);
+    return toResult(reply);
 }
 
-void Manager::setTurnOffOnScreensaver(bool turnOffOnScreensaver)
+Result<void> Manager::trySetTurnOffOnScreensaver(bool turnOffOnScreensaver)
 {
-    QDBusReply<void> reply = d->managerDevicesIface()->call("enableTurnOffOnScreensaver", QVariant::fromValue(turnOffOnScreensaver));
-    handleDBusReply(reply, Q_FUNC_INFO);
+    std::unique_ptr<TransportCall> call = d->managerTransport()->createCall("razer.devices", "enableTurnOffOnScreensaver");
+    call->appendBool(turnOffOnScreensaver);
+    return call->send(d->timeout);
 }
 
-bool Manager::getTurnOffOnScreensaver()
+Result<bool> Manager::tryGetTurnOffOnScreensaver()
 {
     QDBusReply<bool> reply = d->managerDevicesIface()->call("getOffOnScreensaver");
-    return handleDBusReply(reply, Q_FUNC_INFO);
+    return toResult(reply);
 }
 
 DaemonStatus Manager::getDaemonStatus()
 {
-    // Scenarios to handle:
-    // - Command systemctl doesn't exist (e.g. Alpine or Gentoo) - exit code 255
-    // - Unit wasn't found (i.e. daemon is not installed - or only an old version) - exit code 1
-    // Daemon can be not installed but enabled -.-
-    QProcess process;
-    process.start("systemctl", QStringList() << "--user"
-                                             << "is-enabled"
-                                             << "openrazer-daemon.service");
-    process.waitForFinished();
-    QString output(process.readAllStandardOutput());
-    QString error(process.readAllStandardError());
-    if (output == "enabled\n")
-        return DaemonStatus::Enabled;
-    else if (output == "disabled\n")
-        return DaemonStatus::Disabled;
-    else if (error == "Failed to get unit file state for openrazer-daemon.service: No such file or directory\n")
-        return DaemonStatus::NotInstalled;
-    else if (process.error() == QProcess::FailedToStart) { // check if systemctl could be started - fails on non-systemd distros and flatpak
-        QFileInfo daemonFile("/usr/bin/openrazer-daemon");
-        // if the daemon executable does not exist, show the not_installed message - probably flatpak
-        if (!daemonFile.exists())
-            return DaemonStatus::NotInstalled;
-        // otherwise show the NoSystemd message - probably a non-systemd distro
-        return DaemonStatus::NoSystemd;
-    } else {
-        qWarning("libopenrazer: There was an error checking if the daemon is enabled. Unit state is: %s. Error message: %s", qUtf8Printable(output), qUtf8Printable(error));
-        return DaemonStatus::Unknown;
-    }
+    return d->systemdUnit()->status();
+}
+
+void Manager::getDaemonStatusAsync(QObject *context, const std::function<void(DaemonStatus status)> &callback)
+{
+    d->systemdUnit()->statusAsync(context, callback);
 }
 
 QString Manager::getDaemonStatusOutput()
 {
-    QProcess process;
-    process.start("systemctl", QStringList() << "--user"
-                                             << "status"
-                                             << "openrazer-daemon.service");
-    process.waitForFinished();
-    QString output(process.readAllStandardOutput());
-    QString error(process.readAllStandardError());
-    // TODO Handle systemctl not found
-    // TODO Check if output and error and only display what's filled (to get rid of stray newline)
-    return output + "\n" + error;
+    return d->systemdUnit()->statusOutput();
 }
 
 bool Manager::enableDaemon()
 {
-    QProcess process;
-    process.start("systemctl", QStringList() << "--user"
-                                             << "enable"
-                                             << "openrazer-daemon.service");
-    process.waitForFinished();
-    return process.exitCode() == 0;
+    return d->systemdUnit()->enable();
+}
+
+void Manager::enableDaemonAsync(QObject *context, const std::function<void(bool success)> &callback)
+{
+    d->systemdUnit()->enableAsync(context, callback);
 }
 
 // TODO New Qt5 connect style syntax - maybe https://stackoverflow.com/a/35501065/3527128
 bool Manager::connectDevicesChanged(QObject *receiver, const char *slot)
 {
-    bool ret = OPENRAZER_DBUS_BUS.connect(OPENRAZER_SERVICE_NAME, "/org/razer", "razer.devices", "device_added", receiver, slot);
-    ret &= OPENRAZER_DBUS_BUS.connect(OPENRAZER_SERVICE_NAME, "/org/razer", "razer.devices", "device_removed", receiver, slot);
+    bool ret = d->connection.connect(OPENRAZER_SERVICE_NAME, "/org/razer", "razer.devices", "device_added", receiver, slot);
+    ret &= d->connection.connect(OPENRAZER_SERVICE_NAME, "/org/razer", "razer.devices", "device_removed", receiver, slot);
     return ret;
 }
 
 QDBusServiceWatcher *Manager::getServiceWatcher()
 {
-    return new QDBusServiceWatcher(OPENRAZER_SERVICE_NAME, OPENRAZER_DBUS_BUS);
+    return new QDBusServiceWatcher(OPENRAZER_SERVICE_NAME, d->connection);
+}
+
+QDBusConnection Manager::connection() const
+{
+    return d->connection;
+}
+
+void Manager::setDefaultTimeout(int msecs)
+{
+    d->timeout = msecs;
+    if (d->ifaceDaemon != nullptr)
+        d->ifaceDaemon->setTimeout(msecs);
+    if (d->ifaceDevices != nullptr)
+        d->ifaceDevices->setTimeout(msecs);
+}
+
+int Manager::defaultTimeout()
+{
+    return d->timeout;
 }
 
-QDBusInterface *ManagerPrivate::managerDaemonIface()
+ManagerPrivate::ManagerPrivate(const QDBusConnection &connection)
+    : connection(connection)
+{
+}
+
+DBusInterface *ManagerPrivate::managerDaemonIface()
 {
     if (ifaceDaemon == nullptr) {
-        ifaceDaemon = new QDBusInterface(OPENRAZER_SERVICE_NAME, "/org/razer", "razer.daemon",
-                                         OPENRAZER_DBUS_BUS, mParent);
+        ifaceDaemon = new DBusInterface(OPENRAZER_SERVICE_NAME, "/org/razer", "razer.daemon",
+                                        connection, mParent);
+        ifaceDaemon->setTimeout(timeout);
     }
     if (!ifaceDaemon->isValid()) {
-        fprintf(stderr, "%s\n",
-                qPrintable(OPENRAZER_DBUS_BUS.lastError().message()));
+        warnRateLimited(lcTransport(), Q_FUNC_INFO, "/org/razer", connection.lastError().message());
     }
     return ifaceDaemon;
 }
 
-QDBusInterface *ManagerPrivate::managerDevicesIface()
+DBusInterface *ManagerPrivate::managerDevicesIface()
 {
     if (ifaceDevices == nullptr) {
-        ifaceDevices = new QDBusInterface(OPENRAZER_SERVICE_NAME, "/org/razer", "razer.devices",
-                                          OPENRAZER_DBUS_BUS, mParent);
+        ifaceDevices = new DBusInterface(OPENRAZER_SERVICE_NAME, "/org/razer", "razer.devices",
+                                         connection, mParent);
+        ifaceDevices->setTimeout(timeout);
     }
     if (!ifaceDevices->isValid()) {
-        fprintf(stderr, "%s\n",
-                qPrintable(OPENRAZER_DBUS_BUS.lastError().message()));
+        warnRateLimited(lcTransport(), Q_FUNC_INFO, "/org/razer", connection.lastError().message());
     }
     return ifaceDevices;
 }
 
+
+SystemdUnit *ManagerPrivate::systemdUnit()
+{
+    if (unit == nullptr) {
+        // The daemon runs as a user unit, the session bus reaches the user instance of systemd
+        unit = new SystemdUnit("openrazer-daemon.service", "/usr/bin/openrazer-daemon", connection, mParent);
+    }
+    return unit;
+}
+
+Transport *ManagerPrivate::managerTransport()
+{
+    if (transport == nullptr)
+        transport = std::make_unique<Transport>(OPENRAZER_SERVICE_NAME, "/org/razer", connection);
+    return transport.get();
+}
+
 }
 
 }
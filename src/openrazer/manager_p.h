@@ -7,24 +7,39 @@
 
 #include "libopenrazer/manager.h"
 
-#include <QDBusInterface>
+#include "dbusinterface_p.h"
+#include "devicecatalog_p.h"
+#include "systemdunit_p.h"
+#include "transport_p.h"
+
+#include <memory>
 
 namespace libopenrazer {
 
 namespace openrazer {
 
-const char *OPENRAZER_SERVICE_NAME = "org.razer";
-QDBusConnection OPENRAZER_DBUS_BUS = QDBusConnection::sessionBus();
-
 class ManagerPrivate
 {
 public:
+    explicit ManagerPrivate(const QDBusConnection &connection);
+
     Manager *mParent = nullptr;
 
-    QDBusInterface *ifaceDaemon = nullptr;
-    QDBusInterface *ifaceDevices = nullptr;
-    QDBusInterface *managerDaemonIface();
-    QDBusInterface *managerDevicesIface();
+    QDBusConnection connection;
+    int timeout = -1;
+
+    SystemdUnit *unit = nullptr;
+    SystemdUnit *systemdUnit();
+
+    DeviceCatalogCache catalog;
+
+    DBusInterface *ifaceDaemon = nullptr;
+    DBusInterface *ifaceDevices = nullptr;
+    DBusInterface *managerDaemonIface();
+    DBusInterface *managerDevicesIface();
+    // The setters are written through this, see Transport
+    std::unique_ptr<Transport> transport;
+    Transport *managerTransport();
 };
 
 }
@@ -0,0 +1,185 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "libopenrazer/watcher.h"
+
+#include "device_p.h"
+#include "led_p.h"
+#include "libopenrazer_private.h"
+#include "writecache_p.h"
+
+namespace libopenrazer {
+
+namespace openrazer {
+
+Watcher::Watcher(Device *device, QObject *parent)
+    : QObject(parent), m_device(device)
+{
+    m_timer.setInterval(2000);
+    connect(&m_timer, &QTimer::timeout, this, &Watcher::poll);
+    connect(device, &QObject::destroyed, this, &Watcher::stop);
+}
+
+Device *Watcher::device() const
+{
+    return m_device;
+}
+
+void Watcher::setInterval(int msecs)
+{
+    m_timer.setInterval(msecs);
+}
+
+int Watcher::interval() const
+{
+    return m_timer.interval();
+}
+
+void Watcher::setPollBudget(int msecs)
+{
+    m_pollBudget = msecs;
+}
+
+int Watcher::pollBudget() const
+{
+    return m_pollBudget;
+}
+
+void Watcher::start()
+{
+    if (m_device == nullptr || m_timer.isActive())
+        return;
+    m_timer.start();
+    poll();
+}
+
+void Watcher::stop()
+{
+    m_timer.stop();
+    m_session++;
+    m_ledStates.clear();
+    m_dpi.reset();
+    m_pollRate.reset();
+}
+
+bool Watcher::isActive() const
+{
+    return m_timer.isActive();
+}
+
+void Watcher::poll()
+{
+    // The previous poll is still running, this one is skipped
+    if (m_polling || m_device == nullptr)
+        return;
+
+    QList<Target> targets;
+    QList<DBusCommand> commands;
+    auto add = [&](Led *led, Property property, DBusCommand command) {
+        if (m_pollBudget >= 0)
+            command.timeout = m_pollBudget;
+        targets.append({ led, property });
+        commands.append(command);
+    };
+
+    for (::libopenrazer::Led *baseLed : std::as_const(m_device->d->leds)) {
+        auto *led = static_cast<Led *>(baseLed);
+        // Same checks as in the getters of Led, the daemon doesn't have the methods otherwise
+        if (led->d->hasFx()) {
+            add(led, Effect, led->d->prepareMethod(led->d->effectMethod()));
+            if (!led->d->isProfileLed())
+                add(led, Colors, led->d->prepareMethod(LedPrivate::GetEffectColors));
+        }
+        if (led->d->supportsBrightness)
+            add(led, Brightness, led->d->prepareMethod(LedPrivate::GetBrightness));
+    }
+    if (m_device->d->supportedFeatures.testFlag(Feature::DPI))
+        add(nullptr, DPI, m_device->d->deviceDpiIface()->prepareCall("getDPI"));
+    if (m_device->d->supportedFeatures.testFlag(Feature::PollRate))
+        add(nullptr, PollRate, m_device->d->deviceMiscIface()->prepareCall("getPollRate"));
+
+    m_polling = true;
+    int session = m_session;
+    sendDBusCommandsAsync(commands, this, [this, targets, session](const QList<QDBusMessage> &replies) {
+        m_polling = false;
+        if (session != m_session || m_device == nullptr)
+            return;
+        for (int i = 0; i < replies.size(); i++)
+            handleReply(targets[i], replies[i]);
+    });
+}
+
+void Watcher::handleReply(const Target &target, const QDBusMessage &reply)
+{
+    // Only record the value on the first poll, see the class documentation
+    auto changed = [](auto &cached, const auto &value) {
+        bool known = cached.has_value();
+        if (known && *cached == value)
+            return false;
+        cached = value;
+        return known;
+    };
+    Led *led = target.led;
+    if (target.property != DPI && target.property != PollRate) {
+        // Destroyed while the poll was running
+        if (led == nullptr)
+            return;
+    }
+
+    const char *functionname = Q_FUNC_INFO;
+    QDBusObjectPath objectPath = led != nullptr ? led->getObjectPath() : m_device->objectPath();
+    auto failed = [functionname, objectPath](const QLoggingCategory &category, const Error &error) {
+        printDBusError(category, error, functionname, objectPath);
+    };
+
+    switch (target.property) {
+    case Effect: {
+        Result<::openrazer::Effect> effect = led->d->parseEffect(reply);
+        if (!effect)
+            return failed(lcLed(), effect.error());
+        observeRead(led->writeCache(), effect);
+        if (changed(m_ledStates[led].effect, effect.value()))
+            emit effectChanged(led, effect.value());
+        break;
+    }
+    case Colors: {
+        Result<QVector<::openrazer::RGB>> colors = LedPrivate::parseColors(reply);
+        if (!colors)
+            return failed(lcLed(), colors.error());
+        if (changed(m_ledStates[led].colors, colors.value()))
+            emit colorsChanged(led, colors.value());
+        break;
+    }
+    case Brightness: {
+        Result<uchar> brightness = LedPrivate::parseBrightness(reply);
+        if (!brightness)
+            return failed(lcLed(), brightness.error());
+        observeRead(led->writeCache(), WriteCache::Brightness, brightness);
+        if (changed(m_ledStates[led].brightness, brightness.value()))
+            emit brightnessChanged(led, brightness.value());
+        break;
+    }
+    case DPI: {
+        Result<::openrazer::DPI> dpi = DevicePrivate::parseDPI(reply);
+        if (!dpi)
+            return failed(lcDevice(), dpi.error());
+        if (changed(m_dpi, dpi.value()))
+            emit dpiChanged(dpi.value());
+        break;
+    }
+    case PollRate: {
+        Result<ushort> pollRate = DevicePrivate::parsePollRate(reply);
+        if (!pollRate)
+            return failed(lcDevice(), pollRate.error());
+        observeRead(m_device->writeCache(), WriteCache::PollRate, pollRate);
+        if (changed(m_pollRate, pollRate.value()))
+            emit pollRateChanged(pollRate.value());
+        break;
+    }
+    }
+}
+
+}
+
+}
@@ -0,0 +1,122 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dbusinterface_p.h"
+#include "logging_p.h"
+#include "peerconnection_p.h"
+
+#include <QAtomicInt>
+#include <QDBusError>
+#include <QDBusReply>
+#include <QHash>
+
+namespace libopenrazer {
+
+namespace {
+struct PeerRegistry {
+    QMutex mutex;
+    QHash<QString, PeerConnection *> peers;
+};
+}
+Q_GLOBAL_STATIC(PeerRegistry, peerRegistry)
+
+// The peer connection is gone, as opposed to the daemon answering with an error
+static bool isPeerFailure(const QDBusMessage &reply)
+{
+    if (reply.type() != QDBusMessage::ErrorMessage)
+        return false;
+    return QDBusError(reply).type() == QDBusError::Disconnected;
+}
+
+PeerConnection *PeerConnection::forService(const QString &service, const QDBusConnection &bus,
+                                           const QString &path, const QString &interface)
+{
+    QString key = bus.name() + QLatin1Char('/') + service;
+    QMutexLocker locker(&peerRegistry->mutex);
+    PeerConnection *&peer = peerRegistry->peers[key];
+    if (peer == nullptr)
+        peer = new PeerConnection(service, bus, path, interface);
+    return peer;
+}
+
+PeerConnection::PeerConnection(const QString &service, const QDBusConnection &bus, const QString &path, const QString &interface)
+    : service(service), bus(bus), path(path), interface(interface), breaker(CircuitBreaker::forService(service, bus))
+{
+}
+
+QDBusMessage PeerConnection::call(const QDBusMessage &message, int timeout)
+{
+    QDBusConnection connection = peerConnection(timeout);
+    if (connection.isConnected()) {
+        // No breaker, a lost peer connection says nothing about the daemon on
+        // the bus and the calls fall back to the bus then anyway
+        QDBusMessage reply = sendDBusMessage(nullptr, connection, message, timeout);
+        if (!isPeerFailure(reply))
+            return reply;
+        qCWarning(lcTransport, "libopenrazer: Lost the peer-to-peer connection to %s, using the bus", qUtf8Printable(service));
+        drop(connection);
+    }
+    return sendDBusMessage(breaker, bus, message, timeout);
+}
+
+bool PeerConnection::isPeerToPeer(int timeout)
+{
+    return peerConnection(timeout).isConnected();
+}
+
+QDBusConnection::ConnectionCapabilities PeerConnection::connectionCapabilities(int timeout)
+{
+    QDBusConnection connection = peerConnection(timeout);
+    if (connection.isConnected())
+        return connection.connectionCapabilities();
+    return bus.connectionCapabilities();
+}
+
+QDBusConnection PeerConnection::peerConnection(int timeout)
+{
+    // Read the generation before the call, so a restart during the call invalidates the result
+    int currentGeneration = breaker->ownerGeneration();
+    QMutexLocker locker(&mutex);
+    if (currentGeneration == generation)
+        return peer;
+
+    if (!peer.name().isEmpty())
+        QDBusConnection::disconnectFromPeer(peer.name());
+    peer = QDBusConnection(QString());
+    generation = currentGeneration;
+
+    QDBusMessage m = QDBusMessage::createMethodCall(service, path, "org.freedesktop.DBus.Properties", "Get");
+    m << interface << QStringLiteral("PeerAddress");
+    QDBusReply<QVariant> reply = sendDBusMessage(breaker, bus, m, timeout);
+    // Daemons without the property are the common case, they are simply used over the bus
+    QString address = reply.isValid() ? reply.value().toString() : QString();
+    if (address.isEmpty())
+        return peer;
+
+    // Connection names are process-wide, a name that is in use would return the existing connection
+    static QAtomicInt counter;
+    QString name = QString("libopenrazer-peer-%1").arg(counter.fetchAndAddRelaxed(1));
+    QDBusConnection connection = QDBusConnection::connectToPeer(address, name);
+    if (!connection.isConnected()) {
+        qCWarning(lcTransport, "libopenrazer: Failed to connect to %s at %s, using the bus: %s",
+                  qUtf8Printable(service), qUtf8Printable(address), qUtf8Printable(connection.lastError().message()));
+        QDBusConnection::disconnectFromPeer(name);
+        return peer;
+    }
+    qCInfo(lcTransport, "libopenrazer: Using the peer-to-peer connection to %s at %s", qUtf8Printable(service), qUtf8Printable(address));
+    peer = connection;
+    return peer;
+}
+
+void PeerConnection::drop(const QDBusConnection &connection)
+{
+    QMutexLocker locker(&mutex);
+    // Another call may have dropped it already, or a new one has been opened since
+    if (peer.name() != connection.name())
+        return;
+    QDBusConnection::disconnectFromPeer(peer.name());
+    peer = QDBusConnection(QString());
+}
+
+}
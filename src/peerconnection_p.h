@@ -0,0 +1,81 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PEERCONNECTION_P_H
+#define PEERCONNECTION_P_H
+
+#include "circuitbreaker_p.h"
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QMutex>
+
+namespace libopenrazer {
+
+/*
+ * Direct connection to a daemon, bypassing the bus daemon.
+ *
+ * Every call over the bus is relayed by dbus-daemon, which doubles the
+ * context switches of a call. A daemon can advertise an address clients may
+ * connect to directly in the PeerAddress property of its manager object.
+ * High-volume calls like custom frames are then sent over a peer-to-peer
+ * connection to that address, control calls stay on the bus.
+ *
+ * The property is read once per owner generation of the daemon on the bus.
+ * Without an address, or after the peer connection failed, calls are sent
+ * over the bus until the daemon is restarted.
+ */
+class PeerConnection
+{
+public:
+    /*
+     * Returns the peer connection shared by all calls to \a service over
+     * \a bus. The address is read from the object at \a path, \a interface
+     * names the interface of the PeerAddress property.
+     */
+    static PeerConnection *forService(const QString &service, const QDBusConnection &bus,
+                                      const QString &path, const QString &interface);
+
+    /*
+     * Sends \a message like sendDBusMessage(), over the peer connection if
+     * there is one and over the bus otherwise. Calls that fail because the
+     * peer connection is gone are repeated over the bus. Only the calls over
+     * the bus are checked against the circuit breaker of the service.
+     */
+    QDBusMessage call(const QDBusMessage &message, int timeout = -1);
+
+    /*
+     * Returns if calls currently go over a peer connection. Reads the
+     * address first if needed.
+     */
+    bool isPeerToPeer(int timeout = -1);
+
+    /*
+     * Returns the capabilities of the connection calls currently go over,
+     * e.g. to check if file descriptors can be passed.
+     */
+    QDBusConnection::ConnectionCapabilities connectionCapabilities(int timeout = -1);
+
+private:
+    PeerConnection(const QString &service, const QDBusConnection &bus, const QString &path, const QString &interface);
+
+    QDBusConnection peerConnection(int timeout);
+    void drop(const QDBusConnection &peer);
+
+    QString service;
+    QDBusConnection bus;
+    QString path;
+    QString interface;
+    CircuitBreaker *breaker;
+
+    // Held while the address is read, so only one peer connection gets opened
+    QMutex mutex;
+    QDBusConnection peer = QDBusConnection(QString());
+    // Owner generation of the daemon the address was read from
+    int generation = -1;
+};
+
+}
+
+#endif // PEERCONNECTION_P_H
@@ -0,0 +1,177 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "libopenrazer/powermonitor.h"
+#include "libopenrazer_private.h"
+
+namespace libopenrazer {
+
+PowerMonitor *PowerMonitor::forManager(Manager *manager)
+{
+    PowerMonitor *monitor = manager->findChild<PowerMonitor *>(QString(), Qt::FindDirectChildrenOnly);
+    if (monitor == nullptr)
+        monitor = new PowerMonitor(manager);
+    return monitor;
+}
+
+PowerMonitor::PowerMonitor(Manager *manager)
+    : QObject(manager), m_manager(manager)
+{
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &PowerMonitor::poll);
+    connect(manager, &Manager::deviceRemoved, this, &PowerMonitor::removeDevice);
+}
+
+void PowerMonitor::subscribe(QObject *subscriber)
+{
+    if (m_subscribers.contains(subscriber))
+        return;
+    m_subscribers.insert(subscriber);
+    connect(subscriber, &QObject::destroyed, this, [this, subscriber]() { unsubscribe(subscriber); });
+
+    if (m_subscribers.size() == 1) {
+        m_interval = m_minimumInterval;
+        poll();
+    }
+}
+
+void PowerMonitor::unsubscribe(QObject *subscriber)
+{
+    if (!m_subscribers.remove(subscriber))
+        return;
+    disconnect(subscriber, &QObject::destroyed, this, nullptr);
+    if (m_subscribers.isEmpty())
+        m_timer.stop();
+}
+
+double PowerMonitor::getBatteryPercent(Device *device) const
+{
+    return m_states.value(device).batteryPercent;
+}
+
+bool PowerMonitor::isCharging(Device *device) const
+{
+    return m_states.value(device).charging;
+}
+
+void PowerMonitor::setPollIntervals(int minimumMsecs, int maximumMsecs)
+{
+    m_minimumInterval = minimumMsecs;
+    m_maximumInterval = qMax(minimumMsecs, maximumMsecs);
+    m_interval = qBound(m_minimumInterval, m_interval, m_maximumInterval);
+}
+
+void PowerMonitor::poll()
+{
+    // The previous poll is still running, it schedules the next one
+    if (m_polling)
+        return;
+
+    struct Target {
+        QPointer<Device> device;
+        Query query;
+    };
+    QList<Target> targets;
+    QList<DBusCommand> commands;
+    bool changed = false;
+
+    auto add = [&](Device *device, Query query, const Result<DBusCommand> &command, const QVariant &fallback) {
+        if (command) {
+            targets.append({ device, query });
+            commands.append(command.value());
+        } else if (fallback.isValid()) {
+            // The backend can't prepare the call, the value is available without calling the daemon
+            changed |= update(device, query, fallback);
+        }
+    };
+    auto valueOf = [](const auto &result) { return result ? QVariant::fromValue(result.value()) : QVariant(); };
+
+    for (Device *device : m_manager->getTrackedDevices()) {
+        if (!device->hasFeature(Feature::Battery))
+            continue;
+        Result<DBusCommand> command = device->prepareGetBatteryPercent();
+        add(device, BatteryPercent, command, command ? QVariant() : valueOf(device->tryGetBatteryPercent()));
+        command = device->prepareIsCharging();
+        add(device, Charging, command, command ? QVariant() : valueOf(device->tryIsCharging()));
+        // Only read once, it only changes when it's set
+        if (m_states.value(device).lowBatteryThreshold < 0 && device->hasFeature(Feature::LowBatteryThreshold)) {
+            command = device->prepareGetLowBatteryThreshold();
+            add(device, LowBatteryThreshold, command, command ? QVariant() : valueOf(device->tryGetLowBatteryThreshold()));
+        }
+    }
+
+    m_polling = true;
+    sendDBusCommandsAsync(commands, this, [this, targets, commands, changed](const QList<QDBusMessage> &replies) mutable {
+        m_polling = false;
+        for (int i = 0; i < replies.size(); i++) {
+            Device *device = targets[i].device;
+            if (device == nullptr)
+                continue;
+            if (replies[i].type() == QDBusMessage::ErrorMessage) {
+                printDBusError(lcDevice(), Error(QDBusError(replies[i])), Q_FUNC_INFO, device->objectPath());
+                continue;
+            }
+            changed |= update(device, targets[i].query, replies[i].arguments().value(0));
+        }
+        scheduleNextPoll(changed);
+    });
+}
+
+bool PowerMonitor::update(Device *device, Query query, const QVariant &value)
+{
+    DeviceState &state = m_states[device];
+    switch (query) {
+    case BatteryPercent: {
+        double percent = value.toDouble();
+        if (percent == state.batteryPercent)
+            return false;
+        state.batteryPercent = percent;
+        emit batteryPercentChanged(device, percent);
+        return true;
+    }
+    case Charging: {
+        bool charging = value.toBool();
+        if (charging == state.charging)
+            return false;
+        state.charging = charging;
+        emit chargingChanged(device, charging);
+        return true;
+    }
+    case LowBatteryThreshold:
+        state.lowBatteryThreshold = value.toDouble();
+        return false;
+    }
+    return false;
+}
+
+void PowerMonitor::scheduleNextPoll(bool changed)
+{
+    bool urgent = false;
+    for (const DeviceState &state : std::as_const(m_states)) {
+        if (state.charging
+            || (state.lowBatteryThreshold >= 0 && state.batteryPercent >= 0
+                && state.batteryPercent <= state.lowBatteryThreshold + LOW_BATTERY_MARGIN))
+            urgent = true;
+    }
+
+    if (changed || urgent)
+        m_interval = m_minimumInterval;
+    else
+        m_interval = qMin(m_interval * 2, m_maximumInterval);
+
+    if (!m_subscribers.isEmpty())
+        m_timer.start(m_interval);
+}
+
+void PowerMonitor::removeDevice(const QDBusObjectPath &objectPath)
+{
+    for (auto it = m_states.begin(); it != m_states.end();) {
+        if (it.key()->objectPath() == objectPath)
+            it = m_states.erase(it);
+        else
+            ++it;
+    }
+}
+
+}
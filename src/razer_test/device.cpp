@@ -5,6 +5,7 @@
 #include "device_p.h"
 #include "libopenrazer.h"
 #include "libopenrazer_private.h"
+#include "writecache_p.h"
 
 #include <QVector>
 
@@ -12,13 +13,20 @@ namespace libopenrazer {
 
 namespace razer_test {
 
-Device::Device(QDBusObjectPath objectPath)
+Device::Device(QDBusObjectPath objectPath, int timeout)
+    : Device(objectPath, defaultConnection(), timeout)
+{
+}
+
+Device::Device(QDBusObjectPath objectPath, const QDBusConnection &connection, int timeout)
 {
     d = new DevicePrivate();
     d->mParent = this;
+    d->connection = connection;
     d->mObjectPath = objectPath;
+    d->timeout = timeout;
     d->supportedFx = d->getSupportedFx();
-    d->supportedFeatures = d->getSupportedFeatures();
+    d->supportedFeatures = featuresFromStrings(d->getSupportedFeatures());
 
     for (const QDBusObjectPath &ledPath : d->getLedObjectPaths()) {
         Led *led = new Led(this, ledPath);
@@ -31,6 +39,7 @@ Device::~Device()
     for (libopenrazer::Led *led : d->leds) {
         delete led;
     }
+    delete d;
 }
 
 QDBusObjectPath Device::objectPath()
@@ -38,20 +47,21 @@ QDBusObjectPath Device::objectPath()
     return d->mObjectPath;
 }
 
-bool Device::hasFeature(const QString &featureStr)
+Features Device::features()
 {
-    return d->supportedFeatures.contains(featureStr);
+    return d->supportedFeatures;
 }
 
-QString Device::getDeviceImageUrl()
+Result<QString> Device::tryGetDeviceImageUrl()
 {
-    return ""; // TODO Needs implementation
+    // TODO Needs implementation
+    return notSupportedError("The device image is not implemented for razer_test.");
 }
 
 QList<QDBusObjectPath> DevicePrivate::getLedObjectPaths()
 {
-    QVariant reply = deviceIface()->property("Leds");
-    return handleDBusVariant<QList<QDBusObjectPath>>(reply, deviceIface()->lastError(), Q_FUNC_INFO);
+    QDBusReply<QVariant> reply = deviceIface()->getProperty("Leds");
+    return unwrap(variantToResult<QList<QDBusObjectPath>>(reply), lcDevice(), Q_FUNC_INFO, mObjectPath);
 }
 
 QList<::libopenrazer::Led *> Device::getLeds()
@@ -61,169 +71,242 @@ QList<::libopenrazer::Led *> Device::getLeds()
 
 QStringList DevicePrivate::getSupportedFx()
 {
-    QVariant reply = deviceIface()->property("SupportedFx");
-    return handleDBusVariant<QStringList>(reply, deviceIface()->lastError(), Q_FUNC_INFO);
+    QDBusReply<QVariant> reply = deviceIface()->getProperty("SupportedFx");
+    return unwrap(variantToResult<QStringList>(reply), lcDevice(), Q_FUNC_INFO, mObjectPath);
 }
 
 QStringList DevicePrivate::getSupportedFeatures()
 {
-    QVariant reply = deviceIface()->property("SupportedFeatures");
-    return handleDBusVariant<QStringList>(reply, deviceIface()->lastError(), Q_FUNC_INFO);
+    QDBusReply<QVariant> reply = deviceIface()->getProperty("SupportedFeatures");
+    return unwrap(variantToResult<QStringList>(reply), lcDevice(), Q_FUNC_INFO, mObjectPath);
 }
 
-QString Device::getDeviceMode()
+Result<QString> Device::tryGetDeviceMode()
 {
-    return "error"; // TODO Needs implementation
+    // TODO Needs implementation
+    return notSupportedError("Reading the device mode is not implemented for razer_test.");
 }
 
-QString Device::getSerial()
+Result<QString> Device::tryGetSerial()
 {
     QDBusReply<QString> reply = d->deviceIface()->call("getSerial");
-    return handleDBusReply(reply, Q_FUNC_INFO);
+    return toResult(reply);
 }
 
-QString Device::getDeviceName()
+Result<DBusCommand> Device::prepareGetSerial()
 {
-    QVariant reply = d->deviceIface()->property("Name");
-    return handleDBusVariant<QString>(reply, d->deviceIface()->lastError(), Q_FUNC_INFO);
+    return d->deviceIface()->prepareCall("getSerial");
 }
 
-QString Device::getDeviceType()
+Result<QString> Device::tryGetDeviceName()
 {
-    QVariant reply = d->deviceIface()->property("Type");
-    return handleDBusVariant<QString>(reply, d->deviceIface()->lastError(), Q_FUNC_INFO);
+    QDBusReply<QVariant> reply = d->deviceIface()->getProperty("Name");
+    return variantToResult<QString>(reply);
 }
 
-QString Device::getFirmwareVersion()
+Result<QString> Device::tryGetDeviceType()
+{
+    QDBusReply<QVariant> reply = d->deviceIface()->getProperty("Type");
+    return variantToResult<QString>(reply);
+}
+
+Result<QString> Device::tryGetFirmwareVersion()
 {
     QDBusReply<QString> reply = d->deviceIface()->call("getFirmwareVersion");
-    return handleDBusReply(reply, Q_FUNC_INFO);
+    return toResult(reply);
 }
 
-QString Device::getKeyboardLayout()
+Result<QString> Device::tryGetKeyboardLayout()
 {
     QDBusReply<QString> reply = d->deviceIface()->call("getKeyboardLayout");
-    return handleDBusReply(reply, Q_FUNC_INFO);
+    return toResult(reply);
 }
 
-ushort Device::getPollRate()
+Result<ushort> Device::tryGetPollRate()
 {
     QDBusReply<ushort> reply = d->deviceIface()->call("getPollRate");
-    return handleDBusReply(reply, Q_FUNC_INFO);
+    Result<ushort> result = toResult(reply);
+    observeRead(writeCache(), WriteCache::PollRate, result);
+    return result;
+}
+
+Result<void> Device::trySetPollRate(ushort pollrate)
+{
+    return cachedWrite(writeCache(), d->deviceIface(), WriteCache::PollRate, QVariant::fromValue(pollrate), [&]() {
+        std::unique_ptr<TransportCall> call = d->controlTransport()->createCall("io.github.openrazer1.Device", "setPollRate");
+        call->appendUInt16(pollrate);
+        return call->send(d->timeout);
+    });
 }
 
-void Device::setPollRate(ushort pollrate)
+Result<DBusCommand> Device::prepareSetPollRate(ushort pollrate)
 {
-    QDBusReply<bool> reply = d->deviceIface()->call("setPollRate", QVariant::fromValue(pollrate));
-    handleVoidDBusReply(reply, Q_FUNC_INFO);
+    return d->deviceIface()->prepareCall("setPollRate", { QVariant::fromValue(pollrate) });
 }
 
-QVector<ushort> Device::getSupportedPollRates()
+Result<QVector<ushort>> Device::tryGetSupportedPollRates()
 {
     // TODO Needs implementation
-    return { 125, 500, 1000 };
+    return notSupportedError("Reading the supported poll rates is not implemented for razer_test.");
 }
 
-void Device::setDPI(::openrazer::DPI dpi)
+Result<void> Device::trySetDPI(::openrazer::DPI dpi)
 {
-    QDBusReply<bool> reply = d->deviceIface()->call("setDPI", QVariant::fromValue(dpi));
-    handleVoidDBusReply(reply, Q_FUNC_INFO);
+    std::unique_ptr<TransportCall> call = d->controlTransport()->createCall("io.github.openrazer1.Device", "setDPI");
+    call->appendDPI(dpi);
+    return call->send(d->timeout);
 }
 
-::openrazer::DPI Device::getDPI()
+Result<DBusCommand> Device::prepareSetDPI(::openrazer::DPI dpi)
+{
+    return d->deviceIface()->prepareCall("setDPI", { QVariant::fromValue(dpi) });
+}
+
+Result<::openrazer::DPI> Device::tryGetDPI()
 {
     QDBusReply<::openrazer::DPI> reply = d->deviceIface()->call("getDPI");
-    return handleDBusReply(reply, Q_FUNC_INFO);
+    return toResult(reply);
+}
+
+Result<void> Device::trySetDPIStages(uchar activeStage, QVector<::openrazer::DPI> dpiStages)
+{
+    // TODO Needs implementation
+    return notSupportedError("Setting DPI stages is not implemented for razer_test.");
 }
 
-void Device::setDPIStages(uchar activeStage, QVector<::openrazer::DPI> dpiStages)
+Result<DBusCommand> Device::prepareSetDPIStages(uchar activeStage, QVector<::openrazer::DPI> dpiStages)
 {
     // TODO Needs implementation
+    return notSupportedError("Setting DPI stages is not implemented for razer_test.");
 }
 
-QPair<uchar, QVector<::openrazer::DPI>> Device::getDPIStages()
+Result<QPair<uchar, QVector<::openrazer::DPI>>> Device::tryGetDPIStages()
 {
     // TODO Needs implementation
-    return { 0, {} };
+    return notSupportedError("Reading the DPI stages is not implemented for razer_test.");
 }
 
-ushort Device::maxDPI()
+Result<ushort> Device::tryMaxDPI()
 {
     QDBusReply<ushort> reply = d->deviceIface()->call("getMaxDPI");
-    return handleDBusReply(reply, Q_FUNC_INFO);
+    return toResult(reply);
 }
 
-QVector<ushort> Device::getAllowedDPI()
+Result<QVector<ushort>> Device::tryGetAllowedDPI()
 {
     // TODO Needs implementation
-    return {};
+    return notSupportedError("Reading the allowed DPI values is not implemented for razer_test.");
 }
 
-double Device::getBatteryPercent()
+Result<double> Device::tryGetBatteryPercent()
 {
     // TODO Needs implementation
-    return 100;
+    return notSupportedError("Reading the battery is not implemented for razer_test.");
 }
 
-bool Device::isCharging()
+Result<DBusCommand> Device::prepareGetBatteryPercent()
 {
     // TODO Needs implementation
-    return true;
+    return notSupportedError("Reading the battery is not implemented for razer_test.");
 }
 
-ushort Device::getIdleTime()
+Result<bool> Device::tryIsCharging()
 {
     // TODO Needs implementation
-    return 900;
+    return notSupportedError("Reading the charging state is not implemented for razer_test.");
 }
 
-void Device::setIdleTime(ushort idleTime)
+Result<DBusCommand> Device::prepareIsCharging()
 {
     // TODO Needs implementation
+    return notSupportedError("Reading the charging state is not implemented for razer_test.");
 }
 
-double Device::getLowBatteryThreshold()
+Result<ushort> Device::tryGetIdleTime()
 {
     // TODO Needs implementation
-    return 15;
+    return notSupportedError("Reading the idle time is not implemented for razer_test.");
 }
 
-void Device::setLowBatteryThreshold(double threshold)
+Result<void> Device::trySetIdleTime(ushort idleTime)
 {
     // TODO Needs implementation
+    return notSupportedError("Setting the idle time is not implemented for razer_test.");
 }
 
-void Device::displayCustomFrame()
+Result<double> Device::tryGetLowBatteryThreshold()
 {
-    QDBusReply<bool> reply = d->deviceIface()->call("displayCustomFrame");
-    handleVoidDBusReply(reply, Q_FUNC_INFO);
+    // TODO Needs implementation
+    return notSupportedError("Reading the low battery threshold is not implemented for razer_test.");
 }
 
-void Device::defineCustomFrame(uchar row, uchar startColumn, uchar endColumn, QVector<::openrazer::RGB> colorData)
+Result<DBusCommand> Device::prepareGetLowBatteryThreshold()
 {
-    QDBusReply<bool> reply = d->deviceIface()->call("defineCustomFrame", QVariant::fromValue(row), QVariant::fromValue(startColumn), QVariant::fromValue(endColumn), QVariant::fromValue(colorData));
-    handleVoidDBusReply(reply, Q_FUNC_INFO);
+    // TODO Needs implementation
+    return notSupportedError("Reading the low battery threshold is not implemented for razer_test.");
 }
 
-::openrazer::MatrixDimensions Device::getMatrixDimensions()
+Result<void> Device::trySetLowBatteryThreshold(double threshold)
 {
-    QVariant reply = d->deviceIface()->property("MatrixDimensions");
-    return handleDBusVariant<::openrazer::MatrixDimensions>(reply, d->deviceIface()->lastError(), Q_FUNC_INFO);
+    // TODO Needs implementation
+    return notSupportedError("Setting the low battery threshold is not implemented for razer_test.");
+}
+
+Result<void> Device::tryDisplayCustomFrame()
+{
+    return d->transport()->createCall("io.github.openrazer1.Device", "displayCustomFrame")->send(d->timeout);
+}
+
+Result<void> Device::tryDefineCustomFrame(uchar row, uchar startColumn, uchar endColumn, QVector<::openrazer::RGB> colorData)
+{
+    std::unique_ptr<TransportCall> call = d->transport()->createCall("io.github.openrazer1.Device", "defineCustomFrame");
+    call->appendByte(row);
+    call->appendByte(startColumn);
+    call->appendByte(endColumn);
+    call->appendColors(colorData);
+    return call->send(d->timeout);
+}
+
+Result<::openrazer::MatrixDimensions> Device::tryGetMatrixDimensions()
+{
+    QDBusReply<QVariant> reply = d->deviceIface()->getProperty("MatrixDimensions");
+    return variantToResult<::openrazer::MatrixDimensions>(reply);
 }
 
-QDBusInterface *DevicePrivate::deviceIface()
+DBusInterface *DevicePrivate::deviceIface()
 {
     if (iface == nullptr) {
-        iface = new QDBusInterface(OPENRAZER_SERVICE_NAME, mObjectPath.path(), "io.github.openrazer1.Device",
-                                   OPENRAZER_DBUS_BUS, mParent);
+        iface = new DBusInterface(OPENRAZER_SERVICE_NAME, mObjectPath.path(), "io.github.openrazer1.Device",
+                                  connection, mParent);
+        iface->setTimeout(timeout);
     }
     if (!iface->isValid()) {
-        fprintf(stderr, "%s\n",
-                qPrintable(OPENRAZER_DBUS_BUS.lastError().message()));
+        warnRateLimited(lcTransport(), Q_FUNC_INFO, mObjectPath.path(), connection.lastError().message());
     }
     return iface;
 }
 
+PeerConnection *DevicePrivate::peerConnection()
+{
+    if (peer == nullptr)
+        peer = PeerConnection::forService(OPENRAZER_SERVICE_NAME, connection, "/io/github/openrazer1", "io.github.openrazer1.Manager");
+    return peer;
+}
+
+Transport *DevicePrivate::transport()
+{
+    if (frameTransport == nullptr)
+        frameTransport = std::make_unique<Transport>(OPENRAZER_SERVICE_NAME, mObjectPath.path(), connection, peerConnection());
+    return frameTransport.get();
+}
+
+Transport *DevicePrivate::controlTransport()
+{
+    if (setterTransport == nullptr)
+        setterTransport = std::make_unique<Transport>(OPENRAZER_SERVICE_NAME, mObjectPath.path(), connection);
+    return setterTransport.get();
+}
+
 }
 
 }
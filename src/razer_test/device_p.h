@@ -8,7 +8,11 @@
 #include "libopenrazer/device.h"
 #include "libopenrazer/led.h"
 
-#include <QDBusInterface>
+#include "dbusinterface_p.h"
+#include "peerconnection_p.h"
+#include "transport_p.h"
+
+#include <memory>
 
 namespace libopenrazer {
 
@@ -19,13 +23,27 @@ class DevicePrivate
 public:
     Device *mParent = nullptr;
 
-    QDBusInterface *iface = nullptr;
-    QDBusInterface *deviceIface();
+    // Also used by the Leds of the device
+    QDBusConnection connection = QDBusConnection(QString());
+
+    DBusInterface *iface = nullptr;
+    DBusInterface *deviceIface();
+
+    // Custom frames go over this, see PeerConnection
+    PeerConnection *peer = nullptr;
+    PeerConnection *peerConnection();
+    // The calls for custom frames are written through this, see Transport
+    std::unique_ptr<Transport> frameTransport;
+    Transport *transport();
+    // The setters, these stay on the bus
+    std::unique_ptr<Transport> setterTransport;
+    Transport *controlTransport();
 
     QDBusObjectPath mObjectPath;
+    int timeout = -1;
 
     QStringList supportedFx;
-    QStringList supportedFeatures;
+    Features supportedFeatures;
 
     QList<::libopenrazer::Led *> leds;
     QList<QDBusObjectPath> getLedObjectPaths();
@@ -3,14 +3,43 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "device_p.h"
+#include "effectnames_p.h"
 #include "led_p.h"
 #include "libopenrazer.h"
 #include "libopenrazer_private.h"
+#include "writecache_p.h"
 
 namespace libopenrazer {
 
 namespace razer_test {
 
+// The arguments of the effect setters, written with their D-Bus type
+static void appendArgument(TransportCall *call, const ::openrazer::RGB &color)
+{
+    call->appendColor(color);
+}
+
+static void appendArgument(TransportCall *call, ::openrazer::WaveDirection direction)
+{
+    call->appendEnum(static_cast<int>(direction));
+}
+
+static void appendArgument(TransportCall *call, ::openrazer::ReactiveSpeed speed)
+{
+    call->appendEnum(static_cast<int>(speed));
+}
+
+template<typename... Args>
+Result<void> LedPrivate::setEffect(WriteCache *cache, ::openrazer::Effect effect, const char *method, const Args &...args)
+{
+    QVariantList value { static_cast<int>(effect), QVariant::fromValue(args)... };
+    return cachedWrite(cache, ledIface(), WriteCache::Effect, value, [&]() {
+        std::unique_ptr<TransportCall> call = ledTransport()->createCall("io.github.openrazer1.Led", method);
+        (appendArgument(call.get(), args), ...);
+        return call->send(device->d->timeout);
+    });
+}
+
 Led::Led(Device *device, QDBusObjectPath objectPath)
 {
     d = new LedPrivate();
@@ -19,7 +48,10 @@ Led::Led(Device *device, QDBusObjectPath objectPath)
     d->mObjectPath = objectPath;
 }
 
-Led::~Led() = default;
+Led::~Led()
+{
+    delete d;
+}
 
 QDBusObjectPath Led::getObjectPath()
 {
@@ -33,161 +65,166 @@ bool Led::hasBrightness()
 
 bool Led::hasFx(::openrazer::Effect fx)
 {
-    QString fxStr;
-    switch (fx) {
-    case ::openrazer::Effect::Off:
-        fxStr = "off";
-        break;
-    case ::openrazer::Effect::On:
-        fxStr = "on";
-        break;
-    case ::openrazer::Effect::Static:
-        fxStr = "static";
-        break;
-    case ::openrazer::Effect::Breathing:
-        fxStr = "breathing";
-        break;
-    case ::openrazer::Effect::BreathingDual:
-        fxStr = "breathing_dual";
-        break;
-    case ::openrazer::Effect::BreathingRandom:
-        fxStr = "breathing_random";
-        break;
-    case ::openrazer::Effect::Blinking:
-        fxStr = "blinking";
-        break;
-    case ::openrazer::Effect::Spectrum:
-        fxStr = "spectrum";
-        break;
-    case ::openrazer::Effect::Wave:
-        fxStr = "wave";
-        break;
-    case ::openrazer::Effect::Reactive:
-        fxStr = "reactive";
-        break;
-    case ::openrazer::Effect::Wheel:
-    case ::openrazer::Effect::BreathingMono:
-    case ::openrazer::Effect::Ripple:
-    case ::openrazer::Effect::RippleRandom:
-        // TODO Needs implementation
+    const char *fxStr = effectnames::nameFromEffect(EFFECT_NAMES, fx);
+    if (fxStr == nullptr) {
         return false;
     }
-    return d->hasFx(fxStr);
+    return d->hasFx(QLatin1String(fxStr));
 }
 
-::openrazer::Effect Led::getCurrentEffect()
+Result<::openrazer::Effect> Led::tryGetCurrentEffect()
 {
-    QVariant reply = d->ledIface()->property("CurrentEffect");
-    return handleDBusVariant<::openrazer::Effect>(reply, d->ledIface()->lastError(), Q_FUNC_INFO);
+    QDBusReply<QVariant> reply = d->ledIface()->getProperty("CurrentEffect");
+    Result<::openrazer::Effect> result = variantToResult<::openrazer::Effect>(reply);
+    observeRead(writeCache(), result);
+    return result;
 }
 
-QVector<::openrazer::RGB> Led::getCurrentColors()
+Result<QVector<::openrazer::RGB>> Led::tryGetCurrentColors()
 {
-    QVariant reply = d->ledIface()->property("CurrentColors");
-    return handleDBusVariant<QVector<::openrazer::RGB>>(reply, d->ledIface()->lastError(), Q_FUNC_INFO);
+    QDBusReply<QVariant> reply = d->ledIface()->getProperty("CurrentColors");
+    return variantToResult<QVector<::openrazer::RGB>>(reply);
 }
 
-::openrazer::WaveDirection Led::getWaveDirection()
+Result<::openrazer::WaveDirection> Led::tryGetWaveDirection()
 {
-    return ::openrazer::WaveDirection::RIGHT_TO_LEFT; // TODO Needs implementation
+    // TODO Needs implementation
+    return notSupportedError("Reading the wave direction is not implemented for razer_test.");
 }
 
-::openrazer::LedId Led::getLedId()
+Result<::openrazer::LedId> Led::tryGetLedId()
 {
-    QVariant reply = d->ledIface()->property("LedId");
-    return handleDBusVariant<::openrazer::LedId>(reply, d->ledIface()->lastError(), Q_FUNC_INFO);
+    QDBusReply<QVariant> reply = d->ledIface()->getProperty("LedId");
+    return variantToResult<::openrazer::LedId>(reply);
 }
 
-void Led::setOff()
+Result<void> Led::trySetOff()
 {
-    QDBusReply<bool> reply = d->ledIface()->call("setOff");
-    handleVoidDBusReply(reply, Q_FUNC_INFO);
+    return d->setEffect(writeCache(), ::openrazer::Effect::Off, "setOff");
 }
 
-void Led::setOn()
+Result<void> Led::trySetOn()
 {
-    QDBusReply<bool> reply = d->ledIface()->call("setOn");
-    handleVoidDBusReply(reply, Q_FUNC_INFO);
+    return d->setEffect(writeCache(), ::openrazer::Effect::On, "setOn");
 }
 
-void Led::setStatic(::openrazer::RGB color)
+Result<void> Led::trySetStatic(::openrazer::RGB color)
 {
-    QDBusReply<bool> reply = d->ledIface()->call("setStatic", QVariant::fromValue(color));
-    handleVoidDBusReply(reply, Q_FUNC_INFO);
+    return d->setEffect(writeCache(), ::openrazer::Effect::Static, "setStatic", color);
 }
 
-void Led::setBreathing(::openrazer::RGB color)
+Result<void> Led::trySetBreathing(::openrazer::RGB color)
 {
-    QDBusReply<bool> reply = d->ledIface()->call("setBreathing", QVariant::fromValue(color));
-    handleVoidDBusReply(reply, Q_FUNC_INFO);
+    return d->setEffect(writeCache(), ::openrazer::Effect::Breathing, "setBreathing", color);
 }
 
-void Led::setBreathingDual(::openrazer::RGB color, ::openrazer::RGB color2)
+Result<void> Led::trySetBreathingDual(::openrazer::RGB color, ::openrazer::RGB color2)
 {
-    QDBusReply<bool> reply = d->ledIface()->call("setBreathingDual", QVariant::fromValue(color), QVariant::fromValue(color2));
-    handleVoidDBusReply(reply, Q_FUNC_INFO);
+    return d->setEffect(writeCache(), ::openrazer::Effect::BreathingDual, "setBreathingDual", color, color2);
 }
 
-void Led::setBreathingRandom()
+Result<void> Led::trySetBreathingRandom()
 {
-    QDBusReply<bool> reply = d->ledIface()->call("setBreathingRandom");
-    handleVoidDBusReply(reply, Q_FUNC_INFO);
+    return d->setEffect(writeCache(), ::openrazer::Effect::BreathingRandom, "setBreathingRandom");
 }
 
-void Led::setBreathingMono()
+Result<void> Led::trySetBreathingMono()
 {
     // TODO Needs implementation
+    return notSupportedError("The breathing mono effect is not implemented for razer_test.");
 }
 
-void Led::setBlinking(::openrazer::RGB color)
+Result<void> Led::trySetBlinking(::openrazer::RGB color)
 {
-    QDBusReply<bool> reply = d->ledIface()->call("setBlinking", QVariant::fromValue(color));
-    handleVoidDBusReply(reply, Q_FUNC_INFO);
+    return d->setEffect(writeCache(), ::openrazer::Effect::Blinking, "setBlinking", color);
 }
 
-void Led::setSpectrum()
+Result<void> Led::trySetSpectrum()
 {
-    QDBusReply<bool> reply = d->ledIface()->call("setSpectrum");
-    handleVoidDBusReply(reply, Q_FUNC_INFO);
+    return d->setEffect(writeCache(), ::openrazer::Effect::Spectrum, "setSpectrum");
 }
 
-void Led::setWave(::openrazer::WaveDirection direction)
+Result<void> Led::trySetWave(::openrazer::WaveDirection direction)
 {
-    QDBusReply<bool> reply = d->ledIface()->call("setWave", QVariant::fromValue(direction));
-    handleVoidDBusReply(reply, Q_FUNC_INFO);
+    return d->setEffect(writeCache(), ::openrazer::Effect::Wave, "setWave", direction);
 }
 
-void Led::setWheel(::openrazer::WheelDirection direction)
+Result<void> Led::trySetWheel(::openrazer::WheelDirection direction)
 {
     // TODO Needs implementation
+    return notSupportedError("The wheel effect is not implemented for razer_test.");
 }
 
-void Led::setReactive(::openrazer::RGB color, ::openrazer::ReactiveSpeed speed)
+Result<void> Led::trySetReactive(::openrazer::RGB color, ::openrazer::ReactiveSpeed speed)
 {
-    QDBusReply<bool> reply = d->ledIface()->call("setReactive", QVariant::fromValue(speed), QVariant::fromValue(color));
-    handleVoidDBusReply(reply, Q_FUNC_INFO);
+    return d->setEffect(writeCache(), ::openrazer::Effect::Reactive, "setReactive", speed, color);
 }
 
-void Led::setRipple(::openrazer::RGB color)
+Result<void> Led::trySetRipple(::openrazer::RGB color)
 {
     // TODO Needs implementation
+    return notSupportedError("The ripple effect is not implemented for razer_test.");
 }
 
-void Led::setRippleRandom()
+Result<void> Led::trySetRippleRandom()
 {
     // TODO Needs implementation
+    return notSupportedError("The random ripple effect is not implemented for razer_test.");
 }
 
-void Led::setBrightness(uchar brightness)
+Result<void> Led::trySetBrightness(uchar brightness)
 {
-    QDBusReply<bool> reply = d->ledIface()->call("setBrightness", QVariant::fromValue(brightness));
-    handleVoidDBusReply(reply, Q_FUNC_INFO);
+    return cachedWrite(writeCache(), d->ledIface(), WriteCache::Brightness, QVariant::fromValue(brightness), [&]() {
+        std::unique_ptr<TransportCall> call = d->ledTransport()->createCall("io.github.openrazer1.Led", "setBrightness");
+        call->appendByte(brightness);
+        return call->send(d->device->d->timeout);
+    });
 }
 
-uchar Led::getBrightness()
+Result<DBusCommand> Led::prepareSetBrightness(uchar brightness)
+{
+    return d->ledIface()->prepareCall("setBrightness", { QVariant::fromValue(brightness) });
+}
+
+Result<uchar> Led::tryGetBrightness()
 {
     QDBusReply<uchar> reply = d->ledIface()->call("getBrightness");
-    return handleDBusReply(reply, Q_FUNC_INFO);
+    Result<uchar> result = toResult(reply);
+    observeRead(writeCache(), WriteCache::Brightness, result);
+    return result;
+}
+
+Result<DBusCommand> Led::prepareEffect(::openrazer::Effect effect, const EffectParams &params)
+{
+    switch (effect) {
+    case ::openrazer::Effect::Off:
+        return d->ledIface()->prepareCall("setOff");
+    case ::openrazer::Effect::On:
+        return d->ledIface()->prepareCall("setOn");
+    case ::openrazer::Effect::Static:
+        return d->ledIface()->prepareCall("setStatic", { QVariant::fromValue(params.color) });
+    case ::openrazer::Effect::Breathing:
+        return d->ledIface()->prepareCall("setBreathing", { QVariant::fromValue(params.color) });
+    case ::openrazer::Effect::BreathingDual:
+        return d->ledIface()->prepareCall("setBreathingDual", { QVariant::fromValue(params.color), QVariant::fromValue(params.color2) });
+    case ::openrazer::Effect::BreathingRandom:
+        return d->ledIface()->prepareCall("setBreathingRandom");
+    case ::openrazer::Effect::Blinking:
+        return d->ledIface()->prepareCall("setBlinking", { QVariant::fromValue(params.color) });
+    case ::openrazer::Effect::Spectrum:
+        return d->ledIface()->prepareCall("setSpectrum");
+    case ::openrazer::Effect::Wave:
+        return d->ledIface()->prepareCall("setWave", { QVariant::fromValue(params.waveDirection) });
+    case ::openrazer::Effect::Reactive:
+        return d->ledIface()->prepareCall("setReactive", { QVariant::fromValue(params.reactiveSpeed), QVariant::fromValue(params.color) });
+    case ::openrazer::Effect::Wheel:
+    case ::openrazer::Effect::BreathingMono:
+    case ::openrazer::Effect::Ripple:
+    case ::openrazer::Effect::RippleRandom:
+        // TODO Needs implementation
+        break;
+    }
+    return notSupportedError("The effect is not supported by this Led.");
 }
 
 bool LedPrivate::hasFx(const QString &fxStr)
@@ -195,19 +232,26 @@ bool LedPrivate::hasFx(const QString &fxStr)
     return device->d->supportedFx.contains(fxStr);
 }
 
-QDBusInterface *LedPrivate::ledIface()
+DBusInterface *LedPrivate::ledIface()
 {
     if (iface == nullptr) {
-        iface = new QDBusInterface(OPENRAZER_SERVICE_NAME, mObjectPath.path(), "io.github.openrazer1.Led",
-                                   OPENRAZER_DBUS_BUS, mParent);
+        iface = new DBusInterface(OPENRAZER_SERVICE_NAME, mObjectPath.path(), "io.github.openrazer1.Led",
+                                  device->d->connection, mParent);
+        iface->setTimeout(device->d->timeout);
     }
     if (!iface->isValid()) {
-        fprintf(stderr, "%s\n",
-                qPrintable(OPENRAZER_DBUS_BUS.lastError().message()));
+        warnRateLimited(lcTransport(), Q_FUNC_INFO, mObjectPath.path(), device->d->connection.lastError().message());
     }
     return iface;
 }
 
+Transport *LedPrivate::ledTransport()
+{
+    if (transport == nullptr)
+        transport = std::make_unique<Transport>(OPENRAZER_SERVICE_NAME, mObjectPath.path(), device->d->connection);
+    return transport.get();
+}
+
 }
 
 }
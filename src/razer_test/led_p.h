@@ -7,7 +7,10 @@
 
 #include "libopenrazer/led.h"
 
-#include <QDBusInterface>
+#include "dbusinterface_p.h"
+#include "transport_p.h"
+
+#include <memory>
 
 namespace libopenrazer {
 
@@ -19,9 +22,15 @@ public:
     Led *mParent = nullptr;
 
     bool hasFx(const QString &fxStr);
-
-    QDBusInterface *iface = nullptr;
-    QDBusInterface *ledIface();
+    // Calls the setter \a method of \a effect through the write cache of the Led, defined in led.cpp
+    template<typename... Args>
+    Result<void> setEffect(WriteCache *cache, ::openrazer::Effect effect, const char *method, const Args &...args);
+
+    DBusInterface *iface = nullptr;
+    DBusInterface *ledIface();
+    // The setters are written through this, see Transport
+    std::unique_ptr<Transport> transport;
+    Transport *ledTransport();
 
     Device *device;
     QDBusObjectPath mObjectPath;
@@ -7,16 +7,32 @@
 #include "manager_p.h"
 
 #include <QDBusMetaType>
-#include <QFileInfo>
-#include <QProcess>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStandardPaths>
 
 namespace libopenrazer {
 
 namespace razer_test {
 
+const char *OPENRAZER_SERVICE_NAME = "io.github.openrazer1";
+
+QDBusConnection defaultConnection()
+{
+    return RAZER_TEST_DBUS_BUS;
+}
+
 Manager::Manager()
+    : Manager(defaultConnection())
+{
+}
+
+Manager::Manager(const QDBusConnection &connection)
 {
-    d = new ManagerPrivate();
+    d = new ManagerPrivate(connection);
     d->mParent = this;
 
     // Register the enums with the Qt system
@@ -25,129 +41,187 @@ Manager::Manager()
 
 bool Manager::isDaemonRunning()
 {
-    QVariant reply = d->managerIface()->property("Version");
+    QDBusReply<QVariant> reply = d->managerIface()->getProperty("Version");
     return reply.isValid();
 }
 
-QVariantHash Manager::getSupportedDevices()
+Result<DeviceCatalog> Manager::tryGetDeviceCatalog()
+{
+    return d->catalog.get(d->managerIface()->circuitBreaker(), deviceCatalogCacheFile(),
+                          [this]() { return tryGetDaemonVersion(); }, &ManagerPrivate::readDeviceDefinitions);
+}
+
+Result<QList<QDBusObjectPath>> Manager::tryGetDevices()
+{
+    return parseDevices(d->managerIface()->getProperty("Devices"));
+}
+
+Result<DBusCommand> Manager::prepareGetDevices()
 {
-    return QVariantHash(); // TODO Needs implementation
+    return d->managerIface()->prepareGetProperty("Devices");
 }
 
-QList<QDBusObjectPath> Manager::getDevices()
+Result<QList<QDBusObjectPath>> Manager::parseDevices(const QDBusMessage &message)
 {
-    QVariant reply = d->managerIface()->property("Devices");
-    return handleDBusVariant<QList<QDBusObjectPath>>(reply, d->managerIface()->lastError(), Q_FUNC_INFO);
+    QDBusReply<QVariant> reply = message;
+    return variantToResult<QList<QDBusObjectPath>>(reply);
+}
+
+Result<DBusCommand> Manager::prepareGetSerial(const QDBusObjectPath &objectPath)
+{
+    DBusCommand command;
+    command.message = QDBusMessage::createMethodCall(OPENRAZER_SERVICE_NAME, objectPath.path(), "io.github.openrazer1.Device", "getSerial");
+    command.connection = deviceConnection(objectPath, d->connection);
+    command.timeout = d->timeout;
+    return command;
 }
 
 Device *Manager::getDevice(QDBusObjectPath objectPath)
 {
-    return new Device(objectPath);
+    return new Device(objectPath, deviceConnection(objectPath, d->connection), d->timeout);
 }
 
-void Manager::syncEffects(bool yes)
+Result<void> Manager::trySyncEffects(bool yes)
 {
     // TODO Needs implementation
+    return notSupportedError("Syncing effects is not implemented for razer_test.");
 }
 
-bool Manager::getSyncEffects()
+Result<bool> Manager::tryGetSyncEffects()
 {
-    return false; // TODO Needs implementation
+    // TODO Needs implementation
+    return notSupportedError("Syncing effects is not implemented for razer_test.");
 }
 
-QString Manager::getDaemonVersion()
+Result<QString> Manager::tryGetDaemonVersion()
 {
-    QVariant reply = d->managerIface()->property("Version");
-    return handleDBusVariant<QString>(reply, d->managerIface()->lastError(), Q_FUNC_INFO);
+    QDBusReply<QVariant> reply = d->managerIface()->getProperty("Version");
+    return variantToResult<QString>(reply);
 }
 
-void Manager::setTurnOffOnScreensaver(bool turnOffOnScreensaver)
+Result<void> Manager::trySetTurnOffOnScreensaver(bool turnOffOnScreensaver)
 {
     // TODO Needs implementation
+    return notSupportedError("Turning off on screensaver is not implemented for razer_test.");
 }
 
-bool Manager::getTurnOffOnScreensaver()
+Result<bool> Manager::tryGetTurnOffOnScreensaver()
 {
-    return false; // TODO Needs implementation
+    // TODO Needs implementation
+    return notSupportedError("Turning off on screensaver is not implemented for razer_test.");
 }
 
 DaemonStatus Manager::getDaemonStatus()
 {
-    // Scenarios to handle:
-    // - Command systemctl doesn't exist (e.g. Alpine or Gentoo) - exit code 255
-    // - Unit wasn't found (i.e. daemon is not installed - or only an old version) - exit code 1
-    // Daemon can be not installed but enabled -.-
-    QProcess process;
-    process.start("systemctl", QStringList() << "is-enabled"
-                                             << "razer_test.service");
-    process.waitForFinished();
-    QString output(process.readAllStandardOutput());
-    QString error(process.readAllStandardError());
-    if (output == "enabled\n")
-        return DaemonStatus::Enabled;
-    else if (output == "disabled\n")
-        return DaemonStatus::Disabled;
-    else if (error == "Failed to get unit file state for razer_test.service: No such file or directory\n")
-        return DaemonStatus::NotInstalled;
-    else if (process.error() == QProcess::FailedToStart) { // check if systemctl could be started - fails on non-systemd distros and flatpak
-        QFileInfo daemonFile("/usr/bin/razer_test");
-        // if the daemon executable does not exist, show the not_installed message - probably flatpak
-        if (!daemonFile.exists())
-            return DaemonStatus::NotInstalled;
-        // otherwise show the NoSystemd message - probably a non-systemd distro
-        return DaemonStatus::NoSystemd;
-    } else {
-        qWarning("libopenrazer: There was an error checking if the daemon is enabled. Unit state is: %s. Error message: %s", qUtf8Printable(output), qUtf8Printable(error));
-        return DaemonStatus::Unknown;
-    }
+    return d->systemdUnit()->status();
+}
+
+void Manager::getDaemonStatusAsync(QObject *context, const std::function<void(DaemonStatus status)> &callback)
+{
+    d->systemdUnit()->statusAsync(context, callback);
 }
 
 QString Manager::getDaemonStatusOutput()
 {
-    QProcess process;
-    process.start("systemctl", QStringList() << "status"
-                                             << "razer_test.service");
-    process.waitForFinished();
-    QString output(process.readAllStandardOutput());
-    QString error(process.readAllStandardError());
-    // TODO Handle systemctl not found
-    // TODO Check if output and error and only display what's filled (to get rid of stray newline)
-    return output + "\n" + error;
+    return d->systemdUnit()->statusOutput();
 }
 
 bool Manager::enableDaemon()
 {
-    QProcess process;
-    process.start("systemctl", QStringList() << "enable"
-                                             << "razer_test.service");
-    process.waitForFinished();
-    return process.exitCode() == 0;
+    return d->systemdUnit()->enable();
+}
+
+void Manager::enableDaemonAsync(QObject *context, const std::function<void(bool success)> &callback)
+{
+    d->systemdUnit()->enableAsync(context, callback);
 }
 
 // TODO New Qt5 connect style syntax - maybe https://stackoverflow.com/a/35501065/3527128
 bool Manager::connectDevicesChanged(QObject *receiver, const char *slot)
 {
-    return OPENRAZER_DBUS_BUS.connect(OPENRAZER_SERVICE_NAME, "/io/github/openrazer1", "io.github.openrazer1.Manager", "devicesChanged", receiver, slot);
+    return d->connection.connect(OPENRAZER_SERVICE_NAME, "/io/github/openrazer1", "io.github.openrazer1.Manager", "devicesChanged", receiver, slot);
 }
 
 QDBusServiceWatcher *Manager::getServiceWatcher()
 {
-    return new QDBusServiceWatcher(OPENRAZER_SERVICE_NAME, OPENRAZER_DBUS_BUS);
+    return new QDBusServiceWatcher(OPENRAZER_SERVICE_NAME, d->connection);
 }
 
-QDBusInterface *ManagerPrivate::managerIface()
+QDBusConnection Manager::connection() const
+{
+    return d->connection;
+}
+
+void Manager::setDefaultTimeout(int msecs)
+{
+    d->timeout = msecs;
+    if (d->iface != nullptr)
+        d->iface->setTimeout(msecs);
+}
+
+int Manager::defaultTimeout()
+{
+    return d->timeout;
+}
+
+ManagerPrivate::ManagerPrivate(const QDBusConnection &connection)
+    : connection(connection)
+{
+}
+
+DBusInterface *ManagerPrivate::managerIface()
 {
     if (iface == nullptr) {
-        iface = new QDBusInterface(OPENRAZER_SERVICE_NAME, "/io/github/openrazer1", "io.github.openrazer1.Manager",
-                                   OPENRAZER_DBUS_BUS, mParent);
+        iface = new DBusInterface(OPENRAZER_SERVICE_NAME, "/io/github/openrazer1", "io.github.openrazer1.Manager",
+                                  connection, mParent);
+        iface->setTimeout(timeout);
     }
     if (!iface->isValid()) {
-        fprintf(stderr, "%s\n",
-                qPrintable(OPENRAZER_DBUS_BUS.lastError().message()));
+        warnRateLimited(lcTransport(), Q_FUNC_INFO, "/io/github/openrazer1", connection.lastError().message());
     }
     return iface;
 }
 
+
+SystemdUnit *ManagerPrivate::systemdUnit()
+{
+    if (unit == nullptr) {
+        unit = new SystemdUnit("razer_test.service", "/usr/bin/razer_test", connection, mParent);
+    }
+    return unit;
+}
+
+
+// The IDs are written as hex strings, e.g. "1532"
+static ushort idFromJson(const QJsonValue &value)
+{
+    if (value.isString())
+        return value.toString().toUShort(nullptr, 16);
+    return value.toInt();
+}
+
+Result<DeviceCatalog> ManagerPrivate::readDeviceDefinitions(const QString &version)
+{
+    const QStringList directories = QStandardPaths::locateAll(QStandardPaths::GenericDataLocation, "razer_test/devices", QStandardPaths::LocateDirectory);
+    if (directories.isEmpty())
+        return Error("Device definitions not found", "The device definitions of razer_test are not installed.");
+
+    DeviceCatalog catalog(version);
+    for (const QString &directory : directories) {
+        for (const QFileInfo &fileInfo : QDir(directory).entryInfoList({ "*.json" }, QDir::Files, QDir::Name)) {
+            QFile file(fileInfo.filePath());
+            if (!file.open(QIODevice::ReadOnly))
+                continue;
+            const QJsonArray devices = QJsonDocument::fromJson(file.readAll()).array();
+            for (const QJsonValue &value : devices) {
+                const QJsonObject device = value.toObject();
+                catalog.insert(device.value("name").toString(), idFromJson(device.value("vid")), idFromJson(device.value("pid")));
+            }
+        }
+    }
+    return catalog;
+}
+
 }
 
 }
@@ -7,7 +7,9 @@
 
 #include "libopenrazer/manager.h"
 
-#include <QDBusInterface>
+#include "dbusinterface_p.h"
+#include "devicecatalog_p.h"
+#include "systemdunit_p.h"
 
 #if defined(Q_OS_LINUX) || defined(Q_OS_FREEBSD)
 #define RAZER_TEST_DBUS_BUS QDBusConnection::systemBus()
@@ -21,16 +23,25 @@ namespace libopenrazer {
 
 namespace razer_test {
 
-const char *OPENRAZER_SERVICE_NAME = "io.github.openrazer1";
-QDBusConnection OPENRAZER_DBUS_BUS = RAZER_TEST_DBUS_BUS;
-
 class ManagerPrivate
 {
 public:
+    explicit ManagerPrivate(const QDBusConnection &connection);
+
     Manager *mParent = nullptr;
 
-    QDBusInterface *iface = nullptr;
-    QDBusInterface *managerIface();
+    QDBusConnection connection;
+    int timeout = -1;
+
+    SystemdUnit *unit = nullptr;
+    SystemdUnit *systemdUnit();
+
+    DeviceCatalogCache catalog;
+    // razer_test has no D-Bus API for this, it installs a JSON file per device class
+    static Result<DeviceCatalog> readDeviceDefinitions(const QString &version);
+
+    DBusInterface *iface = nullptr;
+    DBusInterface *managerIface();
 };
 
 }
@@ -0,0 +1,46 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "circuitbreaker_p.h"
+#include "libopenrazer/result.h"
+
+namespace libopenrazer {
+
+static Error::Type errorType(const QString &name)
+{
+    if (name == SERVICE_UNAVAILABLE_ERROR)
+        return Error::ServiceUnavailable;
+    if (name == DEADLINE_EXCEEDED_ERROR
+        || name == QDBusError::errorString(QDBusError::NoReply)
+        || name == QDBusError::errorString(QDBusError::Timeout))
+        return Error::Timeout;
+    return Error::Failed;
+}
+
+Error::Error(const QDBusError &error)
+    : m_type(errorType(error.name())), m_name(error.name()), m_message(error.message())
+{
+}
+
+Error::Error(const QString &name, const QString &message)
+    : m_type(errorType(name)), m_name(name), m_message(message)
+{
+}
+
+Error::Type Error::type() const
+{
+    return m_type;
+}
+
+QString Error::name() const
+{
+    return m_name;
+}
+
+QString Error::message() const
+{
+    return m_message;
+}
+
+}
@@ -0,0 +1,364 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "libopenrazer.h"
+#include "libopenrazer_private.h"
+#include "scene_p.h"
+
+#include <QDBusReply>
+#include <QDataStream>
+#include <QFile>
+#include <QHash>
+#include <QMetaEnum>
+#include <QSaveFile>
+
+namespace libopenrazer {
+
+static constexpr quint32 FILE_MAGIC = 0x4c4f5253; // "LORS"
+static constexpr quint32 FILE_VERSION = 1;
+
+static void writeRGB(QDataStream &stream, const ::openrazer::RGB &color)
+{
+    stream << quint8(color.r) << quint8(color.g) << quint8(color.b);
+}
+
+static ::openrazer::RGB readRGB(QDataStream &stream)
+{
+    quint8 r, g, b;
+    stream >> r >> g >> b;
+    return { r, g, b };
+}
+
+static void writeEntry(QDataStream &stream, const SceneEntry &entry)
+{
+    stream << quint8(entry.kind) << entry.serial;
+    switch (entry.kind) {
+    case SceneEntry::Effect:
+        stream << quint8(entry.ledId) << quint8(entry.effect);
+        writeRGB(stream, entry.params.color);
+        writeRGB(stream, entry.params.color2);
+        stream << quint8(entry.params.waveDirection) << quint8(entry.params.wheelDirection) << quint8(entry.params.reactiveSpeed);
+        break;
+    case SceneEntry::Brightness:
+        stream << quint8(entry.ledId) << quint8(entry.brightness);
+        break;
+    case SceneEntry::DPI:
+        stream << quint16(entry.dpi.dpi_x) << quint16(entry.dpi.dpi_y);
+        break;
+    case SceneEntry::DPIStages:
+        stream << quint8(entry.activeStage) << quint8(entry.dpiStages.size());
+        for (const ::openrazer::DPI &dpi : entry.dpiStages)
+            stream << quint16(dpi.dpi_x) << quint16(dpi.dpi_y);
+        break;
+    case SceneEntry::PollRate:
+        stream << quint16(entry.pollrate);
+        break;
+    }
+}
+
+// Whether the byte read from a file is one of the values of the enum
+template<typename T>
+static bool isValidEnum(quint8 value)
+{
+    return QMetaEnum::fromType<T>().valueToKey(value) != nullptr;
+}
+
+static bool readEntry(QDataStream &stream, SceneEntry *entry)
+{
+    quint8 kind, ledId, value, value2, value3;
+    quint16 x, y;
+    stream >> kind >> entry->serial;
+    if (kind > SceneEntry::PollRate)
+        return false;
+    entry->kind = static_cast<SceneEntry::Kind>(kind);
+    switch (entry->kind) {
+    case SceneEntry::Effect:
+        stream >> ledId >> value;
+        if (!isValidEnum<::openrazer::LedId>(ledId) || !isValidEnum<::openrazer::Effect>(value))
+            return false;
+        entry->ledId = static_cast<::openrazer::LedId>(ledId);
+        entry->effect = static_cast<::openrazer::Effect>(value);
+        entry->params.color = readRGB(stream);
+        entry->params.color2 = readRGB(stream);
+        stream >> value >> value2 >> value3;
+        if (!isValidEnum<::openrazer::WaveDirection>(value) || !isValidEnum<::openrazer::WheelDirection>(value2)
+            || !isValidEnum<::openrazer::ReactiveSpeed>(value3))
+            return false;
+        entry->params.waveDirection = static_cast<::openrazer::WaveDirection>(value);
+        entry->params.wheelDirection = static_cast<::openrazer::WheelDirection>(value2);
+        entry->params.reactiveSpeed = static_cast<::openrazer::ReactiveSpeed>(value3);
+        break;
+    case SceneEntry::Brightness:
+        stream >> ledId >> entry->brightness;
+        if (!isValidEnum<::openrazer::LedId>(ledId))
+            return false;
+        entry->ledId = static_cast<::openrazer::LedId>(ledId);
+        break;
+    case SceneEntry::DPI:
+        stream >> x >> y;
+        entry->dpi = { x, y };
+        break;
+    case SceneEntry::DPIStages:
+        stream >> entry->activeStage >> value;
+        entry->dpiStages.clear();
+        for (int i = 0; i < value; i++) {
+            stream >> x >> y;
+            entry->dpiStages.append({ x, y });
+        }
+        break;
+    case SceneEntry::PollRate:
+        stream >> x;
+        entry->pollrate = x;
+        break;
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+Scene::Scene()
+    : d(new ScenePrivate())
+{
+}
+
+Scene::~Scene()
+{
+    delete d;
+}
+
+void ScenePrivate::set(const SceneEntry &entry)
+{
+    compiled = false;
+    commands.clear();
+    cacheTargets.clear();
+
+    bool ledSetting = entry.kind == SceneEntry::Effect || entry.kind == SceneEntry::Brightness;
+    for (SceneEntry &existing : entries) {
+        if (existing.kind == entry.kind && existing.serial == entry.serial
+            && (!ledSetting || existing.ledId == entry.ledId)) {
+            existing = entry;
+            return;
+        }
+    }
+    entries.append(entry);
+}
+
+void Scene::setEffect(const QString &serial, ::openrazer::LedId ledId, ::openrazer::Effect effect, const EffectParams &params)
+{
+    SceneEntry entry { SceneEntry::Effect, serial, ledId };
+    entry.effect = effect;
+    entry.params = params;
+    d->set(entry);
+}
+
+void Scene::setBrightness(const QString &serial, ::openrazer::LedId ledId, uchar brightness)
+{
+    SceneEntry entry { SceneEntry::Brightness, serial, ledId };
+    entry.brightness = brightness;
+    d->set(entry);
+}
+
+void Scene::setDPI(const QString &serial, ::openrazer::DPI dpi)
+{
+    SceneEntry entry { SceneEntry::DPI, serial };
+    entry.dpi = dpi;
+    d->set(entry);
+}
+
+void Scene::setDPIStages(const QString &serial, uchar activeStage, const QVector<::openrazer::DPI> &dpiStages)
+{
+    SceneEntry entry { SceneEntry::DPIStages, serial };
+    entry.activeStage = activeStage;
+    entry.dpiStages = dpiStages;
+    d->set(entry);
+}
+
+void Scene::setPollRate(const QString &serial, ushort pollrate)
+{
+    SceneEntry entry { SceneEntry::PollRate, serial };
+    entry.pollrate = pollrate;
+    d->set(entry);
+}
+
+void Scene::clear()
+{
+    d->entries.clear();
+    d->commands.clear();
+    d->cacheTargets.clear();
+    d->compiled = false;
+}
+
+Result<DBusCommand> ScenePrivate::prepare(Device *device, const SceneEntry &entry, CacheTarget *cacheTarget)
+{
+    Result<DBusCommand> command = notSupportedError("The device doesn't support this setting.");
+    CacheTarget target;
+    switch (entry.kind) {
+    case SceneEntry::Effect:
+    case SceneEntry::Brightness:
+        for (Led *led : device->getLeds()) {
+            Result<::openrazer::LedId> ledId = led->tryGetLedId();
+            if (!ledId || ledId.value() != entry.ledId)
+                continue;
+            if (entry.kind == SceneEntry::Effect && led->hasFx(entry.effect)) {
+                target.led = led;
+                target.slot = WriteCache::Effect;
+                command = led->prepareEffect(entry.effect, entry.params);
+            } else if (entry.kind == SceneEntry::Brightness && led->hasBrightness()) {
+                target.led = led;
+                target.slot = WriteCache::Brightness;
+                command = led->prepareSetBrightness(entry.brightness);
+            }
+            break;
+        }
+        break;
+    case SceneEntry::DPI:
+        if (device->hasFeature(Feature::DPI)) {
+            // Not cached
+            target.device = device;
+            command = device->prepareSetDPI(entry.dpi);
+        }
+        break;
+    case SceneEntry::DPIStages:
+        if (device->hasFeature(Feature::DPIStages)) {
+            // Not cached
+            target.device = device;
+            command = device->prepareSetDPIStages(entry.activeStage, entry.dpiStages);
+        }
+        break;
+    case SceneEntry::PollRate:
+        if (device->hasFeature(Feature::PollRate)) {
+            target.device = device;
+            target.slot = WriteCache::PollRate;
+            command = device->prepareSetPollRate(entry.pollrate);
+        }
+        break;
+    }
+    // Only describe what a command that is actually sent changes
+    if (command)
+        *cacheTarget = target;
+    return command;
+}
+
+void ScenePrivate::invalidate(const CacheTarget &cacheTarget)
+{
+    if (cacheTarget.slot == WriteCache::SlotCount)
+        return;
+    WriteCache *cache = nullptr;
+    if (!cacheTarget.device.isNull())
+        cache = cacheTarget.device->m_writeCache;
+    else if (!cacheTarget.led.isNull())
+        cache = cacheTarget.led->m_writeCache;
+    if (cache != nullptr)
+        cache->invalidate(cacheTarget.slot);
+}
+
+QHash<QString, Device *> ScenePrivate::devicesBySerial(const QList<Device *> &devices)
+{
+    QHash<QString, Device *> devicesBySerial;
+    QList<DBusCommand> commands;
+    QList<Device *> asked;
+    for (Device *device : devices) {
+        Result<DBusCommand> command = device->prepareGetSerial();
+        if (command) {
+            commands.append(command.value());
+            asked.append(device);
+            continue;
+        }
+        Result<QString> serial = device->tryGetSerial();
+        if (serial)
+            devicesBySerial.insert(serial.value(), device);
+    }
+
+    QList<QDBusMessage> replies = sendDBusCommands(commands);
+    for (int i = 0; i < replies.size(); i++) {
+        QDBusReply<QString> reply = replies[i];
+        if (reply.isValid())
+            devicesBySerial.insert(reply.value(), asked[i]);
+    }
+    return devicesBySerial;
+}
+
+int Scene::compile(const QList<Device *> &devices)
+{
+    QHash<QString, Device *> devicesBySerial = ScenePrivate::devicesBySerial(devices);
+
+    d->commands.clear();
+    d->cacheTargets.clear();
+    for (const SceneEntry &entry : d->entries) {
+        Device *device = devicesBySerial.value(entry.serial);
+        if (device == nullptr)
+            continue;
+        ScenePrivate::CacheTarget cacheTarget;
+        Result<DBusCommand> command = ScenePrivate::prepare(device, entry, &cacheTarget);
+        if (command) {
+            d->commands.append(command.value());
+            d->cacheTargets.append(cacheTarget);
+        }
+    }
+    d->compiled = true;
+    return d->commands.size();
+}
+
+bool Scene::isCompiled() const
+{
+    return d->compiled;
+}
+
+Result<void> Scene::apply()
+{
+    if (!d->compiled) {
+        return Error("Scene not compiled", "compile() has to be called before apply().");
+    }
+
+    QList<QDBusMessage> replies = sendDBusCommands(d->commands);
+    Result<void> result;
+    for (int i = 0; i < replies.size(); i++) {
+        // The value was set without going through the write cache
+        ScenePrivate::invalidate(d->cacheTargets[i]);
+        Result<void> commandReply = commandResult(d->commands[i], replies[i]);
+        if (!commandReply && result)
+            result = commandReply;
+    }
+    return result;
+}
+
+bool Scene::save(const QString &fileName) const
+{
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << FILE_MAGIC << FILE_VERSION << quint32(d->entries.size());
+    for (const SceneEntry &entry : d->entries)
+        writeEntry(stream, entry);
+    return stream.status() == QDataStream::Ok && file.commit();
+}
+
+bool Scene::load(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    quint32 magic, version, count;
+    stream >> magic >> version >> count;
+    if (stream.status() != QDataStream::Ok || magic != FILE_MAGIC || version != FILE_VERSION)
+        return false;
+
+    QList<SceneEntry> entries;
+    for (quint32 i = 0; i < count; i++) {
+        SceneEntry entry;
+        if (!readEntry(stream, &entry))
+            return false;
+        entries.append(entry);
+    }
+
+    d->entries = entries;
+    d->commands.clear();
+    d->cacheTargets.clear();
+    d->compiled = false;
+    return true;
+}
+
+}
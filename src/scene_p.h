@@ -0,0 +1,65 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SCENE_P_H
+#define SCENE_P_H
+
+#include "libopenrazer/scene.h"
+
+#include "dbusinterface_p.h"
+#include "writecache_p.h"
+
+#include <QPointer>
+
+namespace libopenrazer {
+
+struct SceneEntry {
+    enum Kind : quint8 {
+        Effect,
+        Brightness,
+        DPI,
+        DPIStages,
+        PollRate,
+    };
+    Kind kind;
+    QString serial;
+    // For Effect and Brightness
+    ::openrazer::LedId ledId = ::openrazer::LedId::Unspecified;
+
+    ::openrazer::Effect effect = ::openrazer::Effect::Off;
+    EffectParams params;
+    uchar brightness = 0;
+    ::openrazer::DPI dpi = { 0, 0 };
+    uchar activeStage = 0;
+    QVector<::openrazer::DPI> dpiStages;
+    ushort pollrate = 0;
+};
+
+class ScenePrivate
+{
+public:
+    QList<SceneEntry> entries;
+
+    bool compiled = false;
+    QList<DBusCommand> commands;
+
+    // The write cache value each of the commands changes
+    struct CacheTarget {
+        QPointer<Device> device;
+        QPointer<Led> led;
+        // SlotCount if the value isn't cached
+        WriteCache::Slot slot = WriteCache::SlotCount;
+    };
+    QList<CacheTarget> cacheTargets;
+
+    void set(const SceneEntry &entry);
+    // Reads the serials of all devices in one batch of calls
+    static QHash<QString, Device *> devicesBySerial(const QList<Device *> &devices);
+    static Result<DBusCommand> prepare(Device *device, const SceneEntry &entry, CacheTarget *cacheTarget);
+    static void invalidate(const CacheTarget &cacheTarget);
+};
+
+}
+
+#endif // SCENE_P_H
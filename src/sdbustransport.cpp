@@ -0,0 +1,268 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "sdbustransport_p.h"
+#include "dbusinterface_p.h"
+#include "logging_p.h"
+
+#include <QCoreApplication>
+#include <QDBusError>
+
+#include <cerrno>
+#include <cstring>
+
+namespace libopenrazer {
+
+// The connection itself is gone, as opposed to the daemon answering with an error
+static bool isConnectionFailure(int error)
+{
+    return error == -ENOTCONN || error == -ECONNRESET || error == -EPIPE;
+}
+
+SdBusConnection *SdBusConnection::forConnection(const QDBusConnection &bus)
+{
+    if (bus.name() == QDBusConnection::sessionBus().name()) {
+        static thread_local SdBusConnection session(false);
+        return &session;
+    }
+    if (bus.name() == QDBusConnection::systemBus().name()) {
+        static thread_local SdBusConnection system(true);
+        return &system;
+    }
+    return nullptr;
+}
+
+SdBusConnection::SdBusConnection(bool system)
+    : system(system)
+{
+}
+
+SdBusConnection::~SdBusConnection()
+{
+    // Runs when the thread exits, its event dispatcher may be gone already so
+    // the notifier is left alone
+    if (bus != nullptr)
+        sd_bus_flush_close_unref(bus);
+}
+
+std::unique_ptr<TransportCall> SdBusConnection::createCall(const QByteArray &service, const QByteArray &path,
+                                                           const char *interface, const char *method,
+                                                           CircuitBreaker *breaker)
+{
+    sd_bus *connection = this->connection();
+    if (connection == nullptr)
+        return nullptr;
+
+    sd_bus_message *message = nullptr;
+    int r = sd_bus_message_new_method_call(connection, &message, service.constData(), path.constData(), interface, method);
+    if (r < 0) {
+        warnRateLimited(lcTransport(), Q_FUNC_INFO, QString::fromUtf8(path), QString("Could not create the sd-bus call of %1: %2").arg(method, strerror(-r)));
+        return nullptr;
+    }
+    return std::make_unique<SdBusCall>(this, message, breaker);
+}
+
+sd_bus *SdBusConnection::connection()
+{
+    if (bus != nullptr || unavailable)
+        return bus;
+
+    int r = system ? sd_bus_open_system(&bus) : sd_bus_open_user(&bus);
+    if (r < 0) {
+        qCWarning(lcTransport, "libopenrazer: Could not connect to the %s bus with sd-bus, using QtDBus: %s",
+                  system ? "system" : "session", strerror(-r));
+        bus = nullptr;
+        unavailable = true;
+        return nullptr;
+    }
+
+    // Replies are read by sd_bus_call(), this only sees what arrives between
+    // calls. Only has an effect if the thread runs an event loop.
+    notifier = new QSocketNotifier(sd_bus_get_fd(bus), QSocketNotifier::Read);
+    QObject::connect(notifier, &QSocketNotifier::activated, notifier, [this]() { process(); });
+    return bus;
+}
+
+void SdBusConnection::drop()
+{
+    if (bus == nullptr)
+        return;
+
+    // May be called from the notifier itself, it must not fire for a closed
+    // socket anymore though
+    notifier->setEnabled(false);
+    notifier->deleteLater();
+    notifier = nullptr;
+    sd_bus_flush_close_unref(bus);
+    bus = nullptr;
+}
+
+void SdBusConnection::process()
+{
+    if (bus == nullptr)
+        return;
+
+    int r;
+    do {
+        r = sd_bus_process(bus, nullptr);
+    } while (r > 0);
+    if (r < 0) {
+        qCWarning(lcTransport, "libopenrazer: Lost the sd-bus connection to the %s bus: %s",
+                  system ? "system" : "session", strerror(-r));
+        drop();
+    }
+}
+
+Result<void> SdBusConnection::call(sd_bus_message *message, int timeout, bool limitedByDeadline, CircuitBreaker *breaker)
+{
+    const char *member = sd_bus_message_get_member(message);
+
+    // Created before the connection was lost
+    if (bus == nullptr || sd_bus_message_get_bus(message) != bus) {
+        breaker->recordAborted();
+        return Error(SD_BUS_ERROR_DISCONNECTED, QString("The sd-bus connection was closed before %1 was sent").arg(member));
+    }
+
+    sd_bus_error error = SD_BUS_ERROR_NULL;
+    sd_bus_message *reply = nullptr;
+    // 0 is the default timeout of sd-bus, like -1 for QtDBus
+    int r = sd_bus_call(bus, message, timeout < 0 ? 0 : static_cast<uint64_t>(timeout) * 1000, &error, &reply);
+
+    Result<void> result;
+    if (r < 0) {
+        QString name = sd_bus_error_is_set(&error) ? QString::fromUtf8(error.name) : QString(SD_BUS_ERROR_FAILED);
+        QString text = error.message != nullptr ? QString::fromUtf8(error.message) : QString::fromLocal8Bit(strerror(-r));
+        if (isConnectionFailure(r)) {
+            // Our connection is gone, that doesn't say anything about the service
+            qCWarning(lcTransport, "libopenrazer: Lost the sd-bus connection to the %s bus: %s",
+                      system ? "system" : "session", qUtf8Printable(text));
+            drop();
+            breaker->recordAborted();
+        } else {
+            if (limitedByDeadline && (name == SD_BUS_ERROR_NO_REPLY || name == SD_BUS_ERROR_TIMEOUT)) {
+                name = DEADLINE_EXCEEDED_ERROR;
+                text = QString("The deadline expired before %1.%2 finished").arg(sd_bus_message_get_interface(message), member);
+            }
+            breaker->recordReply(QDBusMessage::createError(name, text));
+        }
+        result = Error(name, text);
+    } else {
+        breaker->recordSuccess();
+        // For methods that return false if they didn't succeed, see toVoidResult()
+        int value;
+        if (qstrcmp(sd_bus_message_get_signature(reply, true), "b") == 0
+            && sd_bus_message_read_basic(reply, 'b', &value) >= 0 && !value)
+            result = Error("Call failed", QString("%1 has returned false").arg(member));
+    }
+
+    sd_bus_message_unref(reply);
+    sd_bus_error_free(&error);
+    return result;
+}
+
+SdBusCall::SdBusCall(SdBusConnection *connection, sd_bus_message *message, CircuitBreaker *breaker)
+    : connection(connection), message(message), breaker(breaker)
+{
+}
+
+SdBusCall::~SdBusCall()
+{
+    sd_bus_message_unref(message);
+}
+
+void SdBusCall::check(int result)
+{
+    if (result < 0 && appendError == 0)
+        appendError = result;
+}
+
+void SdBusCall::appendBool(bool value)
+{
+    // sd-bus takes booleans as int
+    int v = value;
+    check(sd_bus_message_append_basic(message, 'b', &v));
+}
+
+void SdBusCall::appendByte(uchar value)
+{
+    check(sd_bus_message_append_basic(message, 'y', &value));
+}
+
+void SdBusCall::appendUInt16(quint16 value)
+{
+    uint16_t v = value;
+    check(sd_bus_message_append_basic(message, 'q', &v));
+}
+
+void SdBusCall::appendInt32(qint32 value)
+{
+    int32_t v = value;
+    check(sd_bus_message_append_basic(message, 'i', &v));
+}
+
+void SdBusCall::appendUInt32(quint32 value)
+{
+    uint32_t v = value;
+    check(sd_bus_message_append_basic(message, 'u', &v));
+}
+
+void SdBusCall::appendDouble(double value)
+{
+    check(sd_bus_message_append_basic(message, 'd', &value));
+}
+
+void SdBusCall::appendBytes(const QByteArray &value)
+{
+    check(sd_bus_message_append_array(message, 'y', value.constData(), value.size()));
+}
+
+void SdBusCall::appendColor(const ::openrazer::RGB &color)
+{
+    check(sd_bus_message_append(message, "(yyy)", color.r, color.g, color.b));
+}
+
+void SdBusCall::appendColors(const QVector<::openrazer::RGB> &colors)
+{
+    check(sd_bus_message_open_container(message, 'a', "(yyy)"));
+    for (const ::openrazer::RGB &color : colors)
+        check(sd_bus_message_append(message, "(yyy)", color.r, color.g, color.b));
+    check(sd_bus_message_close_container(message));
+}
+
+void SdBusCall::appendDPI(const ::openrazer::DPI &dpi)
+{
+    check(sd_bus_message_append(message, "(qq)", dpi.dpi_x, dpi.dpi_y));
+}
+
+void SdBusCall::appendDPIs(const QVector<::openrazer::DPI> &dpis)
+{
+    check(sd_bus_message_open_container(message, 'a', "(qq)"));
+    for (const ::openrazer::DPI &dpi : dpis)
+        check(sd_bus_message_append(message, "(qq)", dpi.dpi_x, dpi.dpi_y));
+    check(sd_bus_message_close_container(message));
+}
+
+void SdBusCall::appendEnum(int value)
+{
+    check(sd_bus_message_append(message, "(i)", value));
+}
+
+Result<void> SdBusCall::send(int timeout)
+{
+    const char *interface = sd_bus_message_get_interface(message);
+    const char *member = sd_bus_message_get_member(message);
+    if (appendError < 0)
+        return Error("Invalid arguments", QString("Could not append the arguments of %1: %2").arg(member, strerror(-appendError)));
+
+    bool limitedByDeadline;
+    if (!applyDeadline(&timeout, &limitedByDeadline))
+        return Error(DEADLINE_EXCEEDED_ERROR, QString("The deadline expired before %1.%2 finished").arg(interface, member));
+
+    if (!breaker->allowRequest())
+        return Error(QDBusError(breaker->unavailableError()));
+
+    return connection->call(message, timeout, limitedByDeadline, breaker);
+}
+
+}
@@ -0,0 +1,101 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SDBUSTRANSPORT_P_H
+#define SDBUSTRANSPORT_P_H
+
+#include "transport_p.h"
+
+#include <QSocketNotifier>
+
+#include <systemd/sd-bus.h>
+
+namespace libopenrazer {
+
+/*
+ * Connection to the session or system bus through sd-bus, used by Transport
+ * when libopenrazer is built with the sd-bus transport.
+ *
+ * sd-bus objects aren't thread-safe, so every thread gets connections of its
+ * own instead of waiting for the calls of other threads. A connection is
+ * opened on first use and shared by all devices on the bus. Calls wait for
+ * their reply in sd_bus_call(). In threads running an event loop the socket
+ * is also watched with a QSocketNotifier, which processes what the bus sends
+ * without being asked, e.g. NameAcquired, and notices when the connection is
+ * closed. A lost connection is opened again by the next call.
+ */
+class SdBusConnection
+{
+public:
+    /*
+     * Returns the connection of the current thread to the bus of \a bus, or
+     * nullptr if that isn't the session or system bus. QtDBus doesn't tell
+     * the address of other connections.
+     */
+    static SdBusConnection *forConnection(const QDBusConnection &bus);
+
+    /*
+     * Returns a new call of \a method on \a path, or nullptr if the bus can't
+     * be reached through sd-bus. Calls are checked against \a breaker.
+     */
+    std::unique_ptr<TransportCall> createCall(const QByteArray &service, const QByteArray &path,
+                                              const char *interface, const char *method,
+                                              CircuitBreaker *breaker);
+
+private:
+    explicit SdBusConnection(bool system);
+    ~SdBusConnection();
+
+    sd_bus *connection();
+    void drop();
+
+    void process();
+    Result<void> call(sd_bus_message *message, int timeout, bool limitedByDeadline, CircuitBreaker *breaker);
+
+    bool system;
+
+    sd_bus *bus = nullptr;
+    QSocketNotifier *notifier = nullptr;
+    // Set when the bus couldn't be opened, QtDBus is used from then on
+    bool unavailable = false;
+
+    friend class SdBusCall;
+};
+
+/*
+ * Method call written directly into an sd-bus message.
+ */
+class SdBusCall : public TransportCall
+{
+public:
+    SdBusCall(SdBusConnection *connection, sd_bus_message *message, CircuitBreaker *breaker);
+    ~SdBusCall() override;
+
+    void appendBool(bool value) override;
+    void appendByte(uchar value) override;
+    void appendUInt16(quint16 value) override;
+    void appendInt32(qint32 value) override;
+    void appendUInt32(quint32 value) override;
+    void appendDouble(double value) override;
+    void appendBytes(const QByteArray &value) override;
+    void appendColor(const ::openrazer::RGB &color) override;
+    void appendColors(const QVector<::openrazer::RGB> &colors) override;
+    void appendDPI(const ::openrazer::DPI &dpi) override;
+    void appendDPIs(const QVector<::openrazer::DPI> &dpis) override;
+    void appendEnum(int value) override;
+    Result<void> send(int timeout) override;
+
+private:
+    void check(int result);
+
+    SdBusConnection *connection;
+    sd_bus_message *message;
+    CircuitBreaker *breaker;
+    // First error while appending the arguments, reported by send()
+    int appendError = 0;
+};
+
+}
+
+#endif // SDBUSTRANSPORT_P_H
@@ -0,0 +1,448 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "device_p.h"
+#include "libopenrazer.h"
+#include "libopenrazer_private.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QRegularExpression>
+
+#include <algorithm>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+namespace libopenrazer {
+
+namespace sysfs {
+
+// sysfs hands at most a page to the driver per write
+static constexpr int MAX_WRITE_SIZE = 4096;
+
+struct LedLocation {
+    ::openrazer::LedId ledId;
+    const char *name;
+    const char *effectPrefix;
+    const char *brightnessAttribute;
+};
+
+static const LedLocation LED_LOCATIONS[] = {
+    { ::openrazer::LedId::Unspecified, "chroma", "matrix_effect_", "matrix_brightness" },
+    { ::openrazer::LedId::LogoLED, "logo", "logo_matrix_effect_", "logo_led_brightness" },
+    { ::openrazer::LedId::ScrollWheelLED, "scroll", "scroll_matrix_effect_", "scroll_led_brightness" },
+    { ::openrazer::LedId::BacklightLED, "backlight", "backlight_matrix_effect_", "backlight_led_brightness" },
+    { ::openrazer::LedId::LeftSideLED, "left", "left_matrix_effect_", "left_led_brightness" },
+    { ::openrazer::LedId::RightSideLED, "right", "right_matrix_effect_", "right_led_brightness" },
+};
+
+static const QPair<const char *, Feature> FEATURE_ATTRIBUTES[] = {
+    { "dpi", Feature::DPI },
+    { "dpi_stages", Feature::DPIStages },
+    { "poll_rate", Feature::PollRate },
+    { "matrix_custom_frame", Feature::CustomFrame },
+    { "charge_level", Feature::Battery },
+    { "charge_low_threshold", Feature::LowBatteryThreshold },
+    { "device_idle_time", Feature::IdleTime },
+};
+
+// Same names as the daemon uses for the device types
+static const QHash<QString, QString> DEVICE_TYPES {
+    { "razerkbd", "keyboard" },
+    { "razermouse", "mouse" },
+    { "razerfirefly", "mousemat" },
+    { "razermousemat", "mousemat" },
+    { "razerkraken", "headset" },
+    { "razercore", "core" },
+    { "razermug", "mug" },
+    { "razeraccessory", "accessory" },
+};
+
+static Error notSupported(const char *what)
+{
+    return notSupportedError(QString("%1 is not available through the sysfs backend.").arg(what));
+}
+
+Device::Device(const QString &path)
+{
+    d = new DevicePrivate();
+    d->mParent = this;
+    d->path = QDir::cleanPath(path);
+
+    // The driver link only exists in the real sysfs, fake trees just list the devices in a directory per driver
+    QFileInfo driverLink(d->path + "/driver");
+    if (driverLink.isSymLink())
+        d->driver = QFileInfo(driverLink.symLinkTarget()).fileName();
+    else
+        d->driver = QFileInfo(QFileInfo(d->path).path()).fileName();
+
+    QString name = QFileInfo(d->path).fileName();
+    name.replace(QRegularExpression("[^A-Za-z0-9_]"), "_");
+    d->mObjectPath = QDBusObjectPath("/sysfs/" + name);
+
+    for (const auto &[attribute, feature] : FEATURE_ATTRIBUTES) {
+        if (d->hasAttribute(attribute))
+            d->supportedFeatures |= feature;
+    }
+
+    for (const LedLocation &location : LED_LOCATIONS) {
+        Led *led = new Led(this, location.ledId, location.effectPrefix, location.brightnessAttribute,
+                           QDBusObjectPath(d->mObjectPath.path() + "/" + location.name));
+        // Only keep the Leds the driver has any attribute for
+        if (led->hasBrightness() || std::any_of(ledFxList.cbegin(), ledFxList.cend(), [led](const Capability &capability) { return led->hasFx(capability.getIdentifier()); }))
+            d->leds.append(led);
+        else
+            delete led;
+    }
+}
+
+Device::~Device()
+{
+    for (libopenrazer::Led *led : d->leds) {
+        delete led;
+    }
+    delete d;
+}
+
+QList<Device *> Device::openAll(const QString &root)
+{
+    // e.g. 0003:1532:0203.0001, bus:vid:pid.instance
+    static const QRegularExpression devicePattern("^[0-9A-F]{4}:1532:[0-9A-F]{4}\\.[0-9A-F]+$");
+
+    QList<Device *> devices;
+    QDir rootDir(root);
+    for (const QString &driver : rootDir.entryList({ "razer*" }, QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name)) {
+        QDir driverDir(rootDir.filePath(driver));
+        for (const QString &entry : driverDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name)) {
+            // The driver creates its attributes on only one of the interfaces of a device
+            if (!devicePattern.match(entry).hasMatch() || !QFileInfo::exists(driverDir.filePath(entry + "/device_type")))
+                continue;
+            devices.append(new Device(driverDir.filePath(entry)));
+        }
+    }
+    return devices;
+}
+
+QString Device::path() const
+{
+    return d->path;
+}
+
+QDBusObjectPath Device::objectPath()
+{
+    return d->mObjectPath;
+}
+
+Features Device::features()
+{
+    return d->supportedFeatures;
+}
+
+Result<QString> Device::tryGetDeviceImageUrl()
+{
+    // Only the daemon knows the images
+    return QString();
+}
+
+QList<::libopenrazer::Led *> Device::getLeds()
+{
+    return d->leds;
+}
+
+Result<QString> Device::tryGetDeviceMode()
+{
+    Result<QByteArray> mode = d->read("device_mode");
+    if (!mode)
+        return mode.error();
+    if (mode.value().size() < 2)
+        return Error("Invalid device_mode", "The device_mode attribute has an invalid size.");
+    return QString("%1:%2").arg(uchar(mode.value()[0])).arg(uchar(mode.value()[1]));
+}
+
+Result<QString> Device::tryGetSerial()
+{
+    return d->readString("device_serial");
+}
+
+Result<QString> Device::tryGetDeviceName()
+{
+    // Despite its name the attribute contains the name of the device
+    return d->readString("device_type");
+}
+
+Result<QString> Device::tryGetDeviceType()
+{
+    return DEVICE_TYPES.value(d->driver, d->driver);
+}
+
+Result<QString> Device::tryGetFirmwareVersion()
+{
+    return d->readString("firmware_version");
+}
+
+Result<QString> Device::tryGetKeyboardLayout()
+{
+    // The driver only reports a numeric layout id, the daemon has the table mapping it to a name
+    return notSupported("The keyboard layout");
+}
+
+Result<ushort> Device::tryGetPollRate()
+{
+    Result<int> pollRate = d->readNumber("poll_rate");
+    if (!pollRate)
+        return pollRate.error();
+    return static_cast<ushort>(pollRate.value());
+}
+
+Result<void> Device::trySetPollRate(ushort pollrate)
+{
+    return d->write("poll_rate", QByteArray::number(pollrate));
+}
+
+Result<QVector<ushort>> Device::tryGetSupportedPollRates()
+{
+    return QVector<ushort> { 125, 500, 1000 };
+}
+
+static void appendDPI(QByteArray *data, ::openrazer::DPI dpi)
+{
+    // Big-endian, x then y
+    data->append(char(dpi.dpi_x >> 8));
+    data->append(char(dpi.dpi_x & 0xFF));
+    data->append(char(dpi.dpi_y >> 8));
+    data->append(char(dpi.dpi_y & 0xFF));
+}
+
+Result<void> Device::trySetDPI(::openrazer::DPI dpi)
+{
+    QByteArray data;
+    appendDPI(&data, dpi);
+    return d->write("dpi", data);
+}
+
+Result<::openrazer::DPI> Device::tryGetDPI()
+{
+    // e.g. "800:800"
+    Result<QString> dpi = d->readString("dpi");
+    if (!dpi)
+        return dpi.error();
+    QStringList values = dpi.value().split(':');
+    if (values.size() != 2)
+        return Error("Invalid dpi", "The dpi attribute has an invalid format.");
+    return ::openrazer::DPI { values[0].toUShort(), values[1].toUShort() };
+}
+
+Result<void> Device::trySetDPIStages(uchar activeStage, QVector<::openrazer::DPI> dpiStages)
+{
+    QByteArray data;
+    data.append(char(activeStage));
+    for (const ::openrazer::DPI &dpi : dpiStages)
+        appendDPI(&data, dpi);
+    return d->write("dpi_stages", data);
+}
+
+Result<QPair<uchar, QVector<::openrazer::DPI>>> Device::tryGetDPIStages()
+{
+    // The active stage, followed by the stages in the format of trySetDPI()
+    Result<QByteArray> stages = d->read("dpi_stages");
+    if (!stages)
+        return stages.error();
+    const QByteArray &data = stages.value();
+    if (data.isEmpty() || (data.size() - 1) % 4 != 0)
+        return Error("Invalid dpi_stages", "The dpi_stages attribute has an invalid size.");
+    QVector<::openrazer::DPI> dpiStages;
+    for (int i = 1; i < data.size(); i += 4) {
+        dpiStages.append({ static_cast<ushort>(uchar(data[i]) << 8 | uchar(data[i + 1])),
+                           static_cast<ushort>(uchar(data[i + 2]) << 8 | uchar(data[i + 3])) });
+    }
+    return QPair<uchar, QVector<::openrazer::DPI>>(uchar(data[0]), dpiStages);
+}
+
+Result<ushort> Device::tryMaxDPI()
+{
+    return notSupported("The maximum DPI");
+}
+
+Result<QVector<ushort>> Device::tryGetAllowedDPI()
+{
+    // Any value up to the maximum
+    return QVector<ushort>();
+}
+
+Result<double> Device::tryGetBatteryPercent()
+{
+    // 0 - 255
+    Result<int> level = d->readNumber("charge_level");
+    if (!level)
+        return level.error();
+    return level.value() / 255.0 * 100;
+}
+
+Result<bool> Device::tryIsCharging()
+{
+    Result<int> status = d->readNumber("charge_status");
+    if (!status)
+        return status.error();
+    return status.value() != 0;
+}
+
+Result<ushort> Device::tryGetIdleTime()
+{
+    Result<int> idleTime = d->readNumber("device_idle_time");
+    if (!idleTime)
+        return idleTime.error();
+    return static_cast<ushort>(idleTime.value());
+}
+
+Result<void> Device::trySetIdleTime(ushort idleTime)
+{
+    return d->write("device_idle_time", QByteArray::number(idleTime));
+}
+
+Result<double> Device::tryGetLowBatteryThreshold()
+{
+    // 0 - 255, like the charge level
+    Result<int> threshold = d->readNumber("charge_low_threshold");
+    if (!threshold)
+        return threshold.error();
+    return qRound(threshold.value() / 255.0 * 100);
+}
+
+Result<void> Device::trySetLowBatteryThreshold(double threshold)
+{
+    return d->write("charge_low_threshold", QByteArray::number(qRound(threshold / 100 * 255)));
+}
+
+Result<void> Device::tryDisplayCustomFrame()
+{
+    if (!d->pendingFrame.isEmpty()) {
+        Result<void> result = d->write("matrix_custom_frame", d->pendingFrame);
+        d->pendingFrame.clear();
+        if (!result)
+            return result;
+    }
+    return d->write("matrix_effect_custom", QByteArray(1, '1'));
+}
+
+Result<void> Device::tryDefineCustomFrame(uchar row, uchar startColumn, uchar endColumn, QVector<::openrazer::RGB> colorData)
+{
+    QByteArray data;
+    data.reserve(3 + colorData.size() * 3);
+    data.append(char(row));
+    data.append(char(startColumn));
+    data.append(char(endColumn));
+    for (const ::openrazer::RGB &color : colorData) {
+        data.append(char(color.r));
+        data.append(char(color.g));
+        data.append(char(color.b));
+    }
+
+    // The driver takes any number of rows per write, they are sent together by tryDisplayCustomFrame()
+    if (d->pendingFrame.size() + data.size() > MAX_WRITE_SIZE && !d->pendingFrame.isEmpty()) {
+        Result<void> result = d->write("matrix_custom_frame", d->pendingFrame);
+        d->pendingFrame.clear();
+        if (!result)
+            return result;
+    }
+    d->pendingFrame += data;
+    return Result<void>();
+}
+
+Result<::openrazer::MatrixDimensions> Device::tryGetMatrixDimensions()
+{
+    return notSupported("The matrix dimensions");
+}
+
+DevicePrivate::~DevicePrivate()
+{
+    for (int fd : std::as_const(readFds))
+        close(fd);
+    for (int fd : std::as_const(writeFds))
+        close(fd);
+}
+
+bool DevicePrivate::hasAttribute(const QString &name) const
+{
+    return QFileInfo::exists(path + "/" + name);
+}
+
+Error DevicePrivate::errnoError(const QString &name, int error) const
+{
+    return Error("Sysfs error", QString("%1/%2: %3").arg(path, name, QString::fromLocal8Bit(strerror(error))));
+}
+
+int DevicePrivate::fileDescriptor(QHash<QString, int> *fds, const QString &name, int flags)
+{
+    QHash<QString, int>::const_iterator it = fds->constFind(name);
+    if (it != fds->constEnd())
+        return it.value();
+    int fd = open(QFile::encodeName(path + "/" + name).constData(), flags | O_CLOEXEC);
+    if (fd < 0)
+        return fd;
+    fds->insert(name, fd);
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode))
+        regularFiles.insert(name);
+    return fd;
+}
+
+Result<QByteArray> DevicePrivate::read(const QString &name)
+{
+    int fd = fileDescriptor(&readFds, name, O_RDONLY);
+    if (fd < 0)
+        return errnoError(name, errno);
+    // sysfs attributes are at most a page, reading from the start gets the current value
+    QByteArray data(MAX_WRITE_SIZE, Qt::Uninitialized);
+    ssize_t size = pread(fd, data.data(), data.size(), 0);
+    if (size < 0)
+        return errnoError(name, errno);
+    data.truncate(size);
+    return data;
+}
+
+Result<QString> DevicePrivate::readString(const QString &name)
+{
+    Result<QByteArray> data = read(name);
+    if (!data)
+        return data.error();
+    return QString::fromUtf8(data.value()).trimmed();
+}
+
+Result<int> DevicePrivate::readNumber(const QString &name)
+{
+    Result<QString> value = readString(name);
+    if (!value)
+        return value.error();
+    bool ok;
+    int number = value.value().toInt(&ok);
+    if (!ok)
+        return Error("Invalid " + name, QString("The %1 attribute doesn't contain a number.").arg(name));
+    return number;
+}
+
+Result<void> DevicePrivate::write(const QString &name, const QByteArray &data)
+{
+    int fd = fileDescriptor(&writeFds, name, O_WRONLY);
+    if (fd < 0)
+        return errnoError(name, errno);
+    ssize_t written = pwrite(fd, data.constData(), data.size(), 0);
+    if (written < 0)
+        return errnoError(name, errno);
+    if (written != data.size())
+        return Error("Sysfs error", QString("%1/%2: Only %3 of %4 bytes were written").arg(path, name).arg(written).arg(data.size()));
+    // Attributes take each write as a whole, the regular files of a fake tree
+    // would keep the end of a longer value written before
+    if (regularFiles.contains(name) && ftruncate(fd, written) < 0)
+        return errnoError(name, errno);
+    return Result<void>();
+}
+
+}
+
+}
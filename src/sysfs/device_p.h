@@ -0,0 +1,59 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SYSFS_DEVICE_P_H
+#define SYSFS_DEVICE_P_H
+
+#include "libopenrazer/device.h"
+#include "libopenrazer/led.h"
+
+#include <QHash>
+#include <QSet>
+
+namespace libopenrazer {
+
+namespace sysfs {
+
+class DevicePrivate
+{
+public:
+    ~DevicePrivate();
+
+    Device *mParent = nullptr;
+
+    QString path;
+    // Name of the kernel driver, e.g. razerkbd
+    QString driver;
+    QDBusObjectPath mObjectPath;
+
+    Features supportedFeatures;
+
+    QList<::libopenrazer::Led *> leds;
+
+    // Rows from defineCustomFrame() that haven't been written yet
+    QByteArray pendingFrame;
+
+    bool hasAttribute(const QString &name) const;
+    Result<QByteArray> read(const QString &name);
+    // The attribute without the trailing newline
+    Result<QString> readString(const QString &name);
+    Result<int> readNumber(const QString &name);
+    Result<void> write(const QString &name, const QByteArray &data);
+
+private:
+    Error errnoError(const QString &name, int error) const;
+    // The attribute files are opened on first use and kept open, -1 on failure with errno set
+    int fileDescriptor(QHash<QString, int> *fds, const QString &name, int flags);
+
+    QHash<QString, int> readFds;
+    QHash<QString, int> writeFds;
+    // Attributes that are regular files instead of sysfs attributes, e.g. in a fake tree for tests
+    QSet<QString> regularFiles;
+};
+
+}
+
+}
+
+#endif // SYSFS_DEVICE_P_H
@@ -0,0 +1,229 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "device_p.h"
+#include "led_p.h"
+#include "libopenrazer.h"
+#include "libopenrazer_private.h"
+
+namespace libopenrazer {
+
+namespace sysfs {
+
+static QByteArray rgbData(std::initializer_list<::openrazer::RGB> colors)
+{
+    QByteArray data;
+    for (const ::openrazer::RGB &color : colors) {
+        data.append(char(color.r));
+        data.append(char(color.g));
+        data.append(char(color.b));
+    }
+    return data;
+}
+
+Led::Led(Device *device, ::openrazer::LedId ledId, const QString &effectPrefix, const QString &brightnessAttribute, const QDBusObjectPath &objectPath)
+{
+    d = new LedPrivate();
+    d->mParent = this;
+    d->device = device;
+    d->mObjectPath = objectPath;
+    d->ledId = ledId;
+    d->effectPrefix = effectPrefix;
+    d->brightnessAttribute = brightnessAttribute;
+}
+
+Led::~Led()
+{
+    delete d;
+}
+
+QDBusObjectPath Led::getObjectPath()
+{
+    return d->mObjectPath;
+}
+
+bool Led::hasBrightness()
+{
+    return d->device->d->hasAttribute(d->brightnessAttribute);
+}
+
+bool Led::hasFx(::openrazer::Effect fx)
+{
+    QString attribute = d->effectAttribute(fx);
+    return !attribute.isEmpty() && d->device->d->hasAttribute(attribute);
+}
+
+Result<::openrazer::Effect> Led::tryGetCurrentEffect()
+{
+    if (!d->currentEffect)
+        return notSupportedError("The kernel driver doesn't report the current effect.");
+    return *d->currentEffect;
+}
+
+Result<QVector<::openrazer::RGB>> Led::tryGetCurrentColors()
+{
+    if (!d->currentEffect)
+        return notSupportedError("The kernel driver doesn't report the current colors.");
+    return d->currentColors;
+}
+
+Result<::openrazer::WaveDirection> Led::tryGetWaveDirection()
+{
+    return d->waveDirection;
+}
+
+Result<::openrazer::LedId> Led::tryGetLedId()
+{
+    return d->ledId;
+}
+
+Result<void> Led::trySetOff()
+{
+    return d->setEffect(::openrazer::Effect::Off, QByteArray(1, '1'));
+}
+
+Result<void> Led::trySetOn()
+{
+    return d->setEffect(::openrazer::Effect::On, QByteArray(1, '1'));
+}
+
+Result<void> Led::trySetStatic(::openrazer::RGB color)
+{
+    return d->setEffect(::openrazer::Effect::Static, rgbData({ color }), { color });
+}
+
+Result<void> Led::trySetBreathing(::openrazer::RGB color)
+{
+    return d->setEffect(::openrazer::Effect::Breathing, rgbData({ color }), { color });
+}
+
+Result<void> Led::trySetBreathingDual(::openrazer::RGB color, ::openrazer::RGB color2)
+{
+    return d->setEffect(::openrazer::Effect::BreathingDual, rgbData({ color, color2 }), { color, color2 });
+}
+
+Result<void> Led::trySetBreathingRandom()
+{
+    // A single byte that isn't a color starts random breathing
+    return d->setEffect(::openrazer::Effect::BreathingRandom, QByteArray(1, '1'));
+}
+
+Result<void> Led::trySetBreathingMono()
+{
+    return notSupportedError("The effect is not supported by this Led.");
+}
+
+Result<void> Led::trySetBlinking(::openrazer::RGB color)
+{
+    return d->setEffect(::openrazer::Effect::Blinking, rgbData({ color }), { color });
+}
+
+Result<void> Led::trySetSpectrum()
+{
+    return d->setEffect(::openrazer::Effect::Spectrum, QByteArray(1, '1'));
+}
+
+Result<void> Led::trySetWave(::openrazer::WaveDirection direction)
+{
+    Result<void> result = d->setEffect(::openrazer::Effect::Wave, QByteArray::number(static_cast<int>(direction)));
+    if (result)
+        d->waveDirection = direction;
+    return result;
+}
+
+Result<void> Led::trySetWheel(::openrazer::WheelDirection direction)
+{
+    return d->setEffect(::openrazer::Effect::Wheel, QByteArray::number(static_cast<int>(direction)));
+}
+
+Result<void> Led::trySetReactive(::openrazer::RGB color, ::openrazer::ReactiveSpeed speed)
+{
+    return d->setEffect(::openrazer::Effect::Reactive, QByteArray(1, char(speed)) + rgbData({ color }), { color });
+}
+
+Result<void> Led::trySetRipple(::openrazer::RGB color)
+{
+    // Ripple is drawn by the daemon with custom frames
+    return notSupportedError("The effect is not supported by this Led.");
+}
+
+Result<void> Led::trySetRippleRandom()
+{
+    return notSupportedError("The effect is not supported by this Led.");
+}
+
+Result<void> Led::trySetBrightness(uchar brightness)
+{
+    return d->device->d->write(d->brightnessAttribute, QByteArray::number(brightness));
+}
+
+Result<uchar> Led::tryGetBrightness()
+{
+    Result<int> brightness = d->device->d->readNumber(d->brightnessAttribute);
+    if (!brightness)
+        return brightness.error();
+    return static_cast<uchar>(brightness.value());
+}
+
+QString LedPrivate::effectAttribute(::openrazer::Effect effect) const
+{
+    const char *suffix = nullptr;
+    switch (effect) {
+    case ::openrazer::Effect::Off:
+        suffix = "none";
+        break;
+    case ::openrazer::Effect::On:
+        suffix = "on";
+        break;
+    case ::openrazer::Effect::Static:
+        suffix = "static";
+        break;
+    case ::openrazer::Effect::Breathing:
+    case ::openrazer::Effect::BreathingDual:
+    case ::openrazer::Effect::BreathingRandom:
+        // The number of bytes written selects the variant
+        suffix = "breath";
+        break;
+    case ::openrazer::Effect::Blinking:
+        suffix = "blinking";
+        break;
+    case ::openrazer::Effect::Spectrum:
+        suffix = "spectrum";
+        break;
+    case ::openrazer::Effect::Wave:
+        suffix = "wave";
+        break;
+    case ::openrazer::Effect::Wheel:
+        suffix = "wheel";
+        break;
+    case ::openrazer::Effect::Reactive:
+        suffix = "reactive";
+        break;
+    case ::openrazer::Effect::BreathingMono:
+    case ::openrazer::Effect::Ripple:
+    case ::openrazer::Effect::RippleRandom:
+        break;
+    }
+    if (suffix == nullptr)
+        return QString();
+    return effectPrefix + QLatin1String(suffix);
+}
+
+Result<void> LedPrivate::setEffect(::openrazer::Effect effect, const QByteArray &data, const QVector<::openrazer::RGB> &colors)
+{
+    QString attribute = effectAttribute(effect);
+    if (attribute.isEmpty())
+        return notSupportedError("The effect is not supported by this Led.");
+
+    Result<void> result = device->d->write(attribute, data);
+    if (result) {
+        currentEffect = effect;
+        currentColors = colors;
+    }
+    return result;
+}
+
+}
+
+}
@@ -0,0 +1,42 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SYSFS_LED_P_H
+#define SYSFS_LED_P_H
+
+#include "libopenrazer/led.h"
+
+#include <optional>
+
+namespace libopenrazer {
+
+namespace sysfs {
+
+class LedPrivate
+{
+public:
+    Led *mParent = nullptr;
+
+    Device *device;
+    QDBusObjectPath mObjectPath;
+    ::openrazer::LedId ledId;
+    // e.g. logo_matrix_effect_, completed with the name of the effect
+    QString effectPrefix;
+    QString brightnessAttribute;
+
+    // The driver doesn't report these, they are what was set last
+    std::optional<::openrazer::Effect> currentEffect;
+    QVector<::openrazer::RGB> currentColors;
+    ::openrazer::WaveDirection waveDirection = ::openrazer::WaveDirection::LEFT_TO_RIGHT;
+
+    // Empty if the driver has no attribute for the effect
+    QString effectAttribute(::openrazer::Effect effect) const;
+    Result<void> setEffect(::openrazer::Effect effect, const QByteArray &data, const QVector<::openrazer::RGB> &colors = {});
+};
+
+}
+
+}
+
+#endif // SYSFS_LED_P_H
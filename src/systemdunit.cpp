@@ -0,0 +1,225 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "systemdunit_p.h"
+#include "logging_p.h"
+
+#include <QDBusError>
+#include <QDBusObjectPath>
+#include <QDBusPendingCallWatcher>
+#include <QDBusReply>
+#include <QDBusServiceWatcher>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QPointer>
+
+namespace libopenrazer {
+
+static const char *SYSTEMD_PATH = "/org/freedesktop/systemd1";
+static const char *SYSTEMD_MANAGER_INTERFACE = "org.freedesktop.systemd1.Manager";
+
+SystemdUnit::SystemdUnit(const QString &unit, const QString &executable, const QDBusConnection &connection, QObject *parent)
+    : QObject(parent), unit(unit), executable(executable), connection(connection)
+{
+    service = qEnvironmentVariable("LIBOPENRAZER_SYSTEMD_SERVICE", "org.freedesktop.systemd1");
+}
+
+DaemonStatus SystemdUnit::status()
+{
+    subscribe();
+    if (cachedStatus)
+        return *cachedStatus;
+    return store(statusFromReply(connection.call(getUnitFileStateMessage(), QDBus::Block, SYSTEMD_TIMEOUT)));
+}
+
+void SystemdUnit::statusAsync(QObject *context, const std::function<void(DaemonStatus status)> &callback)
+{
+    subscribe();
+    if (cachedStatus) {
+        DaemonStatus status = *cachedStatus;
+        QMetaObject::invokeMethod(context, [callback, status]() { callback(status); }, Qt::QueuedConnection);
+        return;
+    }
+
+    // Parented to the context, so the callback is dropped together with it
+    auto *watcher = new QDBusPendingCallWatcher(connection.asyncCall(getUnitFileStateMessage(), SYSTEMD_TIMEOUT), context);
+    QPointer<SystemdUnit> self(this);
+    QObject::connect(watcher, &QDBusPendingCallWatcher::finished, context, [self, callback](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        if (self == nullptr)
+            return;
+        // An older query can finish after the cache was filled or invalidated, the newest answer wins
+        callback(self->store(self->statusFromReply(watcher->reply())));
+    });
+}
+
+QString SystemdUnit::statusOutput()
+{
+    if (status() == DaemonStatus::NoSystemd)
+        return QString("systemd is not available, %1 can't be checked.").arg(unit);
+
+    QDBusMessage loadUnit = createCall(SYSTEMD_PATH, SYSTEMD_MANAGER_INTERFACE, "LoadUnit");
+    loadUnit << unit;
+    QDBusReply<QDBusObjectPath> unitPath = connection.call(loadUnit, QDBus::Block, SYSTEMD_TIMEOUT);
+    if (!unitPath.isValid())
+        return QString("Failed to get the status of %1: %2").arg(unit, unitPath.error().message());
+
+    QDBusMessage getAll = createCall(unitPath.value().path(), "org.freedesktop.DBus.Properties", "GetAll");
+    getAll << QString("org.freedesktop.systemd1.Unit");
+    QDBusReply<QVariantMap> reply = connection.call(getAll, QDBus::Block, SYSTEMD_TIMEOUT);
+    if (!reply.isValid())
+        return QString("Failed to get the status of %1: %2").arg(unit, reply.error().message());
+    const QVariantMap properties = reply.value();
+
+    QString output = QString("● %1 - %2\n").arg(unit, properties.value("Description").toString());
+    output += QString("     Loaded: %1").arg(properties.value("LoadState").toString());
+    if (!properties.value("FragmentPath").toString().isEmpty())
+        output += QString(" (%1; %2)").arg(properties.value("FragmentPath").toString(), properties.value("UnitFileState").toString());
+    output += QString("\n     Active: %1 (%2)").arg(properties.value("ActiveState").toString(), properties.value("SubState").toString());
+    quint64 since = properties.value("ActiveEnterTimestamp").toULongLong();
+    if (since != 0)
+        output += " since " + QDateTime::fromMSecsSinceEpoch(since / 1000).toString("yyyy-MM-dd hh:mm:ss");
+    output += "\n";
+
+    QDBusMessage getMainPid = createCall(unitPath.value().path(), "org.freedesktop.DBus.Properties", "Get");
+    getMainPid << QString("org.freedesktop.systemd1.Service") << QString("MainPID");
+    QDBusReply<QVariant> mainPid = connection.call(getMainPid, QDBus::Block, SYSTEMD_TIMEOUT);
+    if (mainPid.isValid() && mainPid.value().toUInt() != 0)
+        output += QString("   Main PID: %1\n").arg(mainPid.value().toUInt());
+    return output;
+}
+
+bool SystemdUnit::enable()
+{
+    bool success = enableFromReply(connection.call(enableUnitFilesMessage(), QDBus::Block, m_enableTimeout));
+    if (success)
+        connection.call(reloadMessage(), QDBus::Block, m_enableTimeout);
+    return success;
+}
+
+void SystemdUnit::enableAsync(QObject *context, const std::function<void(bool success)> &callback)
+{
+    auto *watcher = new QDBusPendingCallWatcher(connection.asyncCall(enableUnitFilesMessage(), m_enableTimeout), context);
+    QPointer<SystemdUnit> self(this);
+    QObject::connect(watcher, &QDBusPendingCallWatcher::finished, context, [self, context, callback](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        if (self == nullptr)
+            return;
+        if (!self->enableFromReply(watcher->reply())) {
+            callback(false);
+            return;
+        }
+        auto *reloadWatcher = new QDBusPendingCallWatcher(self->connection.asyncCall(self->reloadMessage(), self->m_enableTimeout), context);
+        QObject::connect(reloadWatcher, &QDBusPendingCallWatcher::finished, context, [callback](QDBusPendingCallWatcher *watcher) {
+            watcher->deleteLater();
+            callback(true);
+        });
+    });
+}
+
+DaemonStatus SystemdUnit::store(DaemonStatus status)
+{
+    // Ask again next time if something went wrong
+    if (status != DaemonStatus::Unknown)
+        cachedStatus = status;
+    return status;
+}
+
+void SystemdUnit::invalidate()
+{
+    cachedStatus.reset();
+}
+
+QDBusMessage SystemdUnit::createCall(const QString &path, const QString &interface, const QString &method)
+{
+    return QDBusMessage::createMethodCall(service, path, interface, method);
+}
+
+QDBusMessage SystemdUnit::getUnitFileStateMessage()
+{
+    QDBusMessage message = createCall(SYSTEMD_PATH, SYSTEMD_MANAGER_INTERFACE, "GetUnitFileState");
+    message << unit;
+    return message;
+}
+
+QDBusMessage SystemdUnit::enableUnitFilesMessage()
+{
+    QDBusMessage message = createCall(SYSTEMD_PATH, SYSTEMD_MANAGER_INTERFACE, "EnableUnitFiles");
+    // files, runtime, force
+    message << QStringList { unit } << false << false;
+    message.setInteractiveAuthorizationAllowed(true);
+    return message;
+}
+
+QDBusMessage SystemdUnit::reloadMessage()
+{
+    // Like systemctl enable does, so the new symlinks take effect
+    QDBusMessage message = createCall(SYSTEMD_PATH, SYSTEMD_MANAGER_INTERFACE, "Reload");
+    message.setInteractiveAuthorizationAllowed(true);
+    return message;
+}
+
+DaemonStatus SystemdUnit::statusFromReply(const QDBusMessage &reply)
+{
+    if (reply.type() == QDBusMessage::ReplyMessage) {
+        QString state = reply.arguments().value(0).toString();
+        if (state == "enabled")
+            return DaemonStatus::Enabled;
+        else if (state == "disabled")
+            return DaemonStatus::Disabled;
+        qCWarning(lcManager, "libopenrazer: There was an error checking if the daemon is enabled. Unit state is: %s", qUtf8Printable(state));
+        return DaemonStatus::Unknown;
+    }
+
+    QDBusError error(reply);
+    switch (error.type()) {
+    case QDBusError::FileNotFound:
+        // Unit wasn't found (i.e. daemon is not installed - or only an old version)
+        return DaemonStatus::NotInstalled;
+    case QDBusError::ServiceUnknown:
+    case QDBusError::NameHasNoOwner:
+    case QDBusError::Disconnected:
+    case QDBusError::NoServer: {
+        // No systemd on the bus - fails on non-systemd distros and flatpak
+        QFileInfo daemonFile(executable);
+        // if the daemon executable does not exist, show the not_installed message - probably flatpak
+        if (!daemonFile.exists())
+            return DaemonStatus::NotInstalled;
+        // otherwise show the NoSystemd message - probably a non-systemd distro
+        return DaemonStatus::NoSystemd;
+    }
+    default:
+        if (error.name() == "org.freedesktop.systemd1.NoSuchUnit")
+            return DaemonStatus::NotInstalled;
+        qCWarning(lcManager, "libopenrazer: There was an error checking if the daemon is enabled. Error message: %s: %s", qUtf8Printable(error.name()), qUtf8Printable(error.message()));
+        return DaemonStatus::Unknown;
+    }
+}
+
+bool SystemdUnit::enableFromReply(const QDBusMessage &reply)
+{
+    if (reply.type() == QDBusMessage::ErrorMessage) {
+        qCWarning(lcManager, "libopenrazer: Failed to enable %s: %s", qUtf8Printable(unit), qUtf8Printable(QDBusError(reply).message()));
+        return false;
+    }
+    invalidate();
+    return true;
+}
+
+// The cache is only valid while we're told about changes
+void SystemdUnit::subscribe()
+{
+    if (subscribed || !connection.isConnected())
+        return;
+    subscribed = true;
+
+    connection.connect(service, SYSTEMD_PATH, SYSTEMD_MANAGER_INTERFACE, "UnitFilesChanged", this, SLOT(invalidate()));
+    connection.connect(service, SYSTEMD_PATH, SYSTEMD_MANAGER_INTERFACE, "Reloading", this, SLOT(invalidate()));
+    auto *watcher = new QDBusServiceWatcher(service, connection, QDBusServiceWatcher::WatchForOwnerChange, this);
+    connect(watcher, &QDBusServiceWatcher::serviceOwnerChanged, this, &SystemdUnit::invalidate);
+    // systemd only emits signals once a client subscribed, the reply isn't interesting
+    connection.send(createCall(SYSTEMD_PATH, SYSTEMD_MANAGER_INTERFACE, "Subscribe"));
+}
+
+}
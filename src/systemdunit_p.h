@@ -0,0 +1,77 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SYSTEMDUNIT_P_H
+#define SYSTEMDUNIT_P_H
+
+#include "libopenrazer/misc.h"
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QObject>
+
+#include <climits>
+#include <functional>
+#include <optional>
+
+namespace libopenrazer {
+
+/*
+ * The systemd unit of a daemon, queried through the D-Bus API of systemd
+ * instead of running systemctl.
+ *
+ * The status is cached until systemd reports that unit files changed or it
+ * got reloaded. Systems without systemd on \a connection fall back to
+ * checking if \a executable exists.
+ *
+ * The LIBOPENRAZER_SYSTEMD_SERVICE environment variable replaces the
+ * org.freedesktop.systemd1 service name, so a stand-in service can be used.
+ */
+class SystemdUnit : public QObject
+{
+    Q_OBJECT
+public:
+    SystemdUnit(const QString &unit, const QString &executable, const QDBusConnection &connection, QObject *parent);
+
+    DaemonStatus status();
+    void statusAsync(QObject *context, const std::function<void(DaemonStatus status)> &callback);
+    // A summary of the unit in the style of systemctl status
+    QString statusOutput();
+    bool enable();
+    void enableAsync(QObject *context, const std::function<void(bool success)> &callback);
+
+    // The timeout of the calls of enable() and enableAsync(), ENABLE_TIMEOUT by default
+    int enableTimeout() const { return m_enableTimeout; }
+    void setEnableTimeout(int timeout) { m_enableTimeout = timeout; }
+
+private Q_SLOTS:
+    void invalidate();
+
+private:
+    QDBusMessage createCall(const QString &path, const QString &interface, const QString &method);
+    QDBusMessage getUnitFileStateMessage();
+    QDBusMessage enableUnitFilesMessage();
+    QDBusMessage reloadMessage();
+    DaemonStatus statusFromReply(const QDBusMessage &reply);
+    bool enableFromReply(const QDBusMessage &reply);
+    DaemonStatus store(DaemonStatus status);
+    void subscribe();
+
+    // Calls to systemd are answered right away, don't block for the D-Bus default of 25 seconds
+    static constexpr int SYSTEMD_TIMEOUT = 5000;
+    // Enabling might wait for the user to authorize it first, INT_MAX is no timeout for QtDBus
+    static constexpr int ENABLE_TIMEOUT = INT_MAX;
+
+    QString unit;
+    QString executable;
+    QString service;
+    QDBusConnection connection;
+    int m_enableTimeout = ENABLE_TIMEOUT;
+    bool subscribed = false;
+    std::optional<DaemonStatus> cachedStatus;
+};
+
+}
+
+#endif // SYSTEMDUNIT_P_H
@@ -0,0 +1,130 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "transport_p.h"
+#include "libopenrazer_private.h"
+
+#ifdef LIBOPENRAZER_SDBUS
+#include "sdbustransport_p.h"
+#endif
+
+#include <QDBusArgument>
+#include <QDBusError>
+
+namespace libopenrazer {
+
+namespace {
+class QtDBusCall : public TransportCall
+{
+public:
+    QtDBusCall(PeerConnection *peer, const QDBusConnection &bus, const QDBusMessage &message)
+        : peer(peer), bus(bus), message(message)
+    {
+    }
+
+    void appendBool(bool value) override
+    {
+        message << QVariant::fromValue(value);
+    }
+
+    void appendByte(uchar value) override
+    {
+        message << QVariant::fromValue(value);
+    }
+
+    void appendUInt16(quint16 value) override
+    {
+        message << QVariant::fromValue(value);
+    }
+
+    void appendInt32(qint32 value) override
+    {
+        message << QVariant::fromValue(value);
+    }
+
+    void appendUInt32(quint32 value) override
+    {
+        message << QVariant::fromValue(value);
+    }
+
+    void appendDouble(double value) override
+    {
+        message << QVariant::fromValue(value);
+    }
+
+    void appendBytes(const QByteArray &value) override
+    {
+        message << QVariant::fromValue(value);
+    }
+
+    void appendColor(const ::openrazer::RGB &color) override
+    {
+        message << QVariant::fromValue(color);
+    }
+
+    void appendColors(const QVector<::openrazer::RGB> &colors) override
+    {
+        message << QVariant::fromValue(colors);
+    }
+
+    void appendDPI(const ::openrazer::DPI &dpi) override
+    {
+        message << QVariant::fromValue(dpi);
+    }
+
+    void appendDPIs(const QVector<::openrazer::DPI> &dpis) override
+    {
+        message << QVariant::fromValue(dpis);
+    }
+
+    void appendEnum(int value) override
+    {
+        QDBusArgument argument;
+        argument.beginStructure();
+        argument << value;
+        argument.endStructure();
+        message << QVariant::fromValue(argument);
+    }
+
+    Result<void> send(int timeout) override
+    {
+        DBusCommand command;
+        command.message = message;
+        if (peer != nullptr)
+            return commandResult(command, peer->call(message, timeout));
+        return commandResult(command, sendDBusMessage(CircuitBreaker::forService(message.service(), bus), bus, message, timeout));
+    }
+
+private:
+    PeerConnection *peer;
+    QDBusConnection bus;
+    QDBusMessage message;
+};
+}
+
+Transport::Transport(const QString &service, const QString &path, const QDBusConnection &bus, PeerConnection *peer)
+    : service(service), path(path), bus(bus), peer(peer)
+#ifdef LIBOPENRAZER_SDBUS
+    , serviceName(service.toUtf8()), objectPath(path.toUtf8())
+#endif
+{
+}
+
+std::unique_ptr<TransportCall> Transport::createCall(const char *interface, const char *method)
+{
+#ifdef LIBOPENRAZER_SDBUS
+    // Skipping the bus daemon saves more than the cheaper marshalling
+    if (peer == nullptr || !peer->isPeerToPeer()) {
+        if (SdBusConnection *sdBus = SdBusConnection::forConnection(bus)) {
+            std::unique_ptr<TransportCall> call = sdBus->createCall(serviceName, objectPath, interface, method,
+                                                                    CircuitBreaker::forService(service, bus));
+            if (call)
+                return call;
+        }
+    }
+#endif
+    return std::make_unique<QtDBusCall>(peer, bus, QDBusMessage::createMethodCall(service, path, QLatin1String(interface), QLatin1String(method)));
+}
+
+}
@@ -0,0 +1,100 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef TRANSPORT_P_H
+#define TRANSPORT_P_H
+
+#include "libopenrazer/openrazer.h"
+#include "libopenrazer/result.h"
+
+#include "config.h"
+#include "peerconnection_p.h"
+
+#include <memory>
+
+namespace libopenrazer {
+
+/*
+ * A method call sent through a Transport.
+ *
+ * The arguments are appended with their D-Bus type, so an implementation can
+ * write them into the message directly without boxing them into QVariants
+ * first.
+ */
+class TransportCall
+{
+public:
+    virtual ~TransportCall() = default;
+
+    // b
+    virtual void appendBool(bool value) = 0;
+    // y
+    virtual void appendByte(uchar value) = 0;
+    // q
+    virtual void appendUInt16(quint16 value) = 0;
+    // i
+    virtual void appendInt32(qint32 value) = 0;
+    // u
+    virtual void appendUInt32(quint32 value) = 0;
+    // d
+    virtual void appendDouble(double value) = 0;
+    // ay
+    virtual void appendBytes(const QByteArray &value) = 0;
+    // (yyy)
+    virtual void appendColor(const ::openrazer::RGB &color) = 0;
+    // a(yyy)
+    virtual void appendColors(const QVector<::openrazer::RGB> &colors) = 0;
+    // (qq)
+    virtual void appendDPI(const ::openrazer::DPI &dpi) = 0;
+    // a(qq)
+    virtual void appendDPIs(const QVector<::openrazer::DPI> &dpis) = 0;
+    // (i), how the enums in openrazer.h are marshalled
+    virtual void appendEnum(int value) = 0;
+
+    /*
+     * Sends the call and waits for the reply, like sendDBusMessage(). A
+     * single false return value counts as failure like in toVoidResult().
+     */
+    virtual Result<void> send(int timeout = -1) = 0;
+};
+
+/*
+ * Transport for the calls of a device that are sent often, i.e. the custom
+ * frames and the setters of Device, Led and Manager.
+ *
+ * By default the calls are QtDBus messages, sent through the PeerConnection
+ * of the daemon if there is one and over the bus otherwise. When
+ * libopenrazer is built with the sd-bus transport (the "transport" meson
+ * option), calls to a daemon on the session or system bus are written into
+ * sd-bus messages instead and sent over a connection of their own, unless
+ * they go over a peer-to-peer connection. Everything else, like
+ * introspection, getters, properties and signals, stays on QtDBus.
+ */
+class Transport
+{
+public:
+    /*
+     * Without a \a peer connection, e.g. for control calls, calls always go
+     * over \a bus.
+     */
+    Transport(const QString &service, const QString &path, const QDBusConnection &bus, PeerConnection *peer = nullptr);
+
+    std::unique_ptr<TransportCall> createCall(const char *interface, const char *method);
+
+private:
+    QString service;
+    QString path;
+    QDBusConnection bus;
+    PeerConnection *peer;
+
+#ifdef LIBOPENRAZER_SDBUS
+    // The names as passed to sd-bus, converted once
+    QByteArray serviceName;
+    QByteArray objectPath;
+#endif
+};
+
+}
+
+#endif // TRANSPORT_P_H
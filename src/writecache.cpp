@@ -0,0 +1,70 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "writecache_p.h"
+
+namespace libopenrazer {
+
+bool WriteCache::isEnabled() const
+{
+    return enabled.loadRelaxed() != 0;
+}
+
+void WriteCache::setEnabled(bool enabled)
+{
+    this->enabled.storeRelaxed(enabled ? 1 : 0);
+    if (!enabled)
+        clear();
+}
+
+bool WriteCache::isRedundant(int generation, Slot slot, const QVariant &value)
+{
+    QMutexLocker locker(&mutex);
+    if (generation != this->generation || !values[slot].isValid() || values[slot] != value)
+        return false;
+    elided++;
+    return true;
+}
+
+void WriteCache::store(int generation, Slot slot, const QVariant &value)
+{
+    QMutexLocker locker(&mutex);
+    if (generation != this->generation) {
+        for (QVariant &v : values)
+            v.clear();
+        this->generation = generation;
+    }
+    values[slot] = value;
+}
+
+void WriteCache::invalidate(Slot slot)
+{
+    QMutexLocker locker(&mutex);
+    values[slot].clear();
+}
+
+void WriteCache::observe(Slot slot, const QVariant &value)
+{
+    QMutexLocker locker(&mutex);
+    if (!values[slot].isValid())
+        return;
+    QVariant cached = slot == Effect ? values[slot].toList().value(0) : values[slot];
+    if (cached != value)
+        values[slot].clear();
+}
+
+void WriteCache::clear()
+{
+    QMutexLocker locker(&mutex);
+    for (QVariant &v : values)
+        v.clear();
+}
+
+quint64 WriteCache::elidedWrites() const
+{
+    QMutexLocker locker(&mutex);
+    return elided;
+}
+
+}
@@ -0,0 +1,107 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef WRITECACHE_P_H
+#define WRITECACHE_P_H
+
+#include "libopenrazer/openrazer.h"
+#include "libopenrazer/result.h"
+
+#include "dbusinterface_p.h"
+
+#include <QMutex>
+#include <QVariant>
+
+namespace libopenrazer {
+
+/*
+ * Remembers the values that were last set successfully on a Device or Led,
+ * so setting the same value again can be skipped. See
+ * Device::setWriteCacheEnabled().
+ *
+ * The values are only valid for the daemon instance identified by the owner
+ * generation of its circuit breaker, all of them are dropped when that
+ * changes.
+ */
+class WriteCache
+{
+public:
+    enum Slot {
+        PollRate,
+        IdleTime,
+        LowBatteryThreshold,
+        Brightness,
+        // A list of the ::openrazer::Effect as int followed by its arguments
+        Effect,
+        SlotCount,
+    };
+
+    bool isEnabled() const;
+    void setEnabled(bool enabled);
+
+    /*
+     * Returns if \a value is what was last set in \a slot, and counts the
+     * write as elided if it is.
+     */
+    bool isRedundant(int generation, Slot slot, const QVariant &value);
+    void store(int generation, Slot slot, const QVariant &value);
+    void invalidate(Slot slot);
+
+    /*
+     * Drops the value in \a slot if it disagrees with \a value read from the
+     * device. For the Effect slot only the effect is compared.
+     */
+    void observe(Slot slot, const QVariant &value);
+
+    void clear();
+    quint64 elidedWrites() const;
+
+private:
+    QAtomicInt enabled;
+    mutable QMutex mutex;
+    int generation = -1;
+    QVariant values[SlotCount];
+    quint64 elided = 0;
+};
+
+/*
+ * Runs \a write unless \a value is what was last set in \a slot of \a cache,
+ * and remembers \a value if it succeeded. \a iface is the interface the
+ * write goes to, its circuit breaker tells if the daemon was restarted.
+ */
+template<typename Write>
+Result<void> cachedWrite(WriteCache *cache, DBusInterface *iface, WriteCache::Slot slot, const QVariant &value, Write write)
+{
+    if (cache == nullptr || !cache->isEnabled())
+        return write();
+
+    // Read before the call, so a restart during the call drops the value again
+    int generation = iface->circuitBreaker()->ownerGeneration();
+    if (cache->isRedundant(generation, slot, value))
+        return Result<void>();
+
+    Result<void> result = write();
+    if (result)
+        cache->store(generation, slot, value);
+    else
+        cache->invalidate(slot);
+    return result;
+}
+
+template<typename T>
+void observeRead(WriteCache *cache, WriteCache::Slot slot, const Result<T> &result)
+{
+    if (cache != nullptr && result)
+        cache->observe(slot, QVariant::fromValue(result.value()));
+}
+
+inline void observeRead(WriteCache *cache, const Result<::openrazer::Effect> &result)
+{
+    if (cache != nullptr && result)
+        cache->observe(WriteCache::Effect, static_cast<int>(result.value()));
+}
+
+}
+
+#endif // WRITECACHE_P_H
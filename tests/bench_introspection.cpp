@@ -0,0 +1,161 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "openrazer/device_p.h"
+
+#include <QDomDocument>
+#include <QTest>
+
+using namespace libopenrazer;
+
+/*
+ * Compares DevicePrivate::parseIntrospection() with the QDomDocument based
+ * parser it replaced, on introspection data shaped like the one of a keyboard.
+ */
+class BenchIntrospection : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void domParser();
+    void streamParser();
+    void domLookups();
+    void streamLookups();
+
+private:
+    QString xml;
+};
+
+struct Query {
+    QString interface;
+    QString method;
+};
+
+// What setupCapabilities() of the device and of a Chroma Led ask for
+static const QList<Query> QUERIES = {
+    { "razer.device.misc", "getKeyboardLayout" },
+    { "razer.device.dpi", "setDPI" },
+    { "razer.device.dpi", "availableDPI" },
+    { "razer.device.dpi", "setDPIStages" },
+    { "razer.device.misc", "setPollRate" },
+    { "razer.device.lighting.chroma", "setCustom" },
+    { "razer.device.power", "getBattery" },
+    { "razer.device.power", "getLowBatteryThreshold" },
+    { "razer.device.lighting.chroma", "setNone" },
+    { "razer.device.lighting.chroma", "setStatic" },
+    { "razer.device.lighting.chroma", "setBlinking" },
+    { "razer.device.lighting.chroma", "setBreathSingle" },
+    { "razer.device.lighting.chroma", "setBreathDual" },
+    { "razer.device.lighting.chroma", "setBreathRandom" },
+    { "razer.device.lighting.chroma", "setSpectrum" },
+    { "razer.device.lighting.chroma", "setWave" },
+    { "razer.device.lighting.chroma", "setWheel" },
+    { "razer.device.lighting.chroma", "setReactive" },
+    { "razer.device.lighting.bw2013", "setStatic" },
+    { "razer.device.lighting.custom", "setRipple" },
+    { "razer.device.lighting.brightness", "setBrightness" },
+};
+
+// The parser before the capability index, flattened into "interface;method" strings
+static QStringList parseWithDom(const QString &xml)
+{
+    QStringList intr;
+
+    QDomDocument doc;
+    doc.setContent(xml);
+
+    QDomNodeList nodes = doc.documentElement().childNodes();
+    for (int i = 0; i < nodes.count(); i++) {
+        QDomElement element = nodes.at(i).toElement();
+        QString interfacename = element.attributeNode("name").value();
+
+        QDomNodeList methodnodes = element.childNodes();
+        for (int ii = 0; ii < methodnodes.count(); ii++) {
+            QDomElement methodelement = methodnodes.at(ii).toElement();
+            intr.append(interfacename + ";" + methodelement.attributeNode("name").value());
+        }
+        intr.append(interfacename);
+    }
+    return intr;
+}
+
+void BenchIntrospection::initTestCase()
+{
+    const QList<QPair<QString, QStringList>> interfaces = {
+        { "org.freedesktop.DBus.Introspectable", { "Introspect" } },
+        { "org.freedesktop.DBus.Properties", { "Get", "GetAll", "Set" } },
+        { "org.freedesktop.DBus.Peer", { "Ping", "GetMachineId" } },
+        { "razer.device.misc", { "getSerial", "getDeviceName", "getDeviceType", "getFirmware", "getVidPid", "getDeviceMode", "setDeviceMode", "getKeyboardLayout", "getPollRate", "setPollRate", "getRazerUrls", "getMatrixDimensions", "hasMatrix", "getDriverVersion", "suspendDevice", "resumeDevice" } },
+        { "razer.device.lighting.chroma", { "getEffect", "getEffectColors", "getEffectSpeed", "getWaveDir", "setNone", "setStatic", "setBlinking", "setBreathSingle", "setBreathDual", "setBreathRandom", "setSpectrum", "setWave", "setWheel", "setReactive", "setKeyRow", "setCustom", "setStarlightRandom", "setStarlightSingle", "setStarlightDual" } },
+        { "razer.device.lighting.brightness", { "getBrightness", "setBrightness" } },
+        { "razer.device.lighting.custom", { "setRipple", "setRippleRandomColour" } },
+        { "razer.device.macro", { "getMacros", "deleteMacro", "addMacro", "getModeModifier", "setModeModifier" } },
+        { "razer.device.led.gamemode", { "getGameMode", "setGameMode" } },
+        { "razer.device.led.macromode", { "getMacroMode", "setMacroMode", "getMacroEffect", "setMacroEffect" } },
+    };
+
+    xml = "<!DOCTYPE node PUBLIC \"-//freedesktop//DTD D-BUS Object Introspection 1.0//EN\"\n"
+          "\"http://www.freedesktop.org/standards/dbus/1.0/introspect.dtd\">\n"
+          "<node name=\"/org/razer/device/XX0000000000001\">\n";
+    for (const auto &[interface, methods] : interfaces) {
+        xml += QString("  <interface name=\"%1\">\n").arg(interface);
+        for (const QString &method : methods) {
+            xml += QString("    <method name=\"%1\">\n").arg(method);
+            xml += "      <arg direction=\"in\" type=\"y\" name=\"value\"/>\n";
+            xml += "      <arg direction=\"out\" type=\"b\"/>\n";
+            xml += "    </method>\n";
+        }
+        xml += "  </interface>\n";
+    }
+    xml += "</node>\n";
+
+    // Both have to find the same capabilities
+    QStringList dom = parseWithDom(xml);
+    openrazer::CapabilityIndex index = openrazer::DevicePrivate::parseIntrospection(xml);
+    for (const Query &query : QUERIES)
+        QCOMPARE(index.value(query.interface).contains(query.method), dom.contains(query.interface + ";" + query.method));
+}
+
+void BenchIntrospection::domParser()
+{
+    QBENCHMARK {
+        QStringList result = parseWithDom(xml);
+        Q_UNUSED(result);
+    }
+}
+
+void BenchIntrospection::streamParser()
+{
+    QBENCHMARK {
+        openrazer::CapabilityIndex result = openrazer::DevicePrivate::parseIntrospection(xml);
+        Q_UNUSED(result);
+    }
+}
+
+void BenchIntrospection::domLookups()
+{
+    QStringList introspection = parseWithDom(xml);
+    int found = 0;
+    QBENCHMARK {
+        for (const Query &query : QUERIES)
+            found += introspection.contains(query.interface + ";" + query.method);
+    }
+    QVERIFY(found > 0);
+}
+
+void BenchIntrospection::streamLookups()
+{
+    openrazer::CapabilityIndex introspection = openrazer::DevicePrivate::parseIntrospection(xml);
+    int found = 0;
+    QBENCHMARK {
+        for (const Query &query : QUERIES) {
+            openrazer::CapabilityIndex::const_iterator it = introspection.constFind(query.interface);
+            found += it != introspection.constEnd() && it->contains(query.method);
+        }
+    }
+    QVERIFY(found > 0);
+}
+
+QTEST_GUILESS_MAIN(BenchIntrospection)
+#include "bench_introspection.moc"
@@ -0,0 +1,77 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "mockdaemon.h"
+
+#include "dbusinterface_p.h"
+#include "peerconnection_p.h"
+
+#include <QTest>
+
+#include <memory>
+
+using namespace libopenrazer;
+
+/*
+ * Compares the latency of a custom frame row sent over the bus with one sent
+ * over the peer-to-peer connection the mock daemon offers.
+ */
+class BenchPeerConnection : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void bus();
+    void peerToPeer();
+
+private:
+    std::unique_ptr<MockDaemon> daemon;
+};
+
+static QDBusMessage keyRowMessage()
+{
+    QDBusMessage message = QDBusMessage::createMethodCall("org.razer", MockDaemon::devicePath().path(),
+                                                          "razer.device.lighting.chroma", "setKeyRow");
+    message << (QByteArray(3, '\0') + QByteArray(22 * 3, '\x7f'));
+    return message;
+}
+
+void BenchPeerConnection::initTestCase()
+{
+    MOCKDAEMON_INIT_TEST_CASE();
+
+    MockDaemon::Options options;
+    options.peerAddress = true;
+    daemon = MockDaemon::start(options);
+}
+
+void BenchPeerConnection::cleanupTestCase()
+{
+    daemon.reset();
+}
+
+void BenchPeerConnection::bus()
+{
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    CircuitBreaker *breaker = CircuitBreaker::forService("org.razer", bus);
+    QDBusMessage message = keyRowMessage();
+    QBENCHMARK {
+        QCOMPARE(sendDBusMessage(breaker, bus, message).type(), QDBusMessage::ReplyMessage);
+    }
+}
+
+void BenchPeerConnection::peerToPeer()
+{
+    PeerConnection *peer = PeerConnection::forService("org.razer", QDBusConnection::sessionBus(), "/org/razer", "razer.daemon");
+    QVERIFY(peer->isPeerToPeer());
+    QDBusMessage message = keyRowMessage();
+    QBENCHMARK {
+        QCOMPARE(peer->call(message).type(), QDBusMessage::ReplyMessage);
+    }
+    QVERIFY(daemon->peerCalls() > 0);
+}
+
+QTEST_GUILESS_MAIN(BenchPeerConnection)
+#include "bench_peerconnection.moc"
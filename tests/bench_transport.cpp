@@ -0,0 +1,84 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "mockdaemon.h"
+
+#include "dbusinterface_p.h"
+#include "transport_p.h"
+
+#include <QTest>
+
+#include <memory>
+
+using namespace libopenrazer;
+
+/*
+ * Compares sending a custom frame row through Transport, which uses sd-bus
+ * when built with -Dtransport=sdbus, with a plain QtDBus message.
+ */
+class BenchTransport : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void qtDBusMessage();
+    void transportCall();
+    void transportSetter();
+
+private:
+    std::unique_ptr<MockDaemon> daemon;
+};
+
+static const QByteArray ROW = QByteArray(3, '\0') + QByteArray(22 * 3, '\x7f');
+
+void BenchTransport::initTestCase()
+{
+    MOCKDAEMON_INIT_TEST_CASE();
+    MockDaemon::Options options;
+    options.brightness = true;
+    daemon = MockDaemon::start(options);
+}
+
+void BenchTransport::cleanupTestCase()
+{
+    daemon.reset();
+}
+
+void BenchTransport::qtDBusMessage()
+{
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    CircuitBreaker *breaker = CircuitBreaker::forService("org.razer", bus);
+    QBENCHMARK {
+        QDBusMessage message = QDBusMessage::createMethodCall("org.razer", MockDaemon::devicePath().path(),
+                                                              "razer.device.lighting.chroma", "setKeyRow");
+        message << ROW;
+        QDBusMessage reply = sendDBusMessage(breaker, bus, message);
+        QCOMPARE(reply.type(), QDBusMessage::ReplyMessage);
+    }
+}
+
+void BenchTransport::transportCall()
+{
+    Transport transport("org.razer", MockDaemon::devicePath().path(), QDBusConnection::sessionBus());
+    QBENCHMARK {
+        std::unique_ptr<TransportCall> call = transport.createCall("razer.device.lighting.chroma", "setKeyRow");
+        call->appendBytes(ROW);
+        QVERIFY(call->send().isOk());
+    }
+}
+
+void BenchTransport::transportSetter()
+{
+    // A single small argument, like most setters of Device and Led
+    Transport transport("org.razer", MockDaemon::devicePath().path(), QDBusConnection::sessionBus());
+    QBENCHMARK {
+        std::unique_ptr<TransportCall> call = transport.createCall("razer.device.lighting.brightness", "setBrightness");
+        call->appendDouble(50);
+        QVERIFY(call->send().isOk());
+    }
+}
+
+QTEST_GUILESS_MAIN(BenchTransport)
+#include "bench_transport.moc"
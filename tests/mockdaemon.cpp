@@ -0,0 +1,384 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "mockdaemon.h"
+
+#include "circuitbreaker_p.h"
+
+#include <QAtomicInt>
+#include <QDBusConnection>
+#include <QDBusServer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <sys/mman.h>
+
+static const char *SERVICE_NAME = "org.razer";
+static const char *SERIAL = "MOCK0001";
+
+MockDaemon::MockDaemon(const Options &options)
+    : options(options)
+{
+    static QAtomicInt versions;
+    if (this->options.version.isEmpty())
+        this->options.version = QString("3.99.%1").arg(versions.fetchAndAddRelaxed(1));
+    start();
+    ready.acquire();
+}
+
+MockDaemon::~MockDaemon()
+{
+    quit();
+    wait();
+}
+
+std::unique_ptr<MockDaemon> MockDaemon::start(const Options &options)
+{
+    libopenrazer::CircuitBreaker *breaker = libopenrazer::CircuitBreaker::forService(SERVICE_NAME, QDBusConnection::sessionBus());
+    int generation = breaker->ownerGeneration();
+    auto daemon = std::make_unique<MockDaemon>(options);
+    if (!QTest::qWaitFor([&]() { return breaker->ownerGeneration() != generation && !breaker->isOpen(); }))
+        qWarning("The library didn't notice the mock daemon");
+    return daemon;
+}
+
+bool MockDaemon::setUpTestCase()
+{
+    // Before the library looks at the cache directory for the first time
+    static QTemporaryDir cacheDir;
+    qputenv("XDG_CACHE_HOME", QFile::encodeName(cacheDir.path()));
+    return QDBusConnection::sessionBus().isConnected();
+}
+
+void MockDaemon::openBreakerAndWaitForProbe()
+{
+    libopenrazer::CircuitBreaker *breaker = libopenrazer::CircuitBreaker::forService(SERVICE_NAME, QDBusConnection::sessionBus());
+    breaker->recordReply(QDBusMessage::createError(QDBusError::ServiceUnknown, "The daemon went away"));
+    if (!breaker->isOpen())
+        qWarning("The circuit breaker didn't open");
+    // RETRY_INTERVAL
+    QTest::qWait(5500);
+}
+
+QDBusObjectPath MockDaemon::devicePath()
+{
+    return QDBusObjectPath(QString("/org/razer/device/%1").arg(SERIAL));
+}
+
+QList<QByteArray> MockDaemon::keyRows() const
+{
+    QMutexLocker locker(&mutex);
+    return m_keyRows;
+}
+
+int MockDaemon::customCalls() const
+{
+    QMutexLocker locker(&mutex);
+    return m_customCalls;
+}
+
+QByteArray MockDaemon::frame() const
+{
+    QMutexLocker locker(&mutex);
+    return m_frame;
+}
+
+quint32 MockDaemon::frameNumber() const
+{
+    QMutexLocker locker(&mutex);
+    return m_frameNumber;
+}
+
+int MockDaemon::peerCalls() const
+{
+    QMutexLocker locker(&mutex);
+    return m_peerCalls;
+}
+
+int MockDaemon::powerCalls() const
+{
+    QMutexLocker locker(&mutex);
+    return m_powerCalls;
+}
+
+int MockDaemon::setterCalls() const
+{
+    QMutexLocker locker(&mutex);
+    return m_setterCalls;
+}
+
+void MockDaemon::recordCall(bool overPeer)
+{
+    QMutexLocker locker(&mutex);
+    if (overPeer)
+        m_peerCalls++;
+}
+
+void MockDaemon::run()
+{
+    // Connection names are process-wide
+    static QAtomicInt counter;
+    QString name = QString("mockdaemon-%1").arg(counter.fetchAndAddRelaxed(1));
+    QDBusConnection bus = QDBusConnection::connectToBus(QDBusConnection::SessionBus, name);
+
+    auto *device = new MockDevice(this, name);
+    if (options.frameBuffer)
+        new MockChromaFrameBufferAdaptor(device);
+    else
+        new MockChromaAdaptor(device);
+    new MockMiscAdaptor(device);
+    if (options.battery)
+        new MockPowerAdaptor(device);
+    if (options.brightness)
+        new MockBrightnessAdaptor(device);
+
+    QDBusServer *server = nullptr;
+    QStringList peers;
+    if (options.peerAddress) {
+        server = new QDBusServer();
+        QObject::connect(server, &QDBusServer::newConnection, device, [device, &peers](const QDBusConnection &connection) {
+            peers.append(connection.name());
+            QDBusConnection(connection).registerObject(devicePath().path(), device, QDBusConnection::ExportAdaptors);
+        });
+    }
+
+    auto *daemonObject = new QObject();
+    new MockDaemonAdaptor(daemonObject, options.version, server != nullptr ? server->address() : QString());
+    new MockDevicesAdaptor(daemonObject);
+
+    bus.registerObject("/org/razer", daemonObject, QDBusConnection::ExportAdaptors);
+    bus.registerObject(devicePath().path(), device, QDBusConnection::ExportAdaptors);
+    if (!bus.registerService(SERVICE_NAME))
+        qWarning("Failed to register %s: %s", SERVICE_NAME, qUtf8Printable(bus.lastError().message()));
+    ready.release();
+
+    exec();
+
+    bus.unregisterService(SERVICE_NAME);
+    for (const QString &peer : std::as_const(peers))
+        QDBusConnection::disconnectFromPeer(peer);
+    delete server;
+    delete daemonObject;
+    delete device;
+    QDBusConnection::disconnectFromBus(name);
+}
+
+MockDevice::MockDevice(MockDaemon *daemon, const QString &busName)
+    : daemon(daemon), busName(busName)
+{
+}
+
+MockDevice::~MockDevice()
+{
+    if (buffer != nullptr)
+        munmap(const_cast<uchar *>(buffer), bufferSize);
+}
+
+void MockDevice::recordCall()
+{
+    daemon->recordCall(calledFromDBus() && connection().name() != busName);
+}
+
+void MockDevice::setKeyRow(const QByteArray &row)
+{
+    recordCall();
+    QMutexLocker locker(&daemon->mutex);
+    daemon->m_keyRows.append(row);
+}
+
+void MockDevice::setCustom()
+{
+    recordCall();
+    QMutexLocker locker(&daemon->mutex);
+    daemon->m_customCalls++;
+}
+
+void MockDevice::setCustomFrameBuffer(const QDBusUnixFileDescriptor &fd, uchar rows, uchar columns)
+{
+    recordCall();
+    if (buffer != nullptr)
+        munmap(const_cast<uchar *>(buffer), bufferSize);
+    buffer = nullptr;
+
+    if (rows != options().rows || columns != options().columns) {
+        sendErrorReply(QDBusError::InvalidArgs, "The buffer doesn't match the matrix");
+        return;
+    }
+    // Keep our own copy of the descriptor, like the daemon would
+    bufferFd = fd;
+    bufferSize = size_t(rows) * columns * 3;
+    void *data = mmap(nullptr, bufferSize, PROT_READ, MAP_SHARED, bufferFd.fileDescriptor(), 0);
+    if (data == MAP_FAILED) {
+        sendErrorReply(QDBusError::Failed, "Failed to map the buffer");
+        return;
+    }
+    buffer = static_cast<const uchar *>(data);
+}
+
+void MockDevice::displayCustomFrameBuffer(uint frame)
+{
+    recordCall();
+    if (buffer == nullptr) {
+        sendErrorReply(QDBusError::Failed, "No frame buffer was set");
+        return;
+    }
+    QMutexLocker locker(&daemon->mutex);
+    daemon->m_frame = QByteArray(reinterpret_cast<const char *>(buffer), bufferSize);
+    daemon->m_frameNumber = frame;
+}
+
+void MockDevice::recordPowerCall()
+{
+    recordCall();
+    QMutexLocker locker(&daemon->mutex);
+    daemon->m_powerCalls++;
+}
+
+void MockDevice::setBrightness(double brightness)
+{
+    recordCall();
+    QMutexLocker locker(&daemon->mutex);
+    daemon->m_setterCalls++;
+    daemon->m_brightness = brightness;
+}
+
+double MockDevice::brightness()
+{
+    recordCall();
+    QMutexLocker locker(&daemon->mutex);
+    return daemon->m_brightness;
+}
+
+void MockDevice::setLowBatteryThreshold(uchar threshold)
+{
+    recordCall();
+    QMutexLocker locker(&daemon->mutex);
+    daemon->m_setterCalls++;
+    daemon->m_lowBatteryThreshold = threshold;
+}
+
+uchar MockDevice::lowBatteryThreshold()
+{
+    recordCall();
+    QMutexLocker locker(&daemon->mutex);
+    return daemon->m_lowBatteryThreshold;
+}
+
+MockDaemonAdaptor::MockDaemonAdaptor(QObject *parent, const QString &version, const QString &peerAddress)
+    : QDBusAbstractAdaptor(parent), m_version(version), m_peerAddress(peerAddress)
+{
+}
+
+MockDevicesAdaptor::MockDevicesAdaptor(QObject *parent)
+    : QDBusAbstractAdaptor(parent)
+{
+}
+
+QStringList MockDevicesAdaptor::getDevices()
+{
+    return { SERIAL };
+}
+
+MockMiscAdaptor::MockMiscAdaptor(MockDevice *device)
+    : QDBusAbstractAdaptor(device), device(device)
+{
+}
+
+QString MockMiscAdaptor::getDeviceName()
+{
+    return "Razer Mock Keyboard";
+}
+
+QString MockMiscAdaptor::getDeviceType()
+{
+    return "keyboard";
+}
+
+QString MockMiscAdaptor::getSerial()
+{
+    return SERIAL;
+}
+
+QList<int> MockMiscAdaptor::getVidPid()
+{
+    return { 0x1532, 0x0203 };
+}
+
+QList<int> MockMiscAdaptor::getMatrixDimensions()
+{
+    return { device->options().rows, device->options().columns };
+}
+
+MockChromaAdaptor::MockChromaAdaptor(MockDevice *device)
+    : QDBusAbstractAdaptor(device), device(device)
+{
+}
+
+void MockChromaAdaptor::setKeyRow(const QByteArray &row)
+{
+    device->setKeyRow(row);
+}
+
+void MockChromaAdaptor::setCustom()
+{
+    device->setCustom();
+}
+
+MockChromaFrameBufferAdaptor::MockChromaFrameBufferAdaptor(MockDevice *device)
+    : MockChromaAdaptor(device)
+{
+}
+
+void MockChromaFrameBufferAdaptor::setCustomFrameBuffer(const QDBusUnixFileDescriptor &fd, uchar rows, uchar columns)
+{
+    device->setCustomFrameBuffer(fd, rows, columns);
+}
+
+void MockChromaFrameBufferAdaptor::displayCustomFrameBuffer(uint frame)
+{
+    device->displayCustomFrameBuffer(frame);
+}
+
+MockPowerAdaptor::MockPowerAdaptor(MockDevice *device)
+    : QDBusAbstractAdaptor(device), device(device)
+{
+}
+
+double MockPowerAdaptor::getBattery()
+{
+    device->recordPowerCall();
+    return 42;
+}
+
+bool MockPowerAdaptor::isCharging()
+{
+    device->recordPowerCall();
+    return false;
+}
+
+uchar MockPowerAdaptor::getLowBatteryThreshold()
+{
+    return device->lowBatteryThreshold();
+}
+
+void MockPowerAdaptor::setLowBatteryThreshold(uchar threshold)
+{
+    device->setLowBatteryThreshold(threshold);
+}
+
+MockBrightnessAdaptor::MockBrightnessAdaptor(MockDevice *device)
+    : QDBusAbstractAdaptor(device), device(device)
+{
+}
+
+double MockBrightnessAdaptor::getBrightness()
+{
+    return device->brightness();
+}
+
+void MockBrightnessAdaptor::setBrightness(double brightness)
+{
+    device->setBrightness(brightness);
+}
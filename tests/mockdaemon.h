@@ -0,0 +1,256 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef MOCKDAEMON_H
+#define MOCKDAEMON_H
+
+#include <QDBusAbstractAdaptor>
+#include <QDBusContext>
+#include <QDBusError>
+#include <QDBusObjectPath>
+#include <QDBusUnixFileDescriptor>
+#include <QMutex>
+#include <QSemaphore>
+#include <QThread>
+
+#include <memory>
+
+class QDBusServer;
+
+/*
+ * Stand-in for openrazer-daemon serving org.razer with a single device on the
+ * session bus, meant to be run with dbus-run-session.
+ *
+ * The daemon objects live in a thread of their own with their own bus
+ * connection, so the test can make blocking calls to them. Everything the
+ * device receives is recorded and can be read from the test thread.
+ *
+ * Tests using it call MOCKDAEMON_INIT_TEST_CASE() from their initTestCase().
+ */
+class MockDaemon : public QThread
+{
+    Q_OBJECT
+public:
+    struct Options {
+        // Empty for a version no other daemon of the process reported, so the
+        // capabilities of a daemon aren't taken from the cache of another one
+        QString version;
+        // Offer setCustomFrameBuffer and displayCustomFrameBuffer
+        bool frameBuffer = false;
+        // Offer a peer-to-peer address in the PeerAddress property
+        bool peerAddress = false;
+        // Offer razer.device.power
+        bool battery = false;
+        // Offer razer.device.lighting.brightness
+        bool brightness = false;
+        uchar rows = 6;
+        uchar columns = 22;
+    };
+
+    explicit MockDaemon(const Options &options);
+    ~MockDaemon() override;
+
+    /*
+     * Starts a daemon and waits until the library noticed it, devices hand
+     * their frame buffer to each new owner of the service.
+     */
+    static std::unique_ptr<MockDaemon> start(const Options &options = Options());
+
+    /*
+     * Gives the process a cache directory of its own, so the capability
+     * database of earlier runs isn't used. Returns false if there is no
+     * session bus.
+     */
+    static bool setUpTestCase();
+
+    /*
+     * Opens the circuit breaker of org.razer as if the daemon stopped
+     * answering, and waits until it lets a probe call through.
+     */
+    static void openBreakerAndWaitForProbe();
+
+    static QDBusObjectPath devicePath();
+
+    // The rows received through setKeyRow
+    QList<QByteArray> keyRows() const;
+    int customCalls() const;
+    // Content of the shared frame buffer when displayCustomFrameBuffer was called last
+    QByteArray frame() const;
+    quint32 frameNumber() const;
+    // Calls to the device that arrived over a peer-to-peer connection
+    int peerCalls() const;
+    // Calls to getBattery and isCharging
+    int powerCalls() const;
+    // Calls to setBrightness and setLowBatteryThreshold
+    int setterCalls() const;
+
+protected:
+    void run() override;
+
+private:
+    friend class MockDevice;
+
+    void recordCall(bool overPeer);
+
+    Options options;
+    QSemaphore ready;
+
+    mutable QMutex mutex;
+    QList<QByteArray> m_keyRows;
+    int m_customCalls = 0;
+    QByteArray m_frame;
+    quint32 m_frameNumber = 0;
+    int m_peerCalls = 0;
+    int m_powerCalls = 0;
+    int m_setterCalls = 0;
+    // As the daemon stores them
+    double m_brightness = 100;
+    uchar m_lowBatteryThreshold = 10;
+};
+
+/*
+ * The device object, the adaptors below forward to it.
+ */
+class MockDevice : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+public:
+    MockDevice(MockDaemon *daemon, const QString &busName);
+    ~MockDevice() override;
+
+    MockDaemon *daemon;
+    QString busName;
+    const MockDaemon::Options &options() const { return daemon->options; }
+
+    void recordCall();
+    void setKeyRow(const QByteArray &row);
+    void setCustom();
+    void setCustomFrameBuffer(const QDBusUnixFileDescriptor &fd, uchar rows, uchar columns);
+    void displayCustomFrameBuffer(uint frame);
+    void recordPowerCall();
+    void setBrightness(double brightness);
+    double brightness();
+    void setLowBatteryThreshold(uchar threshold);
+    uchar lowBatteryThreshold();
+
+private:
+    QDBusUnixFileDescriptor bufferFd;
+    const uchar *buffer = nullptr;
+    size_t bufferSize = 0;
+};
+
+class MockDaemonAdaptor : public QDBusAbstractAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "razer.daemon")
+    Q_PROPERTY(QString PeerAddress READ peerAddress)
+public:
+    MockDaemonAdaptor(QObject *parent, const QString &version, const QString &peerAddress);
+
+    QString peerAddress() const { return m_peerAddress; }
+
+public Q_SLOTS:
+    QString version() { return m_version; }
+
+private:
+    QString m_version;
+    QString m_peerAddress;
+};
+
+class MockDevicesAdaptor : public QDBusAbstractAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "razer.devices")
+public:
+    explicit MockDevicesAdaptor(QObject *parent);
+
+public Q_SLOTS:
+    QStringList getDevices();
+};
+
+class MockMiscAdaptor : public QDBusAbstractAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "razer.device.misc")
+public:
+    explicit MockMiscAdaptor(MockDevice *device);
+
+public Q_SLOTS:
+    QString getDeviceName();
+    QString getDeviceType();
+    QString getSerial();
+    QList<int> getVidPid();
+    QList<int> getMatrixDimensions();
+
+private:
+    MockDevice *device;
+};
+
+class MockChromaAdaptor : public QDBusAbstractAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "razer.device.lighting.chroma")
+public:
+    explicit MockChromaAdaptor(MockDevice *device);
+
+public Q_SLOTS:
+    void setKeyRow(const QByteArray &row);
+    void setCustom();
+
+protected:
+    MockDevice *device;
+};
+
+// The same interface with the shared frame buffer methods added
+class MockChromaFrameBufferAdaptor : public MockChromaAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "razer.device.lighting.chroma")
+public:
+    explicit MockChromaFrameBufferAdaptor(MockDevice *device);
+
+public Q_SLOTS:
+    void setCustomFrameBuffer(const QDBusUnixFileDescriptor &fd, uchar rows, uchar columns);
+    void displayCustomFrameBuffer(uint frame);
+};
+
+class MockPowerAdaptor : public QDBusAbstractAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "razer.device.power")
+public:
+    explicit MockPowerAdaptor(MockDevice *device);
+
+public Q_SLOTS:
+    double getBattery();
+    bool isCharging();
+    uchar getLowBatteryThreshold();
+    void setLowBatteryThreshold(uchar threshold);
+
+private:
+    MockDevice *device;
+};
+
+class MockBrightnessAdaptor : public QDBusAbstractAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "razer.device.lighting.brightness")
+public:
+    explicit MockBrightnessAdaptor(MockDevice *device);
+
+public Q_SLOTS:
+    double getBrightness();
+    void setBrightness(double brightness);
+
+private:
+    MockDevice *device;
+};
+
+#define MOCKDAEMON_INIT_TEST_CASE()                                             \
+    do {                                                                        \
+        if (!MockDaemon::setUpTestCase())                                       \
+            QSKIP("No session bus, run the test with dbus-run-session");        \
+    } while (false)
+
+#endif // MOCKDAEMON_H
@@ -0,0 +1,165 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "mockdaemon.h"
+
+#include "circuitbreaker_p.h"
+#include "dbusinterface_p.h"
+
+#include <QDBusError>
+#include <QElapsedTimer>
+#include <QTest>
+
+#include <memory>
+
+using namespace libopenrazer;
+
+class TestCircuitBreaker : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void opensAfterTimeouts();
+    void opensWhenServiceIsUnknown();
+    void serviceErrorsDontCount();
+    void failsFastWhileOpen();
+    void sendsWithoutBreaker();
+    void probesOnceAfterRetryInterval();
+    void failedProbeReopens();
+    void asyncProbeOutlivesContext();
+};
+
+/*
+ * Returns the breaker of a service nobody owns, so it only changes state
+ * through what the test records.
+ */
+static CircuitBreaker *unownedBreaker()
+{
+    static int counter = 0;
+    QString service = QString("org.libopenrazer.test.unowned%1").arg(counter++);
+    return CircuitBreaker::forService(service, QDBusConnection::sessionBus());
+}
+
+static QDBusMessage error(QDBusError::ErrorType type)
+{
+    return QDBusMessage::createError(type, "Recorded by the test");
+}
+
+void TestCircuitBreaker::initTestCase()
+{
+    MOCKDAEMON_INIT_TEST_CASE();
+}
+
+void TestCircuitBreaker::opensAfterTimeouts()
+{
+    CircuitBreaker *breaker = unownedBreaker();
+    QVERIFY(breaker->allowRequest());
+
+    breaker->recordReply(error(QDBusError::NoReply));
+    QVERIFY(!breaker->isOpen());
+    QVERIFY(breaker->allowRequest());
+
+    // FAILURE_THRESHOLD
+    breaker->recordReply(error(QDBusError::Timeout));
+    QVERIFY(breaker->isOpen());
+    QVERIFY(!breaker->allowRequest());
+}
+
+void TestCircuitBreaker::opensWhenServiceIsUnknown()
+{
+    CircuitBreaker *breaker = unownedBreaker();
+    breaker->recordReply(error(QDBusError::ServiceUnknown));
+    QVERIFY(breaker->isOpen());
+    QVERIFY(!breaker->allowRequest());
+}
+
+void TestCircuitBreaker::serviceErrorsDontCount()
+{
+    CircuitBreaker *breaker = unownedBreaker();
+    breaker->recordReply(error(QDBusError::NoReply));
+    // The service answered, the timeouts aren't consecutive anymore
+    breaker->recordReply(error(QDBusError::InvalidArgs));
+    breaker->recordReply(error(QDBusError::NoReply));
+    QVERIFY(!breaker->isOpen());
+}
+
+void TestCircuitBreaker::failsFastWhileOpen()
+{
+    CircuitBreaker *breaker = unownedBreaker();
+    breaker->recordReply(error(QDBusError::ServiceUnknown));
+
+    QDBusMessage call = QDBusMessage::createMethodCall("org.libopenrazer.test.unowned", "/", "org.freedesktop.DBus.Peer", "Ping");
+    QElapsedTimer timer;
+    timer.start();
+    QDBusMessage reply = sendDBusMessage(breaker, QDBusConnection::sessionBus(), call, 25000);
+    QVERIFY(timer.elapsed() < 1000);
+    QCOMPARE(reply.errorName(), QString(SERVICE_UNAVAILABLE_ERROR));
+}
+
+void TestCircuitBreaker::sendsWithoutBreaker()
+{
+    // Like over a PeerConnection
+    QDBusMessage call = QDBusMessage::createMethodCall("org.freedesktop.DBus", "/org/freedesktop/DBus", "org.freedesktop.DBus.Peer", "Ping");
+    QCOMPARE(sendDBusMessage(nullptr, QDBusConnection::sessionBus(), call).type(), QDBusMessage::ReplyMessage);
+
+    QList<QDBusMessage> replies = sendDBusMessages(nullptr, QDBusConnection::sessionBus(), { call, call });
+    QCOMPARE(replies.size(), 2);
+    QCOMPARE(replies[0].type(), QDBusMessage::ReplyMessage);
+    QCOMPARE(replies[1].type(), QDBusMessage::ReplyMessage);
+}
+
+void TestCircuitBreaker::probesOnceAfterRetryInterval()
+{
+    CircuitBreaker *breaker = unownedBreaker();
+    breaker->recordReply(error(QDBusError::ServiceUnknown));
+    QVERIFY(!breaker->allowRequest());
+
+    // RETRY_INTERVAL
+    QTest::qWait(5500);
+    QVERIFY(breaker->allowRequest());
+    // Only one probe at a time
+    QVERIFY(!breaker->allowRequest());
+    QVERIFY(breaker->isOpen());
+
+    breaker->recordSuccess();
+    QVERIFY(!breaker->isOpen());
+    QVERIFY(breaker->allowRequest());
+}
+
+void TestCircuitBreaker::failedProbeReopens()
+{
+    CircuitBreaker *breaker = unownedBreaker();
+    breaker->recordReply(error(QDBusError::ServiceUnknown));
+
+    QTest::qWait(5500);
+    QVERIFY(breaker->allowRequest());
+    // A single timeout of the probe is enough
+    breaker->recordReply(error(QDBusError::NoReply));
+    QVERIFY(breaker->isOpen());
+    QVERIFY(!breaker->allowRequest());
+}
+
+void TestCircuitBreaker::asyncProbeOutlivesContext()
+{
+    std::unique_ptr<MockDaemon> daemon = MockDaemon::start();
+
+    CircuitBreaker *breaker = CircuitBreaker::forService("org.razer", QDBusConnection::sessionBus());
+    MockDaemon::openBreakerAndWaitForProbe();
+
+    DBusCommand command;
+    command.message = QDBusMessage::createMethodCall("org.razer", "/org/razer", "razer.daemon", "version");
+    command.connection = QDBusConnection::sessionBus();
+    bool called = false;
+    auto *context = new QObject();
+    sendDBusCommandsAsync({ command }, context, [&called](const QList<QDBusMessage> &) { called = true; });
+    // Gone before the probe is answered
+    delete context;
+
+    // The reply still closed the breaker instead of leaving it half-open
+    QTRY_VERIFY(!breaker->isOpen());
+    QVERIFY(!called);
+}
+
+QTEST_GUILESS_MAIN(TestCircuitBreaker)
+#include "tst_circuitbreaker.moc"
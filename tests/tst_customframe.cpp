@@ -0,0 +1,94 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "mockdaemon.h"
+
+#include <libopenrazer.h>
+
+#include <QTest>
+
+#include <memory>
+
+using namespace libopenrazer;
+
+class TestCustomFrame : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void frameBuffer();
+    void frameBufferRejectsMismatchedColumns();
+    void keyRowFallback();
+};
+
+static QVector<::openrazer::RGB> colors(int count, uchar seed)
+{
+    QVector<::openrazer::RGB> result;
+    for (int i = 0; i < count; i++)
+        result.append({ uchar(seed + i), uchar(seed + i + 1), uchar(seed + i + 2) });
+    return result;
+}
+
+void TestCustomFrame::initTestCase()
+{
+    MOCKDAEMON_INIT_TEST_CASE();
+}
+
+void TestCustomFrame::frameBuffer()
+{
+    MockDaemon::Options options;
+    options.frameBuffer = true;
+    std::unique_ptr<MockDaemon> daemon = MockDaemon::start(options);
+
+    openrazer::Device device(MockDaemon::devicePath());
+    QVERIFY(device.features().testFlag(Feature::CustomFrame));
+
+    QVERIFY(device.tryDefineCustomFrame(0, 0, 1, colors(2, 10)).isOk());
+    QVERIFY(device.tryDefineCustomFrame(5, 20, 21, colors(2, 100)).isOk());
+    QVERIFY(device.tryDisplayCustomFrame().isOk());
+
+    // Only the frame number went over D-Bus, the rows were read from the shared buffer
+    QVERIFY(daemon->keyRows().isEmpty());
+    QCOMPARE(daemon->customCalls(), 0);
+    QCOMPARE(daemon->frameNumber(), 1u);
+
+    QByteArray frame = daemon->frame();
+    QCOMPARE(frame.size(), options.rows * options.columns * 3);
+    QCOMPARE(frame.mid(0, 6), QByteArray("\x0a\x0b\x0c\x0b\x0c\x0d", 6));
+    int lastRow = (5 * options.columns + 20) * 3;
+    QCOMPARE(frame.mid(lastRow, 6), QByteArray("\x64\x65\x66\x65\x66\x67", 6));
+
+    QVERIFY(device.tryDisplayCustomFrame().isOk());
+    QCOMPARE(daemon->frameNumber(), 2u);
+}
+
+void TestCustomFrame::frameBufferRejectsMismatchedColumns()
+{
+    MockDaemon::Options options;
+    options.frameBuffer = true;
+    std::unique_ptr<MockDaemon> daemon = MockDaemon::start(options);
+
+    openrazer::Device device(MockDaemon::devicePath());
+    // Three columns but only two colors
+    QVERIFY(!device.tryDefineCustomFrame(0, 0, 2, colors(2, 0)).isOk());
+    // Past the last column
+    QVERIFY(!device.tryDefineCustomFrame(0, 21, 22, colors(2, 0)).isOk());
+    QVERIFY(device.tryDefineCustomFrame(0, 21, 21, colors(1, 0)).isOk());
+}
+
+void TestCustomFrame::keyRowFallback()
+{
+    std::unique_ptr<MockDaemon> daemon = MockDaemon::start();
+
+    openrazer::Device device(MockDaemon::devicePath());
+    QVERIFY(device.tryDefineCustomFrame(2, 3, 4, colors(2, 1)).isOk());
+    QVERIFY(device.tryDisplayCustomFrame().isOk());
+
+    QCOMPARE(daemon->keyRows(), QList<QByteArray> { QByteArray("\x02\x03\x04\x01\x02\x03\x02\x03\x04", 9) });
+    QCOMPARE(daemon->customCalls(), 1);
+    QCOMPARE(daemon->frameNumber(), 0u);
+}
+
+QTEST_GUILESS_MAIN(TestCustomFrame)
+#include "tst_customframe.moc"
@@ -0,0 +1,56 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "mockdaemon.h"
+
+#include "circuitbreaker_p.h"
+
+#include <libopenrazer.h>
+
+#include <QTest>
+
+#include <memory>
+
+using namespace libopenrazer;
+
+class TestPowerMonitor : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void destroyedMidPoll();
+};
+
+void TestPowerMonitor::initTestCase()
+{
+    MOCKDAEMON_INIT_TEST_CASE();
+}
+
+void TestPowerMonitor::destroyedMidPoll()
+{
+    MockDaemon::Options options;
+    options.battery = true;
+    std::unique_ptr<MockDaemon> daemon = MockDaemon::start(options);
+
+    openrazer::Manager manager(QDBusConnection::sessionBus());
+    QList<Device *> devices = manager.getTrackedDevices();
+    QCOMPARE(devices.size(), 1);
+    // Read the features now, so the poll is the first call after the breaker opened
+    QVERIFY(devices[0]->hasFeature(Feature::Battery));
+
+    CircuitBreaker *breaker = CircuitBreaker::forService("org.razer", QDBusConnection::sessionBus());
+    MockDaemon::openBreakerAndWaitForProbe();
+
+    PowerMonitor *monitor = PowerMonitor::forManager(&manager);
+    QObject subscriber;
+    // Polls right away, the batch of calls is the probe
+    monitor->subscribe(&subscriber);
+    delete monitor;
+
+    QTRY_VERIFY(!breaker->isOpen());
+    QVERIFY(daemon->powerCalls() > 0);
+}
+
+QTEST_GUILESS_MAIN(TestPowerMonitor)
+#include "tst_powermonitor.moc"
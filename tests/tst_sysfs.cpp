@@ -0,0 +1,213 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <libopenrazer.h>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <memory>
+
+using namespace libopenrazer;
+
+/*
+ * Runs the sysfs backend against a fake tree of regular files laid out like
+ * /sys/bus/hid/drivers.
+ */
+class TestSysfs : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void init();
+    void openAll();
+    void writeReplacesLongerValue();
+    void customFrameBatchesRows();
+    void customFrameFlushesFullWrites();
+    void effectPayloads();
+    void dpiStages();
+
+private:
+    void writeAttribute(const QString &name, const QByteArray &value);
+    QByteArray readAttribute(const QString &name);
+
+    std::unique_ptr<QTemporaryDir> root;
+    QString devicePath;
+};
+
+void TestSysfs::writeAttribute(const QString &name, const QByteArray &value)
+{
+    QFile file(devicePath + "/" + name);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(value);
+}
+
+QByteArray TestSysfs::readAttribute(const QString &name)
+{
+    QFile file(devicePath + "/" + name);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+    return file.readAll();
+}
+
+void TestSysfs::init()
+{
+    root = std::make_unique<QTemporaryDir>();
+    QVERIFY(root->isValid());
+    devicePath = root->filePath("razermouse/0003:1532:0084.0001");
+    QVERIFY(QDir().mkpath(devicePath));
+    // Another interface of the same device, without attributes
+    QVERIFY(QDir().mkpath(root->filePath("razermouse/0003:1532:0084.0002")));
+
+    writeAttribute("device_type", "Razer DeathAdder V2\n");
+    writeAttribute("device_serial", "PM0000000000001\n");
+    writeAttribute("poll_rate", "1000\n");
+    writeAttribute("logo_led_brightness", "255\n");
+}
+
+void TestSysfs::openAll()
+{
+    QList<sysfs::Device *> devices = sysfs::Device::openAll(root->path());
+    QCOMPARE(devices.size(), 1);
+    std::unique_ptr<sysfs::Device> device(devices[0]);
+
+    QCOMPARE(device->tryGetDeviceName().value(), QString("Razer DeathAdder V2"));
+    QCOMPARE(device->tryGetDeviceType().value(), QString("mouse"));
+    QVERIFY(device->hasFeature(Feature::PollRate));
+    QVERIFY(!device->hasFeature(Feature::DPI));
+    QCOMPARE(device->getLeds().size(), 1);
+}
+
+void TestSysfs::writeReplacesLongerValue()
+{
+    sysfs::Device device(devicePath);
+
+    QVERIFY(device.trySetPollRate(500).isOk());
+    QCOMPARE(readAttribute("poll_rate"), QByteArray("500"));
+    QCOMPARE(device.tryGetPollRate().value(), ushort(500));
+
+    Led *led = device.getLeds().value(0);
+    QVERIFY(led != nullptr);
+    QVERIFY(led->trySetBrightness(7).isOk());
+    QCOMPARE(readAttribute("logo_led_brightness"), QByteArray("7"));
+}
+
+// A row of the custom frame as the driver takes it, the row and column range followed by the colors
+static QByteArray frameRow(uchar row, const QVector<::openrazer::RGB> &colors)
+{
+    QByteArray data;
+    data.append(char(row));
+    data.append(char(0));
+    data.append(char(colors.size() - 1));
+    for (const ::openrazer::RGB &color : colors) {
+        data.append(char(color.r));
+        data.append(char(color.g));
+        data.append(char(color.b));
+    }
+    return data;
+}
+
+void TestSysfs::customFrameBatchesRows()
+{
+    writeAttribute("matrix_custom_frame", QByteArray());
+    writeAttribute("matrix_effect_custom", QByteArray());
+    sysfs::Device device(devicePath);
+    QVERIFY(device.hasFeature(Feature::CustomFrame));
+
+    QByteArray expected;
+    for (uchar row = 0; row < 6; row++) {
+        QVector<::openrazer::RGB> colors(22, { row, 0x7f, 0xff });
+        QVERIFY(device.tryDefineCustomFrame(row, 0, 21, colors).isOk());
+        expected += frameRow(row, colors);
+    }
+    // Nothing is written before the frame is displayed
+    QCOMPARE(readAttribute("matrix_custom_frame"), QByteArray());
+    QCOMPARE(readAttribute("matrix_effect_custom"), QByteArray());
+
+    QVERIFY(device.tryDisplayCustomFrame().isOk());
+    // All rows in a single write
+    QCOMPARE(readAttribute("matrix_custom_frame"), expected);
+    QCOMPARE(readAttribute("matrix_effect_custom"), QByteArray("1"));
+}
+
+void TestSysfs::customFrameFlushesFullWrites()
+{
+    writeAttribute("matrix_custom_frame", QByteArray());
+    writeAttribute("matrix_effect_custom", QByteArray());
+    sysfs::Device device(devicePath);
+
+    // 603 bytes per row, the seventh one doesn't fit into a page anymore
+    QVector<::openrazer::RGB> colors(200, { 0x12, 0x34, 0x56 });
+    QByteArray firstRows;
+    for (uchar row = 0; row < 6; row++) {
+        QVERIFY(device.tryDefineCustomFrame(row, 0, 199, colors).isOk());
+        firstRows += frameRow(row, colors);
+    }
+    QVERIFY(firstRows.size() <= 4096);
+    QCOMPARE(readAttribute("matrix_custom_frame"), QByteArray());
+
+    QVERIFY(device.tryDefineCustomFrame(6, 0, 199, colors).isOk());
+    QCOMPARE(readAttribute("matrix_custom_frame"), firstRows);
+
+    QVERIFY(device.tryDisplayCustomFrame().isOk());
+    QCOMPARE(readAttribute("matrix_custom_frame"), frameRow(6, colors));
+}
+
+void TestSysfs::effectPayloads()
+{
+    for (const char *effect : { "breath", "reactive", "wave", "wheel" })
+        writeAttribute(QString("logo_matrix_effect_") + effect, QByteArray());
+    sysfs::Device device(devicePath);
+    Led *led = device.getLeds().value(0);
+    QVERIFY(led != nullptr);
+
+    // The speed byte, then the color
+    QVERIFY(led->trySetReactive({ 0x01, 0x02, 0x03 }, ::openrazer::ReactiveSpeed::_1000MS).isOk());
+    QCOMPARE(readAttribute("logo_matrix_effect_reactive"), QByteArray("\x02\x01\x02\x03", 4));
+    QCOMPARE(led->tryGetCurrentEffect().value(), ::openrazer::Effect::Reactive);
+
+    // The directions are written as ASCII numbers
+    QVERIFY(led->trySetWave(::openrazer::WaveDirection::RIGHT_TO_LEFT).isOk());
+    QCOMPARE(readAttribute("logo_matrix_effect_wave"), QByteArray("2"));
+    QCOMPARE(led->tryGetWaveDirection().value(), ::openrazer::WaveDirection::RIGHT_TO_LEFT);
+    QVERIFY(led->trySetWheel(::openrazer::WheelDirection::CLOCKWISE).isOk());
+    QCOMPARE(readAttribute("logo_matrix_effect_wheel"), QByteArray("1"));
+
+    // The number of bytes selects the breathing variant
+    QVERIFY(led->trySetBreathingRandom().isOk());
+    QCOMPARE(readAttribute("logo_matrix_effect_breath"), QByteArray("1"));
+    QCOMPARE(led->tryGetCurrentEffect().value(), ::openrazer::Effect::BreathingRandom);
+    QVERIFY(led->trySetBreathing({ 0x10, 0x20, 0x30 }).isOk());
+    QCOMPARE(readAttribute("logo_matrix_effect_breath"), QByteArray("\x10\x20\x30", 3));
+    QVERIFY(led->trySetBreathingDual({ 0x10, 0x20, 0x30 }, { 0x40, 0x50, 0x60 }).isOk());
+    QCOMPARE(readAttribute("logo_matrix_effect_breath"), QByteArray("\x10\x20\x30\x40\x50\x60", 6));
+    QCOMPARE(led->tryGetCurrentColors().value().size(), 2);
+}
+
+void TestSysfs::dpiStages()
+{
+    // The active stage, then big-endian x and y of each stage
+    writeAttribute("dpi_stages", QByteArray("\x02\x03\x20\x03\x20\x06\x40\x06\x40", 9));
+    sysfs::Device device(devicePath);
+    QVERIFY(device.hasFeature(Feature::DPIStages));
+
+    Result<QPair<uchar, QVector<::openrazer::DPI>>> stages = device.tryGetDPIStages();
+    QVERIFY(stages.isOk());
+    QCOMPARE(stages.value().first, uchar(2));
+    QCOMPARE(stages.value().second.size(), 2);
+    QCOMPARE(stages.value().second[0], ::openrazer::DPI({ 800, 800 }));
+    QCOMPARE(stages.value().second[1], ::openrazer::DPI({ 1600, 1600 }));
+
+    QVERIFY(device.trySetDPIStages(1, { { 400, 800 } }).isOk());
+    QCOMPARE(readAttribute("dpi_stages"), QByteArray("\x01\x01\x90\x03\x20", 5));
+    QCOMPARE(device.tryGetDPIStages().value().second[0], ::openrazer::DPI({ 400, 800 }));
+
+    // Not a whole number of stages
+    writeAttribute("dpi_stages", QByteArray("\x01\x03\x20", 3));
+    QVERIFY(!device.tryGetDPIStages().isOk());
+}
+
+QTEST_GUILESS_MAIN(TestSysfs)
+#include "tst_sysfs.moc"
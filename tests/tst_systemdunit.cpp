@@ -0,0 +1,354 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "systemdunit_p.h"
+
+#include <QAtomicInt>
+#include <QDBusAbstractAdaptor>
+#include <QDBusConnection>
+#include <QDBusContext>
+#include <QMutex>
+#include <QSemaphore>
+#include <QTest>
+#include <QThread>
+#include <QTimer>
+
+#include <climits>
+#include <memory>
+#include <optional>
+
+using namespace libopenrazer;
+
+static const char *SERVICE_NAME = "org.libopenrazer.test.systemd1";
+static const char *UNIT = "openrazer-daemon.service";
+
+/*
+ * Stand-in for the systemd manager, set through LIBOPENRAZER_SYSTEMD_SERVICE.
+ * Lives in a thread of its own so the blocking calls of SystemdUnit get
+ * answered.
+ */
+class MockSystemd : public QThread
+{
+    Q_OBJECT
+public:
+    // enableDelay is how long EnableUnitFiles takes, like waiting for the user to authorize it
+    explicit MockSystemd(int enableDelay = 0, const QString &state = QStringLiteral("disabled"))
+        : enableDelay(enableDelay), m_state(state)
+    {
+        start();
+        ready.acquire();
+    }
+
+    ~MockSystemd() override
+    {
+        quit();
+        wait();
+    }
+
+    QString state() const
+    {
+        QMutexLocker locker(&mutex);
+        return m_state;
+    }
+
+    // Changes the state without telling anyone, like editing the unit files by hand
+    void setState(const QString &state)
+    {
+        QMutexLocker locker(&mutex);
+        m_state = state;
+    }
+
+    int reloadCalls() const
+    {
+        QMutexLocker locker(&mutex);
+        return m_reloadCalls;
+    }
+
+    int stateCalls() const
+    {
+        QMutexLocker locker(&mutex);
+        return m_stateCalls;
+    }
+
+    // Emits the signal of the manager interface, from the connection that owns the service
+    void emitSignal(const QString &name, const QVariantList &arguments = {})
+    {
+        QDBusMessage signal = QDBusMessage::createSignal("/org/freedesktop/systemd1", "org.freedesktop.systemd1.Manager", name);
+        signal.setArguments(arguments);
+        QDBusConnection(busName).send(signal);
+    }
+
+    const int enableDelay;
+    mutable QMutex mutex;
+    QString m_state;
+    int m_reloadCalls = 0;
+    int m_stateCalls = 0;
+    QString busName;
+
+protected:
+    void run() override;
+
+private:
+    QSemaphore ready;
+};
+
+class MockSystemdManager : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+public:
+    explicit MockSystemdManager(MockSystemd *systemd)
+        : systemd(systemd)
+    {
+    }
+
+    QString getUnitFileState(const QString &unit)
+    {
+        if (unit != UNIT) {
+            sendErrorReply("org.freedesktop.systemd1.NoSuchUnit", QString("Unit %1 does not exist.").arg(unit));
+            return QString();
+        }
+        QMutexLocker locker(&systemd->mutex);
+        systemd->m_stateCalls++;
+        return systemd->m_state;
+    }
+
+    bool enableUnitFiles(const QStringList &files)
+    {
+        QDBusMessage reply = message().createReply(QVariant(false));
+        setDelayedReply(true);
+        QDBusConnection bus = connection();
+        QTimer::singleShot(systemd->enableDelay, this, [this, files, reply, bus]() {
+            QMutexLocker locker(&systemd->mutex);
+            if (files.contains(UNIT))
+                systemd->m_state = "enabled";
+            bus.send(reply);
+        });
+        return false;
+    }
+
+    void reload()
+    {
+        QMutexLocker locker(&systemd->mutex);
+        systemd->m_reloadCalls++;
+    }
+
+private:
+    MockSystemd *systemd;
+};
+
+class MockSystemdManagerAdaptor : public QDBusAbstractAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.freedesktop.systemd1.Manager")
+public:
+    explicit MockSystemdManagerAdaptor(MockSystemdManager *manager)
+        : QDBusAbstractAdaptor(manager), manager(manager)
+    {
+    }
+
+public Q_SLOTS:
+    QString GetUnitFileState(const QString &unit) { return manager->getUnitFileState(unit); }
+    bool EnableUnitFiles(const QStringList &files, bool runtime, bool force)
+    {
+        Q_UNUSED(runtime);
+        Q_UNUSED(force);
+        return manager->enableUnitFiles(files);
+    }
+    void Reload() { manager->reload(); }
+    void Subscribe() { }
+
+private:
+    MockSystemdManager *manager;
+};
+
+void MockSystemd::run()
+{
+    static QAtomicInt counter;
+    QString name = QString("mocksystemd-%1").arg(counter.fetchAndAddRelaxed(1));
+    QDBusConnection bus = QDBusConnection::connectToBus(QDBusConnection::SessionBus, name);
+    busName = name;
+
+    auto *manager = new MockSystemdManager(this);
+    new MockSystemdManagerAdaptor(manager);
+    bus.registerObject("/org/freedesktop/systemd1", manager, QDBusConnection::ExportAdaptors);
+    if (!bus.registerService(SERVICE_NAME))
+        qWarning("Failed to register %s: %s", SERVICE_NAME, qUtf8Printable(bus.lastError().message()));
+    ready.release();
+
+    exec();
+
+    bus.unregisterService(SERVICE_NAME);
+    delete manager;
+    QDBusConnection::disconnectFromBus(name);
+}
+
+class TestSystemdUnit : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void enable();
+    void enableDoesntTimeOutByDefault();
+    void enableTimeout();
+    void enableAsync();
+    void statusIsCached();
+    void statusAsync();
+    void unitFilesChangedInvalidates();
+    void reloadingInvalidates();
+    void ownerChangeInvalidates();
+    void notInstalled();
+};
+
+void TestSystemdUnit::initTestCase()
+{
+    if (!QDBusConnection::sessionBus().isConnected())
+        QSKIP("No session bus, run the test with dbus-run-session");
+    qputenv("LIBOPENRAZER_SYSTEMD_SERVICE", SERVICE_NAME);
+}
+
+void TestSystemdUnit::enable()
+{
+    MockSystemd systemd;
+    SystemdUnit unit(UNIT, "/usr/bin/openrazer-daemon", QDBusConnection::sessionBus(), nullptr);
+
+    QCOMPARE(unit.status(), DaemonStatus::Disabled);
+    QVERIFY(unit.enable());
+    QCOMPARE(systemd.reloadCalls(), 1);
+    // Enabling dropped the cached status
+    QCOMPARE(unit.status(), DaemonStatus::Enabled);
+}
+
+void TestSystemdUnit::enableDoesntTimeOutByDefault()
+{
+    SystemdUnit unit(UNIT, "/usr/bin/openrazer-daemon", QDBusConnection::sessionBus(), nullptr);
+    // Longer than the D-Bus default of 25 seconds, which the user might need to authorize it
+    QCOMPARE(unit.enableTimeout(), INT_MAX);
+}
+
+void TestSystemdUnit::enableTimeout()
+{
+    MockSystemd systemd(1000);
+    SystemdUnit unit(UNIT, "/usr/bin/openrazer-daemon", QDBusConnection::sessionBus(), nullptr);
+
+    unit.setEnableTimeout(100);
+    QVERIFY(!unit.enable());
+    QCOMPARE(systemd.reloadCalls(), 0);
+
+    unit.setEnableTimeout(5000);
+    QVERIFY(unit.enable());
+    QCOMPARE(systemd.reloadCalls(), 1);
+}
+
+void TestSystemdUnit::enableAsync()
+{
+    MockSystemd systemd(100);
+    SystemdUnit unit(UNIT, "/usr/bin/openrazer-daemon", QDBusConnection::sessionBus(), nullptr);
+    QCOMPARE(unit.status(), DaemonStatus::Disabled);
+
+    QObject context;
+    std::optional<bool> success;
+    unit.enableAsync(&context, [&success](bool result) { success = result; });
+    QVERIFY(!success);
+    QTRY_VERIFY(success);
+    QVERIFY(*success);
+    QCOMPARE(systemd.reloadCalls(), 1);
+    QCOMPARE(unit.status(), DaemonStatus::Enabled);
+
+    // Timing out is reported as well
+    unit.setEnableTimeout(10);
+    success.reset();
+    unit.enableAsync(&context, [&success](bool result) { success = result; });
+    QTRY_VERIFY(success);
+    QVERIFY(!*success);
+}
+
+void TestSystemdUnit::statusIsCached()
+{
+    MockSystemd systemd;
+    SystemdUnit unit(UNIT, "/usr/bin/openrazer-daemon", QDBusConnection::sessionBus(), nullptr);
+
+    QCOMPARE(unit.status(), DaemonStatus::Disabled);
+    systemd.setState("enabled");
+    // Nothing told the unit about the change
+    QCOMPARE(unit.status(), DaemonStatus::Disabled);
+    QCOMPARE(systemd.stateCalls(), 1);
+}
+
+void TestSystemdUnit::statusAsync()
+{
+    MockSystemd systemd;
+    SystemdUnit unit(UNIT, "/usr/bin/openrazer-daemon", QDBusConnection::sessionBus(), nullptr);
+
+    QObject context;
+    std::optional<DaemonStatus> status;
+    unit.statusAsync(&context, [&status](DaemonStatus result) { status = result; });
+    QTRY_VERIFY(status);
+    QCOMPARE(*status, DaemonStatus::Disabled);
+    QCOMPARE(systemd.stateCalls(), 1);
+
+    // Answered from the cache, but still not from within the call
+    status.reset();
+    unit.statusAsync(&context, [&status](DaemonStatus result) { status = result; });
+    QVERIFY(!status);
+    QTRY_VERIFY(status);
+    QCOMPARE(*status, DaemonStatus::Disabled);
+    QCOMPARE(systemd.stateCalls(), 1);
+
+    // Dropped together with the context
+    SystemdUnit uncached(UNIT, "/usr/bin/openrazer-daemon", QDBusConnection::sessionBus(), nullptr);
+    status.reset();
+    auto *shortLived = new QObject();
+    uncached.statusAsync(shortLived, [&status](DaemonStatus result) { status = result; });
+    delete shortLived;
+    QTRY_COMPARE(systemd.stateCalls(), 2);
+    QTest::qWait(100);
+    QVERIFY(!status);
+}
+
+void TestSystemdUnit::unitFilesChangedInvalidates()
+{
+    MockSystemd systemd;
+    SystemdUnit unit(UNIT, "/usr/bin/openrazer-daemon", QDBusConnection::sessionBus(), nullptr);
+
+    QCOMPARE(unit.status(), DaemonStatus::Disabled);
+    systemd.setState("enabled");
+    systemd.emitSignal("UnitFilesChanged");
+    QTRY_COMPARE(unit.status(), DaemonStatus::Enabled);
+    QCOMPARE(systemd.stateCalls(), 2);
+}
+
+void TestSystemdUnit::reloadingInvalidates()
+{
+    MockSystemd systemd;
+    SystemdUnit unit(UNIT, "/usr/bin/openrazer-daemon", QDBusConnection::sessionBus(), nullptr);
+
+    QCOMPARE(unit.status(), DaemonStatus::Disabled);
+    systemd.setState("enabled");
+    systemd.emitSignal("Reloading", { true });
+    QTRY_COMPARE(unit.status(), DaemonStatus::Enabled);
+    QCOMPARE(systemd.stateCalls(), 2);
+}
+
+void TestSystemdUnit::ownerChangeInvalidates()
+{
+    auto systemd = std::make_unique<MockSystemd>();
+    SystemdUnit unit(UNIT, "/usr/bin/openrazer-daemon", QDBusConnection::sessionBus(), nullptr);
+    QCOMPARE(unit.status(), DaemonStatus::Disabled);
+
+    // systemd got restarted with the unit enabled, without any signal about it
+    systemd.reset();
+    systemd = std::make_unique<MockSystemd>(0, "enabled");
+    QTRY_COMPARE(unit.status(), DaemonStatus::Enabled);
+}
+
+void TestSystemdUnit::notInstalled()
+{
+    MockSystemd systemd;
+    SystemdUnit unit("razer_test.service", "/usr/bin/razer_test", QDBusConnection::sessionBus(), nullptr);
+
+    QCOMPARE(unit.status(), DaemonStatus::NotInstalled);
+}
+
+QTEST_GUILESS_MAIN(TestSystemdUnit)
+#include "tst_systemdunit.moc"
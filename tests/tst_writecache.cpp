@@ -0,0 +1,96 @@
+// Copyright (C) 2026  Luca Weiss <luca (at) z3ntu (dot) xyz>
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "mockdaemon.h"
+
+#include <libopenrazer.h>
+
+#include <QTest>
+
+#include <memory>
+
+using namespace libopenrazer;
+
+class TestWriteCache : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void brightnessSurvivesReadBack_data();
+    void brightnessSurvivesReadBack();
+    void lowBatteryThresholdSurvivesReadBack();
+};
+
+void TestWriteCache::initTestCase()
+{
+    MOCKDAEMON_INIT_TEST_CASE();
+}
+
+void TestWriteCache::brightnessSurvivesReadBack_data()
+{
+    QTest::addColumn<uchar>("brightness");
+    // Values that truncating the percent used to turn into one lower
+    QTest::newRow("15") << uchar(15);
+    QTest::newRow("21") << uchar(21);
+    QTest::newRow("30") << uchar(30);
+    QTest::newRow("41") << uchar(41);
+    QTest::newRow("0") << uchar(0);
+    QTest::newRow("255") << uchar(255);
+}
+
+void TestWriteCache::brightnessSurvivesReadBack()
+{
+    QFETCH(uchar, brightness);
+
+    MockDaemon::Options options;
+    options.brightness = true;
+    std::unique_ptr<MockDaemon> daemon = MockDaemon::start(options);
+
+    openrazer::Device device(MockDaemon::devicePath());
+    device.setWriteCacheEnabled(true);
+    QList<Led *> leds = device.getLeds();
+    QCOMPARE(leds.size(), 1);
+    Led *led = leds[0];
+    QVERIFY(led->hasBrightness());
+
+    QVERIFY(led->trySetBrightness(brightness).isOk());
+    QCOMPARE(daemon->setterCalls(), 1);
+
+    // Reading agrees with what was set, so the cached value is kept
+    Result<uchar> read = led->tryGetBrightness();
+    QVERIFY(read.isOk());
+    QCOMPARE(read.value(), brightness);
+
+    quint64 elided = led->getElidedWrites();
+    QVERIFY(led->trySetBrightness(brightness).isOk());
+    QCOMPARE(led->getElidedWrites(), elided + 1);
+    QCOMPARE(daemon->setterCalls(), 1);
+}
+
+void TestWriteCache::lowBatteryThresholdSurvivesReadBack()
+{
+    MockDaemon::Options options;
+    options.battery = true;
+    std::unique_ptr<MockDaemon> daemon = MockDaemon::start(options);
+
+    openrazer::Device device(MockDaemon::devicePath());
+    device.setWriteCacheEnabled(true);
+    QVERIFY(device.hasFeature(Feature::LowBatteryThreshold));
+
+    // The daemon only keeps whole percents
+    QVERIFY(device.trySetLowBatteryThreshold(15.4).isOk());
+    QCOMPARE(daemon->setterCalls(), 1);
+
+    Result<double> read = device.tryGetLowBatteryThreshold();
+    QVERIFY(read.isOk());
+    QCOMPARE(read.value(), 15.0);
+
+    quint64 elided = device.getElidedWrites();
+    QVERIFY(device.trySetLowBatteryThreshold(15.0).isOk());
+    QCOMPARE(device.getElidedWrites(), elided + 1);
+    QCOMPARE(daemon->setterCalls(), 1);
+}
+
+QTEST_GUILESS_MAIN(TestWriteCache)
+#include "tst_writecache.moc"